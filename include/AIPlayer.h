@@ -40,12 +40,20 @@ class CAIPlayer{
         std::shared_ptr< CPlayerData > DPlayerData;
         int DCycle;
         int DDownSample;
-        const char* DLuaFile;
+        std::string DLuaFile;
         std::queue<SPlayerCommandRequest> DQueuedCommands;
         std::map<int,bool> DAssignedAssets;
 
         static EAssetType ResolveAssetTypeFromName(CAIPlayer* aiptr, const char* assetName);
         static EAssetCapabilityType ResolveAssetCapabilityFromName( const char* assetName);
+        static CAssetIDTable *AssetIDTable(lua_State *L);
+        static std::shared_ptr< CPlayerAsset > FindAsset(lua_State *L, int assetID);
+        static CPlayerAsset *FindAssetPtr(lua_State *L, int assetID);
+
+        using SAssetHandle = struct ASSETHANDLE_TAG{
+            CAssetIDTable *DAssetIDTable;
+            int DAssetID;
+        };
     public:        
         CAIPlayer(std::shared_ptr< CPlayerData > playerdata, int downsample, std::string luaFile);
         
@@ -84,6 +92,22 @@ class CAIPlayer{
         static int GetNearestEnemy(lua_State *L);
         static int GetAssetColor(lua_State *L);
         static int CanInitiate(lua_State *L);
+        static int GetWorldState(lua_State *L);
+        static int GetAssetHandle(lua_State *L);
+
+        //Lua Asset Handles
+        static void PushAssetHandle(lua_State *L, int assetID);
+        static CPlayerAsset *CheckAssetHandle(lua_State *L, int index);
+        static int AssetHandleID(lua_State *L);
+        static int AssetHandleType(lua_State *L);
+        static int AssetHandleColor(lua_State *L);
+        static int AssetHandlePos(lua_State *L);
+        static int AssetHandleGold(lua_State *L);
+        static int AssetHandleLumber(lua_State *L);
+        static int AssetHandleStone(lua_State *L);
+        static int AssetHandleHitPoints(lua_State *L);
+        static int AssetHandleAction(lua_State *L);
+        static int AssetHandleAlive(lua_State *L);
         
         //Lua Command Setters
         static int SetCommandAction(lua_State *L);
@@ -95,6 +119,7 @@ class CAIPlayer{
 
         //Lua Registration
         void RegisterFunctions(lua_State *L);
+        static void RegisterAssetHandle(lua_State *L);
         
         void CalculateCommand(SPlayerCommandRequest &command);
         void PushCommand(SPlayerCommandRequest &command);
@@ -22,6 +22,7 @@
 #include "FontTileset.h"
 #include "GameModel.h"
 #include "AIPlayer.h"
+#include "EventHandler.h"
 #include "ViewportRenderer.h"
 #include "MiniMapRenderer.h"
 #include "ResourceRenderer.h"
@@ -33,6 +34,7 @@
 #include "EditRenderer.h"
 #include "ListViewRenderer.h"
 #include "ApplicationMode.h"
+#include <chrono>
 
 typedef void (*TButtonCallbackFunction)(void *calldata);
 typedef bool (*TEditTextValidationCallbackFunction)(const std::string &text);
@@ -58,6 +60,17 @@ class CApplicationData : public std::enable_shared_from_this<CApplicationData>{
     friend class CBattleMode;
     friend class CPlayerData; 
     struct SPrivateApplicationType{};
+    public:
+        using SFrameStatistics = struct FRAMESTATISTICS_TAG{
+            int DRenderedFrames;
+            int DSkippedFrames;
+            int DSimulationSteps;
+            int DDroppedSteps;
+            double DAverageFrameTime;
+            double DAverageRenderTime;
+            double DMaxRenderTime;
+        };
+
     protected:
         typedef enum{
             ctPointer = 0,
@@ -117,7 +130,6 @@ class CApplicationData : public std::enable_shared_from_this<CApplicationData>{
         std::shared_ptr<CGraphicSurface> DWorkingBufferSurface;
         std::shared_ptr<CGraphicSurface> DMiniMapSurface;
         std::shared_ptr<CGraphicSurface> DViewportSurface;
-        std::shared_ptr<CGraphicSurface> DViewportTypeSurface;
         std::shared_ptr<CGraphicSurface> DUnitDescriptionSurface;
         std::shared_ptr<CGraphicSurface> DUnitActionSurface;
         std::shared_ptr<CGraphicSurface> DResourceSurface;
@@ -170,6 +182,7 @@ class CApplicationData : public std::enable_shared_from_this<CApplicationData>{
         std::shared_ptr< CGraphicRecolorMap > DButtonRecolorMap;
         std::shared_ptr< CGraphicRecolorMap > DFontRecolorMap;
         std::shared_ptr< CGraphicRecolorMap > DPlayerRecolorMap;
+        std::shared_ptr< CDataContainer > DTilesetCacheContainer;
         std::shared_ptr< CGraphicMulticolorTileset > DIconTileset;
         std::shared_ptr< CGraphicTileset > DMiniIconTileset;
         std::vector< std::shared_ptr< CGraphicMulticolorTileset > > DAssetTilesets;
@@ -192,6 +205,7 @@ class CApplicationData : public std::enable_shared_from_this<CApplicationData>{
         // Model
         EPlayerColor DPlayerColor;
         std::shared_ptr< CGameModel > DGameModel;
+        std::shared_ptr< CEventHandler > DEventHandler;
         std::array< SPlayerCommandRequest, to_underlying(EPlayerColor::Max) > DPlayerCommands;
         std::array< std::shared_ptr< CAIPlayer >, to_underlying(EPlayerColor::Max) > DAIPlayers;
         std::array< EPlayerType, to_underlying(EPlayerColor::Max) > DLoadingPlayerTypes;
@@ -219,6 +233,13 @@ class CApplicationData : public std::enable_shared_from_this<CApplicationData>{
         bool DRightDown;
         CButtonRenderer::EButtonState DMenuButtonState;
 
+        std::chrono::steady_clock::time_point DLastTimeoutTime;
+        std::chrono::steady_clock::time_point DLastFrameTime;
+        double DSimulationAccumulator;
+        double DRenderInterpolation;
+        int DConsecutiveSkippedFrames;
+        SFrameStatistics DFrameStatistics;
+
         static void ActivateCallback(TGUICalldata data);
         static bool TimeoutCallback(TGUICalldata data);
         static bool MainWindowDeleteEventCallback(std::shared_ptr<CGUIWidget> widget, TGUICalldata data);
@@ -235,6 +256,7 @@ class CApplicationData : public std::enable_shared_from_this<CApplicationData>{
         
         void Activate();
         bool Timeout();
+        void ResetFrameStatistics();
         bool MainWindowDeleteEvent(std::shared_ptr<CGUIWidget> widget);
         void MainWindowDestroy(std::shared_ptr<CGUIWidget> widget);
         bool MainWindowKeyPressEvent(std::shared_ptr<CGUIWidget> widget, SGUIKeyEvent &event);
@@ -275,6 +297,10 @@ class CApplicationData : public std::enable_shared_from_this<CApplicationData>{
         int GetTime() {
             return DTime;
         }
+
+        const SFrameStatistics &FrameStatistics() const{
+            return DFrameStatistics;
+        };
         
 	explicit CApplicationData(const std::string &appname, const SPrivateApplicationType &key);
         ~CApplicationData();
@@ -45,10 +45,13 @@ class CAssetDecoratedMap : public CTerrainMap{
         std::vector< std::vector< int > > DSearchMap;
         std::vector< std::vector< int > > DLumberAvailable;
         std::vector< std::vector< int > > DStoneAvailable;
+        int DTriggerHandlerIndex;
         
         static std::map< std::string, int > DMapNameTranslation;
         static std::vector< std::shared_ptr< CAssetDecoratedMap > > DAllMaps;
         
+        void InitializeAvailableResources();
+        
     public:        
         CAssetDecoratedMap();
         CAssetDecoratedMap(const CAssetDecoratedMap &map);
@@ -75,7 +78,12 @@ class CAssetDecoratedMap : public CTerrainMap{
         void RemoveLumber(const CTilePosition &pos, const CTilePosition &from, int amount);
         void RemoveStone(const CTilePosition &pos, const CTilePosition &from, int amount);
         
-        bool LoadMap(std::shared_ptr< CDataSource > source);
+        bool LoadMap(std::shared_ptr< CDataSource > source) override;
+        bool LoadMap(CMapBundleReader &reader) override;
+        void SaveMap(CMapBundleWriter &writer) const override;
+        int TriggerHandlerIndex() const{
+            return DTriggerHandlerIndex;
+        };
 
         const std::list< std::shared_ptr< CPlayerAsset > > &Assets() const;
         const std::list< SAssetInitialization > &AssetInitializationList() const;
@@ -0,0 +1,107 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#ifndef ASSETIDTABLE_H
+#define ASSETIDTABLE_H
+
+#include "PlayerAsset.h"
+#include <vector>
+#include <memory>
+
+/**
+* Dense table mapping asset IDs to assets for a single game. An asset ID is
+* the slot index in the low bits and the slot generation in the high bits,
+* so a stale ID of a removed asset never resolves to the asset that reuses
+* the slot.
+*/
+class CAssetIDTable{
+    protected:
+        static const int DSlotBits = 20;
+        static const int DSlotMask = (1 << DSlotBits) - 1;
+        static const int DGenerationMask = (1 << (31 - DSlotBits)) - 1;
+
+        struct SSlot{
+            std::shared_ptr< CPlayerAsset > DAsset;
+            int DGeneration;
+        };
+
+        std::vector< SSlot > DSlots;
+        std::vector< int > DFreeSlots;
+        int DCount;
+
+        int SlotIndex(int assetID) const{
+            if(0 > assetID){
+                return -1;
+            }
+            int Slot = assetID & DSlotMask;
+            if((Slot >= DSlots.size())||(DSlots[Slot].DGeneration != (assetID >> DSlotBits))){
+                return -1;
+            }
+            return Slot;
+        };
+
+    public:
+        CAssetIDTable(){
+            DCount = 0;
+        };
+
+        int Count() const{
+            return DCount;
+        };
+
+        int Insert(std::shared_ptr< CPlayerAsset > asset){
+            int Slot;
+
+            if(DFreeSlots.empty()){
+                Slot = DSlots.size();
+                DSlots.push_back(SSlot{nullptr, 0});
+            }
+            else{
+                Slot = DFreeSlots.back();
+                DFreeSlots.pop_back();
+            }
+            DSlots[Slot].DAsset = asset;
+            DCount++;
+            asset->AssetID((DSlots[Slot].DGeneration << DSlotBits) | Slot);
+            return asset->AssetID();
+        };
+
+        void Remove(int assetID){
+            int Slot = SlotIndex(assetID);
+
+            if((0 > Slot)||(!DSlots[Slot].DAsset)){
+                return;
+            }
+            DSlots[Slot].DAsset.reset();
+            DSlots[Slot].DGeneration = (DSlots[Slot].DGeneration + 1) & DGenerationMask;
+            DFreeSlots.push_back(Slot);
+            DCount--;
+        };
+
+        std::shared_ptr< CPlayerAsset > Find(int assetID) const{
+            int Slot = SlotIndex(assetID);
+
+            return 0 > Slot ? nullptr : DSlots[Slot].DAsset;
+        };
+
+        CPlayerAsset *FindPtr(int assetID) const{
+            int Slot = SlotIndex(assetID);
+
+            return 0 > Slot ? nullptr : DSlots[Slot].DAsset.get();
+        };
+};
+
+#endif
@@ -18,16 +18,54 @@
 #define ASSETLOADER_H
 #include "ApplicationData.h"
 #include "Debug.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 
+/**
+* Loads the asset tilesets on a pool of workers. PNG decoding and clipping
+* mask creation run on the workers, while storing the results in
+* ApplicationData (the hand off) and the splash screen progress stay on the
+* main thread, in the order the assets were queued.
+*/
 class CAssetLoader{
     protected:
+        using SLoadJob = struct LOADJOB_TAG{
+            std::string DName;
+            std::function< bool() > DDecode;
+            std::function< void() > DHandOff;
+            bool DDone;
+            bool DSuccess;
+        };
+
         std::shared_ptr< CApplicationData> AppData;
         std::shared_ptr< CDataContainer > TempDataContainer;
         std::shared_ptr< CDataContainer > ImageDirectory;
         std::shared_ptr< CDataContainerIterator > FileIterator;
         std::shared_ptr< CDataSource > TempDataSource;
+        std::deque< SLoadJob > DJobs;
+        std::vector< std::thread > DWorkers;
+        std::mutex DJobMutex;
+        std::condition_variable DJobQueued;
+        std::condition_variable DJobDecoded;
+        int DNextDecode;
+        int DNextHandOff;
+        bool DStopWorkers;
+
+        void QueueJob(const std::string &name, std::function< bool() > decode, std::function< void() > handoff);
+        void QueueTileset(const std::string &name, const std::string &filename, bool clippingmasks, std::function< void(std::shared_ptr< CGraphicTileset >) > handoff);
+        void QueueMulticolorTileset(const std::string &name, const std::string &filename, bool clippingmasks, std::function< void(std::shared_ptr< CGraphicMulticolorTileset >) > handoff);
+        void QueueAssetTileset(const std::string &name, const std::string &filename, EAssetType type);
+        void DecodeJobs();
+        void HandOffJobs(bool wait);
+        void StopWorkers();
+
     public:
         CAssetLoader(std::shared_ptr< CApplicationData> PassedAppData, std::shared_ptr< CDataContainer >, std::shared_ptr< CDataContainer >);
+        ~CAssetLoader();
+        void Finish();
         void LoadIconAsset();
         void LoadMiniIcons();
         void LoadCorpse();
@@ -45,6 +83,7 @@ class CAssetLoader{
         void LoadKeep();
         void LoadCastle();
         void LoadFarm();
+        void LoadWall();
         void LoadBarracks();
         void LoadBlacksmith();
         void LoadLumberMill();
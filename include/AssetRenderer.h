@@ -21,11 +21,23 @@
 #include "Rectangle.h"
 #include "Position.h"
 #include "GameModel.h"
+#include "PixelType.h"
 #include <vector>
 #include <list>
+#include <algorithm>
 
 class CAssetRenderer{
     protected:
+        using SAssetRenderData = struct ASSETRENDERERDATA_TAG{
+            EAssetType DType;
+            int DX;
+            int DY;
+            int DBottomY;
+            int DTileIndex;
+            int DColorIndex;
+            uint32_t DPixelColor;
+        };
+        
         std::shared_ptr< CPlayerData > DPlayerData;
         std::shared_ptr< CAssetDecoratedMap > DPlayerMap;
         std::vector< std::shared_ptr< CGraphicMulticolorTileset > > DTilesets;
@@ -51,14 +63,38 @@ class CAssetRenderer{
         std::vector< std::vector< int > > DPlaceIndices;
         
         std::vector< uint32_t > DPixelColors;
+        std::vector< SAssetRenderData > DRenderQueue;
+        std::vector< SAssetRenderData > DRenderScratch;
+        std::vector< uint8_t * > DAtlasPixels;
+        std::vector< int > DAtlasStrides;
+        std::vector< std::shared_ptr< CGraphicSurface > > DLockedAtlases;
+        SRectangle DRenderRect;
+        double DInterpolation;
         static int DAnimationDownsample;
         
+        static uint32_t RenderKey(const SAssetRenderData &renderdata){
+            return (static_cast<uint32_t>(renderdata.DBottomY + 0x8000) << 8) | to_underlying(renderdata.DType);
+        };
+        CPixelPosition DrawnPosition(std::shared_ptr< CPlayerAsset > asset) const;
+        void SortRenderQueue();
+        bool BlitAsset(uint8_t *pixels, int stride, int width, int height, const SAssetRenderData &renderdata);
+        static void FillMiniAsset(uint8_t *pixels, int stride, int width, int height, int xpos, int ypos, int size, uint32_t rgb);
+        
     public:
         CAssetRenderer(std::shared_ptr< CGraphicRecolorMap > colors, std::vector< std::shared_ptr< CGraphicMulticolorTileset > > tilesets, std::shared_ptr< CGraphicTileset > markertileset, std::shared_ptr< CGraphicTileset > corpsetileset, std::vector< std::shared_ptr< CGraphicTileset > > firetileset, std::shared_ptr< CGraphicTileset > buildingdeath, std::shared_ptr< CGraphicTileset > arrowtileset, std::shared_ptr< CPlayerData > player, std::shared_ptr< CAssetDecoratedMap > map);
         
         static int UpdateFrequency(int freq);
         
-        void DrawAssets(std::shared_ptr<CGraphicSurface> surface, std::shared_ptr<CGraphicSurface> typesurface, const SRectangle &rect);
+        double Interpolation() const{
+            return DInterpolation;
+        };
+        
+        double Interpolation(double interpolation){
+            return DInterpolation = std::max(0.0, std::min(1.0, interpolation));
+        };
+        
+        void DrawAssets(std::shared_ptr<CGraphicSurface> surface, const SRectangle &rect);
+        bool PixelType(int xpos, int ypos, CPixelType &pixeltype) const;
         void DrawSelections(std::shared_ptr<CGraphicSurface> surface, const SRectangle &rect, const std::list< std::weak_ptr< CPlayerAsset > > &selectionlist, const SRectangle &selectrect, bool highlightbuilding);
         void DrawOverlays(std::shared_ptr<CGraphicSurface> surface, const SRectangle &rect);
         void DrawPlacement(std::shared_ptr<CGraphicSurface> surface, const SRectangle &rect, const CPixelPosition &pos, EAssetType type, std::shared_ptr< CPlayerAsset > builder);
@@ -24,6 +24,19 @@
 class CDataSource{
     public:
         virtual int Read(void *data, int length) = 0;
+        // Buffered sources return the bytes available without consuming
+        // them (0 at the end), unbuffered sources return -1
+        virtual int Peek(const void *&data){
+            return -1;
+        };
+        // Consumes bytes previously returned by Peek
+        virtual void Skip(int length){
+        };
+        // Sources holding all of their content in memory return the unread
+        // content without copying, valid for the lifetime of the source
+        virtual const void *View(int &length){
+            return nullptr;
+        };
         virtual std::shared_ptr< CDataContainer > Container(){
             return nullptr;
         };
@@ -12,16 +12,25 @@ extern "C" {
 
 class CEventHandler : public std::enable_shared_from_this< CEventHandler >{
     protected:
-        static std::shared_ptr< CGameModel > DGameModel;
-        static std::string DEventScript;
+        std::shared_ptr< CGameModel > DGameModel;
+        std::string DEventScript;
+        std::function< void(bool) > DEndGameCall;
+        EPlayerColor DEndGameColor;
+
+        static CEventHandler *Instance(lua_State *L);
 
     public:
-        static void SetGameModelReference (std::shared_ptr< CGameModel > ptr);
-        static void RegisterAction ();
-        static void SetEventScript (std::string scriptName);
-        static void DoEvent (int offenderID, std::string event, std::vector< std::string > params, EPlayerColor color);
+        CEventHandler(std::shared_ptr< CGameModel > ptr);
+
+        void RegisterAction ();
+        void SetEventScript (std::string scriptName);
+        void SetEndGameCall (std::function< void(bool) > endgamecall);
+        EPlayerColor EndGameColor() const{
+            return DEndGameColor;
+        };
+        void DoEvent (int offenderID, std::string event, std::vector< std::string > params, EPlayerColor color);
 
-        static void RegisterFunctions(lua_State *L);
+        void RegisterFunctions(lua_State *L);
         static int EndGame(lua_State *L);
         static int ChangeResources(lua_State *L);
         static int ModifyAssetHealth(lua_State *L);
@@ -41,9 +41,10 @@ class CDirectoryDataContainerIterator : public CDataContainerIterator{
 class CDirectoryDataContainer : public CDataContainer{
     protected:
         std::string DFullPath;
+        bool DMapFiles;
         
     public:
-        CDirectoryDataContainer(const std::string &path);
+        CDirectoryDataContainer(const std::string &path, bool mapfiles = false);
         ~CDirectoryDataContainer();
         
         std::shared_ptr< CDataContainerIterator > First() override;
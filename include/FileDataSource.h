@@ -18,18 +18,33 @@
 #define FILEDATASOURCE_H
 
 #include "DataSource.h"
+#include <vector>
 
 class CFileDataSource : public CDataSource{
     protected:
         int DFileHandle;
         std::string DFullPath;
         bool DCloseFile = false;
-        
+        std::vector< char > DBuffer;
+        int DBufferOffset;
+        int DBufferLength;
+        const char *DMappedData;
+        int DMappedLength;
+        int DMappedOffset;
+
+        bool FillBuffer();
+
     public:
-        CFileDataSource(const std::string &filename, int fd = -1);
+        CFileDataSource(const std::string &filename, int fd = -1, bool mapfile = false);
         ~CFileDataSource();
         
+        const std::string &FullPath() const{
+            return DFullPath;
+        };
         int Read(void *data, int length);
+        int Peek(const void *&data);
+        void Skip(int length);
+        const void *View(int &length);
         std::shared_ptr< CDataContainer > Container();
 };
 
@@ -30,6 +30,19 @@ class CFogRenderer{
         int DPartialIndex;
         std::vector< int > DFogIndices;
         std::vector< int > DBlackIndices;
+        std::vector< CTilePosition > DChangedTiles;
+        std::vector< uint32_t > DTilePixels;
+        std::vector< uint8_t > DFogMasks;
+        std::vector< uint8_t > DBlackMasks;
+        std::vector< uint8_t > DMiniMapAlphas;
+        int DMapWidth;
+        int DMapHeight;
+        
+        uint8_t MiniMapAlpha(int xindex, int yindex) const;
+        void TileMasks(int xindex, int yindex, uint8_t &fogmask, uint8_t &blackmask) const;
+        void UpdateTile(int xindex, int yindex);
+        void UpdateTiles();
+        void BlendTile(uint8_t *pixels, int stride, const SRectangle &clip, int xpos, int ypos, int tileindex);
         
     public:
         CFogRenderer(std::shared_ptr< CGraphicTileset > tileset, std::shared_ptr< CVisibilityMap > map);
@@ -23,13 +23,8 @@
 #include "FileDataSource.h"
 #include "Rectangle.h"
 #include "TriggerHandler.h"
-
-extern int GAssetIDCount;
-extern std::map< int, std::shared_ptr< CPlayerAsset > > GAssetIDMap;
-extern std::shared_ptr< CPlayerAsset > FindAssetObj(int AssetID);
-extern void MapNewAssetObj(std::shared_ptr< CPlayerAsset > CreatedAsset);
-
-extern int GetAssetIDCount();
+#include "AssetIDTable.h"
+#include "PlayerCommand.h"
 
 enum class EEventType{
     None = 0,
@@ -63,15 +58,21 @@ class CPlayerData{
         EPlayerColor DColor;
         std::shared_ptr< CVisibilityMap > DVisibilityMap;
         std::shared_ptr< CTriggerHandler > DTriggerHandler;
+        std::shared_ptr< CAssetIDTable > DAssetIDTable;
         std::shared_ptr< CAssetDecoratedMap > DActualMap;
         std::shared_ptr< CAssetDecoratedMap > DPlayerMap;
         std::shared_ptr< std::unordered_map< std::string, std::shared_ptr< CPlayerAssetType > > > DAssetTypes;
         std::list< std::weak_ptr< CPlayerAsset > > DAssets;
         std::vector< bool > DUpgrades;
         std::vector< SGameEvent > DGameEvents;
+        std::shared_ptr< const std::vector< SGameEvent > > DSharedGameEvents;
+        std::vector< int > DSharedGameEventIndices;
         int DGold;
         int DLumber;
         int DStone;
+        int DGoldGathered;
+        int DLumberGathered;
+        int DStoneGathered;
         int DGameCycle;
         
         int* DAssetsCreated;
@@ -79,7 +80,7 @@ class CPlayerData{
         int* DAssetsDestroyed;
 	
     public:
-        CPlayerData(std::shared_ptr< CAssetDecoratedMap > map, std::shared_ptr< CTriggerHandler > handler, EPlayerColor color);
+        CPlayerData(std::shared_ptr< CAssetDecoratedMap > map, std::shared_ptr< CTriggerHandler > handler, std::shared_ptr< CAssetIDTable > idtable, EPlayerColor color);
 
         int GameCycle() const{
             return DGameCycle;
@@ -113,24 +114,47 @@ class CPlayerData{
         int Stone() const{
             return DStone;
         };
+        int GoldGathered() const{
+            return DGoldGathered;
+        };
+        int LumberGathered() const{
+            return DLumberGathered;
+        };
+        int StoneGathered() const{
+            return DStoneGathered;
+        };
+        void GatherResources(int gold, int lumber, int stone){
+            DGoldGathered += gold;
+            DLumberGathered += lumber;
+            DStoneGathered += stone;
+        };
+        const int *AssetsCreated() const{
+            return DAssetsCreated;
+        };
+        const int *AssetsLost() const{
+            return DAssetsLost;
+        };
+        const int *AssetsDestroyed() const{
+            return DAssetsDestroyed;
+        };
         int IncrementGold(int gold){
             DGold += gold;
-            DTriggerHandler->Resolve(ETriggerType::Resource, DIsAI, DColor, -1, 2, new int[2]{(int)EResourceType::Gold, DGold});
+            DTriggerHandler->Resolve(ETriggerType::Resource, DIsAI, DColor, -1, STriggerArgs::Resource(EResourceType::Gold, DGold));
             return DGold;
         };
         int DecrementGold(int gold){
             DGold -= gold;
-            DTriggerHandler->Resolve(ETriggerType::Resource, DIsAI, DColor, -1, 2, new int[2]{(int)EResourceType::Gold, DGold});
+            DTriggerHandler->Resolve(ETriggerType::Resource, DIsAI, DColor, -1, STriggerArgs::Resource(EResourceType::Gold, DGold));
             return DGold;
         };
         int IncrementLumber(int lumber){
             DLumber += lumber;
-            DTriggerHandler->Resolve(ETriggerType::Resource, DIsAI, DColor, -1, 2, new int[2]{(int)EResourceType::Lumber, DLumber});
+            DTriggerHandler->Resolve(ETriggerType::Resource, DIsAI, DColor, -1, STriggerArgs::Resource(EResourceType::Lumber, DLumber));
             return DLumber;
         };
         int DecrementLumber(int lumber){
             DLumber -= lumber;
-            DTriggerHandler->Resolve(ETriggerType::Resource, DIsAI, DColor, -1, 2, new int[2]{(int)EResourceType::Lumber, DLumber});
+            DTriggerHandler->Resolve(ETriggerType::Resource, DIsAI, DColor, -1, STriggerArgs::Resource(EResourceType::Lumber, DLumber));
             return DLumber;
         };
         int IncrementStone(int stone){
@@ -153,6 +177,12 @@ class CPlayerData{
         std::list< std::weak_ptr< CPlayerAsset > > Assets() const{
             return DAssets;
         };
+        std::shared_ptr< CAssetIDTable > AssetIDTable() const{
+            return DAssetIDTable;
+        };
+        std::shared_ptr< CPlayerAsset > FindAsset(int assetid) const{
+            return DAssetIDTable->Find(assetid);
+        };
         std::shared_ptr< std::unordered_map< std::string, std::shared_ptr< CPlayerAssetType > > > &AssetTypes(){
             return DAssetTypes;
         };
@@ -189,25 +219,39 @@ class CPlayerData{
             return DUpgrades[static_cast<decltype(DUpgrades.size())>(upgrade)];
         };
 
-        const std::vector< SGameEvent > &GameEvents() const{
-            return DGameEvents;
+        // Events of the player followed by the shared game events it can see
+        int GameEventCount() const{
+            return DGameEvents.size() + DSharedGameEventIndices.size();
+        };
+        const SGameEvent &GameEvent(int index) const{
+            if(index < DGameEvents.size()){
+                return DGameEvents[index];
+            }
+            return (*DSharedGameEvents)[DSharedGameEventIndices[index - DGameEvents.size()]];
         };
         void ClearGameEvents(){
             DGameEvents.clear();
+            DSharedGameEventIndices.clear();
         };
         void AddGameEvent(const SGameEvent &event){
             DGameEvents.push_back(event);
         };
-        void AppendGameEvents(const std::vector< SGameEvent > &events){
-            DGameEvents.insert(DGameEvents.end(), events.begin(), events.end());
+        void SharedGameEvents(std::shared_ptr< const std::vector< SGameEvent > > events){
+            DSharedGameEvents = events;
+            DSharedGameEventIndices.clear();
         };
+        bool CanSeeEvent(const SGameEvent &event) const;
+        void SelectGameEvents(int first);
 
 };
 
 class CGameModel{
     protected:
         CRandomNumberGenerator DRandomNumberGenerator;
+        CRandomNumberGenerator DTurnOrderGenerator;
         std::shared_ptr< CTriggerHandler > DTriggerHandler;        
+        std::shared_ptr< CAssetIDTable > DAssetIDTable;
+        std::shared_ptr< std::vector< SGameEvent > > DGameEvents;
         std::shared_ptr< CAssetDecoratedMap > DActualMap;
         std::vector< std::vector< std::shared_ptr< CPlayerAsset > > > DAssetOccupancyMap;
         std::vector< std::vector< bool > > DDiagonalOccupancyMap;
@@ -242,6 +286,10 @@ class CGameModel{
             return DActualMap;
         };
         std::shared_ptr< CPlayerData > Player(EPlayerColor color) const;
+        std::shared_ptr< CPlayerAsset > FindAsset(int assetid) const{
+            return DAssetIDTable->Find(assetid);
+        };
+        void ApplyPlayerCommand(EPlayerColor color, SPlayerCommandRequest &command);
         void Timestep();
         void ClearGameEvents();
 
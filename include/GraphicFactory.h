@@ -20,8 +20,29 @@
 #include "DataSource.h"
 #include "DataSink.h"
 
+/**
+* Creates, loads and stores surfaces of the selected backend. Cairo surfaces
+* are used by default, the software backend draws into plain pixel buffers
+* and leaves Cairo only the decoding, encoding and presentation of them.
+*/
 class CGraphicFactory{
     public:
+        enum class EBackend{
+            Cairo = 0,
+            Software
+        };
+
+    protected:
+        static EBackend DBackend;
+
+    public:
+        static EBackend Backend(){
+            return DBackend;
+        };
+        static void Backend(EBackend backend){
+            DBackend = backend;
+        };
+
         static std::shared_ptr<CGraphicSurface> CreateSurface(int width, int height, CGraphicSurface::ESurfaceFormat format);
         static std::shared_ptr<CGraphicSurface> LoadSurface(std::shared_ptr< CDataSource > source);
         static bool StoreSurface(std::shared_ptr< CDataSink > sink, std::shared_ptr<CGraphicSurface> surface);
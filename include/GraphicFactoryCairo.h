@@ -95,6 +95,8 @@ class CGraphicSurfaceCairo : public CGraphicSurface, public std::enable_shared_f
             }
         };
         
+        static cairo_surface_t *CairoSurface(std::shared_ptr<CGraphicSurface> surface);
+        
         int Width() const override{
             if(DSurface){
                 return cairo_image_surface_get_width(DSurface);   
@@ -122,6 +124,9 @@ class CGraphicSurfaceCairo : public CGraphicSurface, public std::enable_shared_f
         
         uint32_t PixelAt(int xpos, int ypos) override;
         
+        uint8_t *LockPixels(int &stride) override;
+        void UnlockPixels() override;
+        
         void Clear(int xpos = 0, int ypos = 0, int width = -1, int height = -1) override;
         std::shared_ptr<CGraphicSurface> Duplicate() override;
         
@@ -0,0 +1,153 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#ifndef GRAPHICFACTORYSOFTWARE_H
+#define GRAPHICFACTORYSOFTWARE_H
+#include "GraphicFactory.h"
+#include <vector>
+
+class CGraphicSurfaceSoftware;
+
+/**
+* Software rasterizer of the drawing operations the game uses. Rectangles
+* and axis aligned lines are covered analytically like Cairo does, scaled
+* surface sources are sampled nearest neighbor, and caps and joins are
+* always butt and miter.
+*/
+class CGraphicResourceContextSoftware : public CGraphicResourceContext{
+    protected:
+        using SState = struct STATE_TAG{
+            uint32_t DSourceColor;
+            std::shared_ptr<CGraphicSurface> DSourceSurface;
+            double DSourceX;
+            double DSourceY;
+            double DSourceScaleX;
+            double DSourceScaleY;
+            double DScaleX;
+            double DScaleY;
+            double DLineWidth;
+            int DClipLeft;
+            int DClipTop;
+            int DClipRight;
+            int DClipBottom;
+        };
+
+        // Path elements in device coordinates
+        using SPathRectangle = struct PATHRECTANGLE_TAG{
+            double DLeft;
+            double DTop;
+            double DRight;
+            double DBottom;
+        };
+
+        using SPathLine = struct PATHLINE_TAG{
+            double DX1;
+            double DY1;
+            double DX2;
+            double DY2;
+        };
+
+        std::shared_ptr<CGraphicSurfaceSoftware> DTarget;
+        SState DState;
+        std::vector< SState > DSavedStates;
+        std::vector< SPathRectangle > DPathRectangles;
+        std::vector< SPathLine > DPathLines;
+        double DPathX;
+        double DPathY;
+        std::vector< uint32_t > DSpanPixels;
+        std::vector< uint8_t > DCoverage;
+
+        void PaintSpan(int xpos, int ypos, int width, const uint8_t *coverage, uint8_t alpha, bool source);
+        void PaintCoverage(int xpos, int ypos, int width, const uint8_t *coverage, bool source);
+        void PaintRegion(const SPathRectangle &outer, const SPathRectangle &inner, bool source);
+        void StrokeLine(const SPathLine &line);
+
+    public:
+        CGraphicResourceContextSoftware(std::shared_ptr<CGraphicSurfaceSoftware> target);
+
+        void SetSourceRGB(uint32_t rgb) override;
+        void SetSourceRGB(double r, double g, double b) override;
+        void SetSourceRGBA(uint32_t rgba) override;
+        void SetSourceRGBA(double r, double g, double b, double a) override;
+        void SetSourceSurface(std::shared_ptr<CGraphicSurface> srcsurface, int xpos, int ypos) override;
+        void SetLineWidth(double width) override;
+        void SetLineCap(ELineCap cap) override;
+        void SetLineJoin(ELineJoin join) override;
+        void Scale(double sx, double sy) override;
+        void Paint() override;
+        void PaintWithAlpha(double alpha) override;
+        void Fill() override;
+        void Stroke() override;
+        void Rectangle(int xpos, int ypos, int width, int height) override;
+        void MoveTo(int xpos, int ypos) override;
+        void LineTo(int xpos, int ypos) override;
+        void Clip() override;
+        void MaskSurface(std::shared_ptr<CGraphicSurface> srcsurface, int xpos, int ypos) override;
+
+        std::shared_ptr<CGraphicSurface> GetTarget() override;
+        void Save() override;
+        void Restore() override;
+        void DrawSurface(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, int width, int height, int sxpos, int sypos) override;
+        void CopySurface(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, int width, int height, int sxpos, int sypos) override;
+};
+
+/**
+* Surface over a plain pixel buffer laid out like a Cairo image surface
+* (premultiplied ARGB32, RGB24, A8 and A1 with rows aligned to 32 bits), so
+* it can be handed to Cairo for presentation without a copy. Sources of the
+* blits may be surfaces of any backend as they are read through LockPixels.
+*/
+class CGraphicSurfaceSoftware : public CGraphicSurface, public std::enable_shared_from_this<CGraphicSurface>{
+    protected:
+        std::vector< uint32_t > DPixels;
+        int DWidth;
+        int DHeight;
+        int DStride;
+        ESurfaceFormat DFormat;
+
+    public:
+        CGraphicSurfaceSoftware(int width, int height, ESurfaceFormat format);
+
+        static int FormatStride(int width, ESurfaceFormat format);
+
+        int Width() const override{
+            return DWidth;
+        };
+        int Height() const override{
+            return DHeight;
+        };
+
+        ESurfaceFormat Format() const override{
+            return DFormat;
+        };
+
+        uint32_t PixelAt(int xpos, int ypos) override;
+
+        uint8_t *LockPixels(int &stride) override;
+        void UnlockPixels() override;
+
+        void Clear(int xpos = 0, int ypos = 0, int width = -1, int height = -1) override;
+        std::shared_ptr<CGraphicSurface> Duplicate() override;
+
+        std::shared_ptr<CGraphicResourceContext> CreateResourceContext() override;
+
+        void Draw(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, int width, int height, int sxpos, int sypos) override;
+        void Copy(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, int width, int height, int sxpos, int sypos) override;
+        void CopyMaskSurface(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, std::shared_ptr<CGraphicSurface> masksurface, int sxpos, int sypos) override;
+        void Transform(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, int width, int height, int sxpos, int sypos, void *calldata, TGraphicSurfaceTransformCallback callback) override;
+};
+
+#endif
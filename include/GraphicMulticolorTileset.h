@@ -21,11 +21,22 @@
 #include "DataSource.h"
 #include "GraphicTileset.h"
 #include "GraphicRecolorMap.h" 
+#include "Rectangle.h"
 
 class CGraphicMulticolorTileset : public CGraphicTileset{
     protected:
         std::vector< std::shared_ptr< CGraphicSurface > > DColoredTilesets;
         std::shared_ptr< CGraphicRecolorMap > DColorMap;
+        std::vector< SRectangle > DTileBounds;
+        std::shared_ptr< CDataContainer > DCacheContainer;
+        std::string DCacheName;
+        uint32_t DSourceChecksum;
+        bool DSourceChecksumValid;
+        
+        void UpdateTileBounds();
+        uint32_t CacheKey(int colorindex);
+        std::shared_ptr< CGraphicSurface > LoadCachedColor(int colorindex);
+        void StoreCachedColor(int colorindex);
         
     public:
         CGraphicMulticolorTileset();
@@ -39,8 +50,18 @@ class CGraphicMulticolorTileset : public CGraphicTileset{
             return DColorMap->FindColor(colorname);
         };
         
+        void SetCache(std::shared_ptr< CDataContainer > container, const std::string &name){
+            DCacheContainer = container;
+            DCacheName = name;
+        };
+        
         virtual bool LoadTileset(std::shared_ptr< CGraphicRecolorMap > colormap, std::shared_ptr< CDataSource > source); 
         
+        std::shared_ptr< CGraphicSurface > ColoredTileset(int colorindex);
+        const SRectangle &TileBounds(int tileindex) const{
+            return DTileBounds[tileindex];
+        };
+        
         void DrawTile(std::shared_ptr<CGraphicSurface> surface, int xpos, int ypos, int tileindex, int colorindex);
 };
 
@@ -28,8 +28,7 @@ class CGraphicRecolorMap{
         std::vector< std::string > DColorNames;
         std::vector< std::vector< uint32_t > > DColors;
         std::vector< std::vector< uint32_t > > DOriginalColors;
-        
-        static uint32_t RecolorPixels(void *data, uint32_t pixel);
+
         static uint32_t ObservePixels(void *data, uint32_t pixel);
         
     public:
@@ -52,7 +51,10 @@ class CGraphicRecolorMap{
         
         bool Load(std::shared_ptr< CDataSource > source);
         
-        std::shared_ptr<CGraphicSurface> RecolorSurface(int index, std::shared_ptr<CGraphicSurface> srcsurface);
+        // Recolors a row of ARGB32 pixels to color group index, safe to call
+        // on several threads at once
+        void RecolorPixels(int index, const uint32_t *src, uint32_t *dest, int count) const;
+        std::shared_ptr<CGraphicSurface> RecolorSurface(int index, std::shared_ptr<CGraphicSurface> srcsurface) const;
 };
 
 #endif
@@ -35,6 +35,9 @@ class CGraphicSurface{
         
         virtual uint32_t PixelAt(int xpos, int ypos) = 0;
         
+        virtual uint8_t *LockPixels(int &stride) = 0;
+        virtual void UnlockPixels() = 0;
+        
         virtual void Clear(int xpos = 0, int ypos = 0, int width = -1, int height = -1) = 0;
         virtual std::shared_ptr<CGraphicSurface> Duplicate() = 0;
         
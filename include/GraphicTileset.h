@@ -78,6 +78,8 @@ class CGraphicTileset{
         void DrawTile(std::shared_ptr<CGraphicSurface> surface, int xpos, int ypos, int tileindex);
         
         void DrawClipped(std::shared_ptr<CGraphicSurface> surface, int xpos, int ypos, int tileindex, uint32_t rgb);
+        bool ClippedPixel(int tileindex, int xpos, int ypos) const;
+        bool TilePixels(int tileindex, uint32_t *pixels) const;
 };
 
 #endif
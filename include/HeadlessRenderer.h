@@ -0,0 +1,79 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#ifndef HEADLESSRENDERER_H
+#define HEADLESSRENDERER_H
+#include "MiniMapRenderer.h"
+#include "DataContainer.h"
+
+class CGameModel;
+
+/**
+* The battle renderers (map, assets, fog, viewport and minimap) without any
+* of the GUI. Loads the tilesets they need from the image directory, and
+* draws the view of one player of a game model into offscreen surfaces.
+*/
+class CHeadlessRenderer{
+    protected:
+        std::shared_ptr< CGraphicRecolorMap > DPlayerRecolorMap;
+        std::shared_ptr< CGraphicRecolorMap > DAssetRecolorMap;
+        std::shared_ptr< CGraphicTileset > DTerrainTileset;
+        std::shared_ptr< CGraphicTileset > DFogTileset;
+        std::shared_ptr< CGraphicTileset > DMarkerTileset;
+        std::shared_ptr< CGraphicTileset > DCorpseTileset;
+        std::shared_ptr< CGraphicTileset > DBuildingDeathTileset;
+        std::shared_ptr< CGraphicTileset > DArrowTileset;
+        std::vector< std::shared_ptr< CGraphicTileset > > DFireTilesets;
+        std::vector< std::shared_ptr< CGraphicMulticolorTileset > > DAssetTilesets;
+        std::vector< char > DMapRendererConfigurationData;
+
+        std::shared_ptr< CMapRenderer > DMapRenderer;
+        std::shared_ptr< CAssetRenderer > DAssetRenderer;
+        std::shared_ptr< CFogRenderer > DFogRenderer;
+        std::shared_ptr< CViewportRenderer > DViewportRenderer;
+        std::shared_ptr< CMiniMapRenderer > DMiniMapRenderer;
+
+        std::shared_ptr< CGraphicTileset > LoadTileset(std::shared_ptr< CDataContainer > imagedirectory, const std::string &filename, bool clippingmasks);
+
+    public:
+        bool LoadTilesets(std::shared_ptr< CDataContainer > imagedirectory);
+
+        void CreateRenderers(std::shared_ptr< CGameModel > gamemodel, EPlayerColor color, int viewportwidth, int viewportheight);
+
+        int DetailedMapWidth() const;
+        int DetailedMapHeight() const;
+
+        std::shared_ptr< CMapRenderer > MapRenderer() const{
+            return DMapRenderer;
+        };
+        std::shared_ptr< CAssetRenderer > AssetRenderer() const{
+            return DAssetRenderer;
+        };
+        std::shared_ptr< CFogRenderer > FogRenderer() const{
+            return DFogRenderer;
+        };
+        std::shared_ptr< CViewportRenderer > ViewportRenderer() const{
+            return DViewportRenderer;
+        };
+        std::shared_ptr< CMiniMapRenderer > MiniMapRenderer() const{
+            return DMiniMapRenderer;
+        };
+
+        void DrawViewport(std::shared_ptr< CGraphicSurface > surface);
+        void DrawMiniMap(std::shared_ptr< CGraphicSurface > surface);
+};
+
+#endif
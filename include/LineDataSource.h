@@ -22,6 +22,9 @@
 class CLineDataSource{
     protected:
         std::shared_ptr< CDataSource > DDataSource;
+
+        static void StripCarriageReturns(std::string &line);
+
     public:
         CLineDataSource(std::shared_ptr< CDataSource > source);
         
@@ -0,0 +1,116 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#ifndef MAPBUNDLE_H
+#define MAPBUNDLE_H
+
+#include "DataSource.h"
+#include "DataSink.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+* Compiled map bundles hold the terrain, partials, resources, assets and
+* triggers of a map in little endian binary, so loading them needs no line
+* reading, tokenizing or string to int conversion. A bundle is a header of
+* magic, version, payload length, FNV-1a checksum of the payload and
+* FNV-1a checksum of the .map it was compiled from, followed by the
+* payload. Bundles are made from .map files by mapcompiler.
+*/
+class CMapBundleWriter{
+    protected:
+        std::vector< uint8_t > DPayload;
+        uint32_t DSourceChecksum;
+
+    public:
+        CMapBundleWriter();
+
+        void SourceChecksum(uint32_t checksum){
+            DSourceChecksum = checksum;
+        };
+
+        void WriteInt(int32_t value);
+        void WriteString(const std::string &str);
+        void WriteBytes(const uint8_t *data, int length);
+
+        bool Save(std::shared_ptr< CDataSink > sink) const;
+};
+
+/**
+* Bounds checked reader over the payload of a bundle. Once a read runs past
+* the end the reader is invalid and all further reads fail.
+*/
+class CMapBundleReader{
+    protected:
+        const uint8_t *DData;
+        int DLength;
+        int DOffset;
+        bool DValid;
+
+    public:
+        CMapBundleReader(const uint8_t *data, int length);
+
+        bool Valid() const{
+            return DValid;
+        };
+        bool AtEnd() const{
+            return DOffset == DLength;
+        };
+
+        bool ReadInt(int &value);
+        bool ReadString(std::string &str);
+        const uint8_t *ReadBytes(int length);
+};
+
+/**
+* A loaded bundle, viewed in place when the source has a view (memory
+* mapped files) and read into memory otherwise. Its payload is only
+* available once validated.
+*/
+class CMapBundle{
+    protected:
+        std::shared_ptr< CDataSource > DSource;
+        std::vector< uint8_t > DBuffer;
+        const uint8_t *DPayload;
+        int DPayloadLength;
+        uint32_t DSourceChecksum;
+
+        bool Validate(const uint8_t *data, size_t length);
+
+    public:
+        static const std::string DExtension;
+        static const uint32_t DMagic;
+        static const uint32_t DVersion;
+
+        CMapBundle();
+        CMapBundle(const CMapBundle &) = delete;
+
+        CMapBundle &operator=(const CMapBundle &) = delete;
+
+        static uint32_t Checksum(const uint8_t *data, size_t length);
+        static uint32_t Checksum(std::shared_ptr< CDataSource > source);
+
+        bool Load(std::shared_ptr< CDataSource > source);
+        uint32_t SourceChecksum() const{
+            return DSourceChecksum;
+        };
+        CMapBundleReader Reader() const{
+            return CMapBundleReader(DPayload, DPayloadLength);
+        };
+};
+
+#endif
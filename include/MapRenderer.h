@@ -17,6 +17,7 @@
 #ifndef MAPRENDERER_H
 #define MAPRENDERER_H
 #include "GraphicTileset.h"
+#include "PixelType.h"
 #include "TerrainMap.h"
 #include "Rectangle.h"
 #include <vector>
@@ -28,8 +29,21 @@ class CMapRenderer{
         std::shared_ptr< CTerrainMap > DMap;
         std::vector< std::vector< std::vector< int > > > DTileIndices;
         std::vector< int > DPixelIndices;
+        std::vector< std::shared_ptr< CGraphicSurface > > DChunkSurfaces;
+        std::vector< CTilePosition > DChangedTiles;
+        std::vector< uint32_t > DMiniMapPixels;
+        int DChunkColumns;
+        int DChunkRows;
+        
+        int DisplayIndex(int xindex, int yindex) const;
+        void DrawTile(std::shared_ptr<CGraphicSurface> surface, int xindex, int yindex, int xpos, int ypos);
+        void RenderChunk(int chunkindex);
+        uint32_t MiniMapPixel(int xindex, int yindex) const;
+        void UpdateTiles();
         
     public:
+        static const int DChunkTiles;
+        
         CMapRenderer(std::shared_ptr< CDataSource > config, std::shared_ptr< CGraphicTileset > tileset, std::shared_ptr< CTerrainMap > map);
         
         int MapWidth() const;
@@ -37,7 +51,8 @@ class CMapRenderer{
         int DetailedMapWidth() const;
         int DetailedMapHeight() const;
         
-        void DrawMap(std::shared_ptr<CGraphicSurface> surface, std::shared_ptr<CGraphicSurface> typesurface, const SRectangle &rect);
+        void DrawMap(std::shared_ptr<CGraphicSurface> surface, const SRectangle &rect);
+        CPixelType PixelType(int xpos, int ypos) const;
         void DrawMiniMap(std::shared_ptr<CGraphicSurface> surface);
 };
 
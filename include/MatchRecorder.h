@@ -0,0 +1,112 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#ifndef MATCHRECORDER_H
+#define MATCHRECORDER_H
+#include "HeadlessRenderer.h"
+#include "Tournament.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+/**
+* Plays a match headlessly like the tournament and records the view of one
+* player to an image sequence. Every interval cycles the viewport and the
+* minimap are drawn into offscreen surfaces and queued, a pool of encoder
+* threads writes the queued frames as PNG or raw pixels (tightly packed
+* 32 bit BGRA rows, the layout of the surfaces) so that rendering and not
+* the disk sets the pace. The memory of all frame surfaces together is
+* bounded, independent of the number of encoders, rendering waits for the
+* encoders only once it is used up.
+*/
+class CMatchRecorder{
+    public:
+        enum class EFrameFormat{
+            PNG = 0,
+            Raw
+        };
+
+    protected:
+        using SFrame = struct FRAME_TAG{
+            std::string DName;
+            std::shared_ptr< CGraphicSurface > DSurface;
+        };
+
+        CHeadlessRenderer DRenderer;
+        std::shared_ptr< CDataContainer > DOutputContainer;
+        std::shared_ptr< CGameModel > DGameModel;
+        EFrameFormat DFormat;
+        EPlayerColor DPlayerColor;
+        int DInterval;
+        int DViewportWidth;
+        int DViewportHeight;
+        int DMiniMapSize;
+        int DFrameWidth;
+        int DFrameHeight;
+        int DFrameCount;
+
+        std::deque< SFrame > DFrames;
+        std::vector< std::shared_ptr< CGraphicSurface > > DFreeSurfaces;
+        std::vector< std::thread > DEncoders;
+        std::mutex DFrameMutex;
+        std::condition_variable DFrameQueued;
+        std::condition_variable DFrameEncoded;
+        int DEncoderCount;
+        size_t DMaxFrameBytes;
+        size_t DAllocatedFrameBytes;
+        int DFramesWritten;
+        int DFramesFailed;
+        bool DStopEncoders;
+
+        std::shared_ptr< CGraphicSurface > AcquireSurface(int width, int height);
+        void QueueFrame(const std::string &name, std::shared_ptr< CGraphicSurface > surface);
+        bool EncodeFrame(const SFrame &frame);
+        void EncodeFrames();
+        void StartEncoders();
+        void StopEncoders();
+        void RecordCycle(std::shared_ptr< CGameModel > gamemodel, int cycle);
+
+    public:
+        CMatchRecorder(std::shared_ptr< CDataContainer > output, EFrameFormat format, int interval, int encodercount);
+        ~CMatchRecorder();
+
+        bool LoadTilesets(std::shared_ptr< CDataContainer > imagedirectory){
+            return DRenderer.LoadTilesets(imagedirectory);
+        };
+
+        void PlayerColor(EPlayerColor color){
+            DPlayerColor = color;
+        };
+        void ViewportSize(int width, int height){
+            DViewportWidth = width;
+            DViewportHeight = height;
+        };
+        void MiniMapSize(int size){
+            DMiniMapSize = size;
+        };
+
+        CTournament::SMatchResult Record(const CTournament::SMatchSettings &settings);
+
+        int FramesWritten() const{
+            return DFramesWritten;
+        };
+        int FramesFailed() const{
+            return DFramesFailed;
+        };
+};
+
+#endif
@@ -27,6 +27,9 @@ class CMemoryDataSource : public CDataSource{
     public:
         CMemoryDataSource(const std::vector< char > &src);
         int Read(void *data, int length);
+        int Peek(const void *&data);
+        void Skip(int length);
+        const void *View(int &length);
 };
 
 #endif
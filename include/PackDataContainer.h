@@ -0,0 +1,146 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#ifndef PACKDATACONTAINER_H
+#define PACKDATACONTAINER_H
+
+#include "DataContainer.h"
+#include "DataSource.h"
+#include "DataSink.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+* A pack file holds all files of a data directory in a single file. It is a
+* header of magic, version, entry count and index length, followed by the
+* index sorted by name and then the file contents. Each index entry is the
+* length prefixed path of the file relative to the data directory, and the
+* offset, length and FNV-1a checksum of its content. All integers are 32 bit
+* little endian. Packs are made from a data directory by packbuilder. The
+* checksums of all entries are verified once when the pack is loaded.
+*/
+class CPackFile{
+    public:
+        using SEntry = struct ENTRY_TAG{
+            std::string DName;
+            uint32_t DOffset;
+            uint32_t DLength;
+            uint32_t DChecksum;
+        };
+
+    protected:
+        std::shared_ptr< CDataSource > DSource;
+        std::vector< uint8_t > DBuffer;
+        const uint8_t *DData;
+        size_t DLength;
+        std::vector< SEntry > DEntries;
+        std::vector< bool > DValidEntries;
+
+    public:
+        static const std::string DExtension;
+        static const uint32_t DMagic;
+        static const uint32_t DVersion;
+
+        CPackFile();
+        CPackFile(const CPackFile &) = delete;
+
+        CPackFile &operator=(const CPackFile &) = delete;
+
+        bool Load(std::shared_ptr< CDataSource > source);
+
+        int EntryCount() const{
+            return DEntries.size();
+        };
+        const SEntry &Entry(int index) const{
+            return DEntries[index];
+        };
+        bool EntryValid(int index) const{
+            return DValidEntries[index];
+        };
+        int FindEntry(const std::string &name) const;
+        int FirstEntryWithPrefix(const std::string &prefix) const;
+        const uint8_t *EntryData(const SEntry &entry) const{
+            return DData + entry.DOffset;
+        };
+
+        static bool Build(std::shared_ptr< CDataContainer > container, std::shared_ptr< CDataSink > sink);
+};
+
+/**
+* Read only data source over a file of a pack
+*/
+class CPackDataSource : public CDataSource{
+    protected:
+        std::shared_ptr< CPackFile > DPack;
+        std::shared_ptr< CDataContainer > DFallbackRoot;
+        std::string DPath;
+        const uint8_t *DData;
+        int DLength;
+        int DOffset;
+
+    public:
+        CPackDataSource(std::shared_ptr< CPackFile > pack, const CPackFile::SEntry &entry, std::shared_ptr< CDataContainer > fallbackroot);
+
+        int Read(void *data, int length);
+        int Peek(const void *&data);
+        void Skip(int length);
+        const void *View(int &length);
+        std::shared_ptr< CDataContainer > Container();
+};
+
+class CPackDataContainerIterator : public CDataContainerIterator{
+    protected:
+        std::vector< std::pair< std::string, bool > > DEntries;
+        int DIndex;
+
+    public:
+        CPackDataContainerIterator(const std::vector< std::pair< std::string, bool > > &entries);
+        std::string Name();
+        bool IsContainer();
+        bool IsValid();
+        void Next();
+};
+
+/**
+* Container for a directory of a pack. Files missing from the pack or that
+* fail their checksum are read from the fallback directory instead, and
+* sinks are always created in the fallback directory. Packs older than
+* their data directory are not opened, so the fallback is never consulted
+* for files the pack holds.
+*/
+class CPackDataContainer : public CDataContainer{
+    protected:
+        std::shared_ptr< CPackFile > DPack;
+        std::shared_ptr< CDataContainer > DFallbackRoot;
+        std::string DPath;
+
+        std::string EntryName(const std::string &name) const;
+        std::shared_ptr< CDataContainer > Fallback();
+
+    public:
+        CPackDataContainer(std::shared_ptr< CPackFile > pack, const std::string &path, std::shared_ptr< CDataContainer > fallbackroot);
+
+        static std::shared_ptr< CDataContainer > OpenDataContainer(const std::string &datapath, bool mapfiles);
+
+        std::shared_ptr< CDataContainerIterator > First() override;
+        std::shared_ptr< CDataSource > DataSource(const std::string &name) override;
+        std::shared_ptr< CDataSink > DataSink(const std::string &name) override;
+        std::shared_ptr< CDataContainer > Container() override;
+        std::shared_ptr< CDataContainer > DataContainer(const std::string &name) override;
+};
+
+#endif
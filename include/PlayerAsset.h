@@ -360,12 +360,12 @@ class CPlayerAsset{
         // random number to assign each turn
         unsigned int DTurnOrder;
         CPixelPosition DPosition;
+        CPixelPosition DPreviousPosition;
         EDirection DDirection;
         std::vector< SAssetCommand > DCommands;
         std::shared_ptr< CPlayerAssetType > DType;
         static int DUpdateFrequency;
         static int DUpdateDivisor;
-        static CRandomNumberGenerator DGenerateRandomNum;
 
     public:
         CPlayerAsset(std::shared_ptr< CPlayerAssetType > type);
@@ -483,8 +483,8 @@ class CPlayerAsset{
             DStep++;
         };
 
-        void AssignTurnOrder(){
-            DTurnOrder = DGenerateRandomNum.Random();
+        void AssignTurnOrder(unsigned int turnorder){
+            DTurnOrder = turnorder;
         }
 
         unsigned int GetTurnOrder(){
@@ -511,6 +511,14 @@ class CPlayerAsset{
 
         CPixelPosition Position(const CPixelPosition &pos);
 
+        CPixelPosition PreviousPosition() const{
+            return DPreviousPosition;
+        };
+
+        void StorePreviousPosition(){
+            DPreviousPosition = DPosition;
+        };
+
         bool TileAligned() const{
             return DPosition.TileAligned();
         };
@@ -0,0 +1,66 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#ifndef RENDERBENCHMARK_H
+#define RENDERBENCHMARK_H
+#include "HeadlessRenderer.h"
+#include <string>
+#include <vector>
+
+/**
+* Measures the battle renderers without the GUI. Each map is loaded with
+* its starting assets and a fixed seed, and the view of the first player is
+* drawn for a number of frames at each resolution, timing the map, asset,
+* fog and minimap renderers separately. The first frame of each is compared
+* against a stored golden image, or stored as the new golden.
+*/
+class CRenderBenchmark{
+    public:
+        using SResult = struct RESULT_TAG{
+            std::string DMapName;
+            int DWidth;
+            int DHeight;
+            int DFrames;
+            double DMapTime;
+            double DAssetTime;
+            double DFogTime;
+            double DMiniMapTime;
+            int DViewportMismatches;
+            int DMiniMapMismatches;
+        };
+
+    protected:
+        CHeadlessRenderer DRenderer;
+        std::shared_ptr< CDataContainer > DGoldenContainer;
+        int DFrameCount;
+        int DMiniMapSize;
+        int DTolerance;
+        bool DUpdateGoldens;
+
+        static std::string GoldenName(const std::string &mapname, int width, int height, const std::string &suffix);
+        int CheckGolden(const std::string &name, std::shared_ptr< CGraphicSurface > surface);
+
+    public:
+        CRenderBenchmark(std::shared_ptr< CDataContainer > goldens, int framecount, int minimapsize, int tolerance, bool updategoldens);
+
+        bool LoadTilesets(std::shared_ptr< CDataContainer > imagedirectory){
+            return DRenderer.LoadTilesets(imagedirectory);
+        };
+
+        bool Run(const std::string &mapname, const std::vector< std::pair< int, int > > &resolutions, std::vector< SResult > &results);
+};
+
+#endif
@@ -32,11 +32,12 @@ class CRouterMap{
         std::vector< std::vector< int > > DMap;
         std::list< SSearchTarget > DSearchTargets;
         
-        static EDirection DIdealSearchDirection;
-        static int DMapWidth;
+        EDirection DIdealSearchDirection;
+        int DMapWidth;
         static bool MovingAway(EDirection dir1, EDirection dir2);
         
     public:        
+        CRouterMap() : DIdealSearchDirection(EDirection::North), DMapWidth(1){};
         
         EDirection FindRoute(const CAssetDecoratedMap &resmap, const CPlayerAsset &resource, const CPixelPosition &target);
 };
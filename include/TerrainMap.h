@@ -18,6 +18,7 @@
 #define TERRAINMAP_H
 #include "DataSource.h"
 #include "GameDataTypes.h"
+#include "MapBundle.h"
 #include "Position.h"
 #include <vector>
 
@@ -63,8 +64,13 @@ class CTerrainMap{
         std::vector< std::vector< int > > DMapIndices;
         std::string DMapName;
         bool DRendered;
+        std::vector< std::vector< bool > > DChangedFlags;
+        std::vector< CTilePosition > DChangedTiles;
+        bool DAllTilesChanged;
         
         void CalculateTileTypeAndIndex(int x, int y, ETileType &type, int &index);
+        void TileChanged(int xpos, int ypos);
+        void AllTilesChanged();
         
     public:        
         CTerrainMap();
@@ -153,7 +159,11 @@ class CTerrainMap{
         
         void RenderTerrain();
         
+        bool TakeChangedTiles(std::vector< CTilePosition > &tiles);
+        
         virtual bool LoadMap(std::shared_ptr< CDataSource > source);
+        virtual bool LoadMap(CMapBundleReader &reader);
+        virtual void SaveMap(CMapBundleWriter &writer) const;
 };
 
 #endif
@@ -0,0 +1,105 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include "GameDataTypes.h"
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class CGameModel;
+
+/**
+* Runs AI versus AI matches headlessly (no rendering, sound or GUI) on a
+* pool of threads. Each match owns its own game model, trigger handler and
+* event handler, so matches run independently of each other.
+*/
+class CTournament{
+    public:
+        using SMatchSettings = struct MATCHSETTINGS_TAG{
+            std::string DMapName;
+            uint64_t DSeed;
+            int DMaxCycles;
+            std::array< std::string, to_underlying(EPlayerColor::Max) > DBrains;
+        };
+
+        using SPlayerResult = struct PLAYERRESULT_TAG{
+            std::string DBrain;
+            bool DAlive;
+            int DGoldGathered;
+            int DLumberGathered;
+            int DStoneGathered;
+            int DAssetsCreated;
+            int DAssetsLost;
+            int DAssetsDestroyed;
+        };
+
+        using SMatchResult = struct MATCHRESULT_TAG{
+            SMatchSettings DSettings;
+            bool DValid;
+            int DCycles;
+            EPlayerColor DWinner;
+            EPlayerColor DLoser;
+            std::array< SPlayerResult, to_underlying(EPlayerColor::Max) > DPlayers;
+        };
+
+        using SBrainStatistics = struct BRAINSTATISTICS_TAG{
+            int DMatches;
+            int DWins;
+            int DLosses;
+            int DDraws;
+            int DGoldGathered;
+            int DLumberGathered;
+            int DStoneGathered;
+            int DAssetsCreated;
+            int DAssetsLost;
+            int DAssetsDestroyed;
+        };
+
+        // Called after every game cycle of a match with the cycle count
+        using TCycleCallback = std::function< void(std::shared_ptr< CGameModel >, int) >;
+
+    protected:
+        std::vector< SMatchSettings > DMatches;
+        std::vector< SMatchResult > DResults;
+        int DThreadCount;
+
+    public:
+        CTournament(int threadcount);
+
+        static bool LoadGameData(const std::string &datapath);
+
+        bool AddMatches(const std::vector< std::string > &maps, const std::vector< uint64_t > &seeds, const std::vector< std::string > &brains, int maxcycles);
+        int MatchCount() const{
+            return DMatches.size();
+        };
+
+        static SMatchResult RunMatch(const SMatchSettings &settings, TCycleCallback callback = nullptr);
+        void Run();
+
+        const std::vector< SMatchResult > &Results() const{
+            return DResults;
+        };
+        std::map< std::string, SBrainStatistics > BrainStatistics() const;
+};
+
+#endif
@@ -1,10 +1,14 @@
 #ifndef TRIGGER_HANDLER_H
 #define TRIGGER_HANDLER_H
 
+#include <array>
 #include <vector>
+#include <cstdint>
+#include <functional>
 #include "DataSource.h"
 #include "CommentSkipLineDataSource.h"
 #include "GameDataTypes.h"
+#include "MapBundle.h"
 
 extern "C" {
     #include "lua.h"
@@ -19,7 +23,8 @@ enum class ETriggerType{
     Time,
     AssetsCreated,
     AssetsLost,
-    AssetsDestroyed
+    AssetsDestroyed,
+    Max
 };
 
 enum class EResourceType{
@@ -30,6 +35,54 @@ enum class EResourceType{
     Max
 };
 
+enum class EComparison{
+    None = 0,
+    GreaterThan,
+    LessThan,
+    Equal
+};
+
+/**
+* Arguments a trigger is checked against, passed by reference so resolving a
+* trigger never allocates. Only the fields of the resolved trigger type are
+* set: Resource uses the resource type and amount, AssetLocation the asset
+* type and tile, Time the time and the asset counting types the counts.
+*/
+using STriggerArgs = struct TRIGGERARGS_TAG{
+    EResourceType DResourceType;
+    int DAmount;
+    EAssetType DAssetType;
+    int DTileX;
+    int DTileY;
+    int DTime;
+    // EAssetType::Max counts indexed by asset type
+    const int *DAssetCounts;
+
+    static TRIGGERARGS_TAG Resource(EResourceType resourcetype, int amount){
+        TRIGGERARGS_TAG Args = {};
+        Args.DResourceType = resourcetype;
+        Args.DAmount = amount;
+        return Args;
+    };
+    static TRIGGERARGS_TAG AssetLocation(EAssetType assettype, int tilex, int tiley){
+        TRIGGERARGS_TAG Args = {};
+        Args.DAssetType = assettype;
+        Args.DTileX = tilex;
+        Args.DTileY = tiley;
+        return Args;
+    };
+    static TRIGGERARGS_TAG Time(int milliseconds){
+        TRIGGERARGS_TAG Args = {};
+        Args.DTime = milliseconds;
+        return Args;
+    };
+    static TRIGGERARGS_TAG AssetCounts(const int *counts){
+        TRIGGERARGS_TAG Args = {};
+        Args.DAssetCounts = counts;
+        return Args;
+    };
+};
+
 class CTrigger : public std::enable_shared_from_this< CTrigger >{
     public:
         ETriggerType DType;
@@ -41,9 +94,17 @@ class CTrigger : public std::enable_shared_from_this< CTrigger >{
         std::vector< std::string > DEventParameters;
         int offenderID;
 
+        static uint32_t AssetTypeMask(const std::string &assetName);
+        static EComparison ComparisonFromName(const std::string &comparison);
+        static int CountAssets(uint32_t assettypemask, const int *counts);
+        static bool Compare(EComparison comparison, int count, int amount){
+            return ((EComparison::GreaterThan == comparison) && (count > amount)) || ((EComparison::LessThan == comparison) && (count < amount)) || ((EComparison::Equal == comparison) && (count == amount));
+        };
+
         explicit CTrigger() : DType(ETriggerType::Resource), DPlayerActivated(false), DAIActivated(false), DRepeatable(false), DActive(true) {};
         virtual void Construct(ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params);
-        virtual bool Check(int size, int* args) = 0;
+        virtual bool Check(const STriggerArgs &args) = 0;
+        virtual std::shared_ptr< CTrigger > Clone() const = 0;
 };
 
 class CTriggerResource : public CTrigger {
@@ -55,24 +116,26 @@ class CTriggerResource : public CTrigger {
     public:
         CTriggerResource() : CTrigger() {};
         void Construct(ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params);
-        bool Check(int size, int* args) override;
+        bool Check(const STriggerArgs &args) override;
+        std::shared_ptr< CTrigger > Clone() const override { return std::make_shared< CTriggerResource >(*this); }
 };
 
 class CTriggerAssetCount : public CTrigger {
     protected:
-        std::string DAssetTypeName;
-        std::string DComparison;
+        uint32_t DAssetTypeMask;
+        EComparison DComparison;
         int DAmount;
 
     public:
         CTriggerAssetCount() : CTrigger() {};
         void Construct(ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params);
-        bool Check(int size, int* args) override;
+        bool Check(const STriggerArgs &args) override;
+        std::shared_ptr< CTrigger > Clone() const override { return std::make_shared< CTriggerAssetCount >(*this); }
 };
 
 class CTriggerAssetLocation : public CTrigger {
     protected:
-        std::string DAssetTypeName;
+        uint32_t DAssetTypeMask;
         int DXMin;
         int DXMax;
         int DYMin;
@@ -81,7 +144,8 @@ class CTriggerAssetLocation : public CTrigger {
     public:
         CTriggerAssetLocation() : CTrigger() {};
         void Construct(ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params);
-        bool Check(int size, int* args) override;
+        bool Check(const STriggerArgs &args) override;
+        std::shared_ptr< CTrigger > Clone() const override { return std::make_shared< CTriggerAssetLocation >(*this); }
 };
 
 class CTriggerTime : public CTrigger {
@@ -94,46 +158,60 @@ class CTriggerTime : public CTrigger {
     public:
         CTriggerTime() : CTrigger() {};
         void Construct(ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params);
-        bool Check(int size, int* args) override;
+        bool Check(const STriggerArgs &args) override;
+        std::shared_ptr< CTrigger > Clone() const override { return std::make_shared< CTriggerTime >(*this); }
         void IncrementTime();
         void SetTime(float newTime) { DTime = newTime; }
+        float GetTime() const { return DTime; }
         float GetInitialTime() { return DInitialTime; }
+        bool GreaterThan() const { return DGreaterThan; }
 };
 
 class CTriggerAssetsCreated : public CTrigger {
     protected:
-        std::string DAssetTypeName;
-        std::string DComparison;
+        uint32_t DAssetTypeMask;
+        EComparison DComparison;
         int DAmount;
 
     public:
         CTriggerAssetsCreated() : CTrigger() {};
         void Construct(ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params);
-        bool Check(int size, int* args) override;
+        bool Check(const STriggerArgs &args) override;
+        std::shared_ptr< CTrigger > Clone() const override { return std::make_shared< CTriggerAssetsCreated >(*this); }
 };
 
 class CTriggerAssetsLost : public CTrigger {
     protected:
-        std::string DAssetTypeName;
-        std::string DComparison;
+        uint32_t DAssetTypeMask;
+        EComparison DComparison;
         int DAmount;
 
     public:
         CTriggerAssetsLost() : CTrigger() {};
         void Construct(ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params);
-        bool Check(int size, int* args) override;
+        bool Check(const STriggerArgs &args) override;
+        std::shared_ptr< CTrigger > Clone() const override { return std::make_shared< CTriggerAssetsLost >(*this); }
 };
 
 class CTriggerAssetsDestroyed : public CTrigger {
     protected:
-        std::string DAssetTypeName;
-        std::string DComparison;
+        uint32_t DAssetTypeMask;
+        EComparison DComparison;
         int DAmount;
 
     public:
         CTriggerAssetsDestroyed() : CTrigger() {};
         void Construct(ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params);
-        bool Check(int size, int* args) override;
+        bool Check(const STriggerArgs &args) override;
+        std::shared_ptr< CTrigger > Clone() const override { return std::make_shared< CTriggerAssetsDestroyed >(*this); }
+};
+
+// A trigger as written in a map, before being constructed
+using STriggerDefinition = struct TRIGGERDEFINITION_TAG{
+    ETriggerType DType;
+    int DTriggerablePlayers;
+    bool DRepeatable;
+    std::vector< std::string > DParameters;
 };
 
 class CTriggerHandler : public std::enable_shared_from_this< CTriggerHandler >{
@@ -141,22 +219,42 @@ class CTriggerHandler : public std::enable_shared_from_this< CTriggerHandler >{
         static std::vector< std::shared_ptr< CTriggerHandler > > DAllTriggerHandlers;
         std::vector< std::string > DAIDifficultyScripts;
         std::string DEventScript;
+        // Only kept by the handlers loaded from maps, so they can be compiled
+        std::vector< STriggerDefinition > DDefinitions;
         std::vector< std::shared_ptr< CTrigger > > DTriggers;
         std::vector< std::shared_ptr< CTriggerTime > > DTimeTriggers;
+        // Active > time triggers as a min-heap on their next fire time
+        std::vector< std::shared_ptr< CTriggerTime > > DTimeTriggerHeap;
+        // Active < time triggers, due from the start until their time passes
+        std::vector< std::shared_ptr< CTriggerTime > > DEarlyTimeTriggers;
+        std::vector< std::shared_ptr< CTriggerTime > > DDueTimeTriggers;
+        // Active triggers by type, [0] are activated by players and [1] by AI
+        std::array< std::array< std::vector< std::shared_ptr< CTrigger > >, 2 >, to_underlying(ETriggerType::Max) > DTriggerIndex;
+        int DResolveDepth;
+        bool DTriggerIndexDirty;
         int DHandlerIndex;
+        std::function< void(int, std::string, std::vector< std::string >, EPlayerColor color) > DEventCall;
 
-    public:
-        static std::function< void(int, std::string, std::vector< std::string >, EPlayerColor color) > DEventCall;
+        bool AddTrigger(const STriggerDefinition &definition);
+        void IndexTriggers();
+        void CompactTriggerIndex();
+        void ScheduleTimeTriggers();
+        void ResolveTime(EPlayerColor color, int offenderID, const STriggerArgs &args);
 
+    public:
         CTriggerHandler();
         CTriggerHandler(const CTriggerHandler &handler);
         ~CTriggerHandler();
 
-        void Resolve(ETriggerType triggerType, bool isAI, EPlayerColor color, int offenderID, int size, int* args);
+        void Resolve(ETriggerType triggerType, bool isAI, EPlayerColor color, int offenderID, const STriggerArgs &args);
         static bool LoadTriggers(std::shared_ptr< CDataSource > source);
+        static bool LoadTriggers(CMapBundleReader &reader);
+        static bool SaveTriggers(int index, CMapBundleWriter &writer);
+        static int HandlerCount(){ return DAllTriggerHandlers.size(); }
         static std::shared_ptr< CTriggerHandler > DuplicateHandler(int index);
         static bool AssetTypeMatchesName(std::string assetName, EAssetType assetType);
         std::string GetEventScript () { return DEventScript; }
+        void SetEventCall (std::function< void(int, std::string, std::vector< std::string >, EPlayerColor color) > eventcall) { DEventCall = eventcall; }
         void ActivateTriggers ();
 };
 
@@ -76,7 +76,9 @@ class CViewportRenderer{
         void PanSouth(int pan);
         void PanWest(int pan);
         
-        void DrawViewport(std::shared_ptr< CGraphicSurface > surface, std::shared_ptr< CGraphicSurface > typesurface, const std::list< std::weak_ptr< CPlayerAsset > > &selectionmarkerlist, const SRectangle &selectrect, EAssetCapabilityType curcapability);
+        CPixelType PixelType(const CPixelPosition &pos) const;
+        
+        void DrawViewport(std::shared_ptr< CGraphicSurface > surface, const std::list< std::weak_ptr< CPlayerAsset > > &selectionmarkerlist, const SRectangle &selectrect, EAssetCapabilityType curcapability);
 };
 
 #endif
@@ -33,6 +33,10 @@ class CVisibilityMap{
         
     protected:
         std::vector< std::vector< ETileVisibility > > DMap;
+        std::vector< std::vector< ETileVisibility > > DLastMap;
+        std::vector< std::vector< bool > > DChangedFlags;
+        std::vector< CTilePosition > DChangedTiles;
+        bool DAllTilesChanged;
         int DMaxVisibility;
         int DTotalMapTiles;
         int DUnseenTiles;
@@ -64,6 +68,8 @@ class CVisibilityMap{
         
         void Update(const std::list< std::weak_ptr< CPlayerAsset > > &resources);
         
+        bool TakeChangedTiles(std::vector< CTilePosition > &tiles);
+        
 };
 
 #endif
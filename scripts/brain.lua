@@ -11,35 +11,37 @@ end
 -- So if you call SearchMap and ActivateFighters consecutively, only one of the two functions will occur based on order.
 function CalculateCommand()
     ACTIONS_ASSIGNED = 0;
-    if GetFoundAssetCount(AIPointer, "GoldMine") == 0 then
+    AssignedAssets = {}
+    WorldState = GetWorldState(AIPointer)
+    if WorldState.FoundAssetCount["GoldMine"] == 0 then
         commandGot = SearchMap()
         if commandGot then PushBackCommand(AIPointer, CmdPointer) end
         return
-    elseif GetPlayerAssetCount(AIPointer, "TownHall") == 0 and GetPlayerAssetCount(AIPointer, "Keep") == 0 and GetPlayerAssetCount(AIPointer, "Castle") == 0 then
+    elseif PlayerAssetCount("TownHall") == 0 and PlayerAssetCount("Keep") == 0 and PlayerAssetCount("Castle") == 0 then
         commandGot = BuildTownHall()
         if commandGot then PushBackCommand(AIPointer, CmdPointer) end
         return
     else
-        if GetPlayerAssetCount(AIPointer, "Peasant") < 4 then
+        if PlayerAssetCount("Peasant") < 4 then
             commandGot = ActivatePeasants(true)
             if commandGot then PushBackCommand(AIPointer, CmdPointer) end
             return
         end
-        if GetPlayerAssetCount(AIPointer, "Barracks") < 3 and ACTIONS_ASSIGNED < 2 then
+        if PlayerAssetCount("Barracks") < 3 and ACTIONS_ASSIGNED < 2 then
             commandGot = BuildBuildings("Barracks")
             if commandGot then
                 PushBackCommand(AIPointer, CmdPointer)
                 ACTIONS_ASSIGNED = ACTIONS_ASSIGNED + 1
             end
         end
-        if GetPlayerAssetCount(AIPointer, "Blacksmith") == 0 and ACTIONS_ASSIGNED < 2 then
+        if PlayerAssetCount("Blacksmith") == 0 and ACTIONS_ASSIGNED < 2 then
             commandGot = BuildBuildings("Blacksmith")
             if commandGot then
                 PushBackCommand(AIPointer, CmdPointer)
                 ACTIONS_ASSIGNED = ACTIONS_ASSIGNED + 1
             end
         end
-        if GetPlayerAssetCount(AIPointer, "LumberMill") == 0 and ACTIONS_ASSIGNED < 2 then
+        if PlayerAssetCount("LumberMill") == 0 and ACTIONS_ASSIGNED < 2 then
             commandGot = BuildBuildings("LumberMill")
             if commandGot then
                 PushBackCommand(AIPointer, CmdPointer)
@@ -47,7 +49,7 @@ function CalculateCommand()
             end
         end
 
-        if GetPlayerAssetCount(AIPointer, "Farm") < 20 and ACTIONS_ASSIGNED < 2 then
+        if PlayerAssetCount("Farm") < 20 and ACTIONS_ASSIGNED < 2 then
             commandGot = BuildBuildings("Farm")
             if commandGot then
                 PushBackCommand(AIPointer, CmdPointer)
@@ -55,21 +57,21 @@ function CalculateCommand()
             end
         end
 
-        if GetPlayerAssetCount(AIPointer, "ScoutTower") < 4 and ACTIONS_ASSIGNED < 2 then
+        if PlayerAssetCount("ScoutTower") < 4 and ACTIONS_ASSIGNED < 2 then
             commandGot = BuildBuildings("ScoutTower")
             if commandGot then
                 PushBackCommand(AIPointer, CmdPointer)
                 ACTIONS_ASSIGNED = ACTIONS_ASSIGNED + 1
             end
         end
-        if GetPlayerAssetCount(AIPointer, "ScoutTower") == 4 and ACTIONS_ASSIGNED < 2 then
+        if PlayerAssetCount("ScoutTower") == 4 and ACTIONS_ASSIGNED < 2 then
             commandGot = BuildBuildings("OffensiveTower")
             if commandGot then
                 PushBackCommand(AIPointer, CmdPointer)
                 ACTIONS_ASSIGNED = ACTIONS_ASSIGNED + 1
             end
         end
-        if GetPlayerAssetCount(AIPointer, "Barracks") ==3 and ACTIONS_ASSIGNED < 2 then
+        if PlayerAssetCount("Barracks") ==3 and ACTIONS_ASSIGNED < 2 then
             commandGot = BuildBuildings("OffensiveBarrack")
             if commandGot then
                 PushBackCommand(AIPointer, CmdPointer)
@@ -157,7 +159,7 @@ function SearchMap ()
     --print("SearchMap")
     debugprint("SearchMap")
 
-    movableAsset = GetSingleAssetWithCapability(AIPointer, "Move")
+    movableAsset = GetIdleAssetWithCapability("Move")
     if movableAsset ~= -1 then
         x, y = GetNearestTileOfType(AIPointer, movableAsset, "None")
         --print("  Moving to " .. x .. ", " .. y)
@@ -177,7 +179,7 @@ function SearchForest ()
     debugprint("SearchForest")
     TownHallNumber = 1 --  search around the ith Townhall
     THID, THX,THY = getTownhallPosition(TownHallNumber);
-    movableAsset = GetSingleAssetWithCapability(AIPointer, "Move")
+    movableAsset = GetIdleAssetWithCapability("Move")
     if movableAsset ~= -1 then
         x, y = GetNearestTileOfType(AIPointer, THID,  "None")
         --print("  Moving to " .. x .. ", " .. y)
@@ -196,7 +198,7 @@ end
 function SiegeMap ()
     --print("SearchMap")
     debugprint("SiegeMap")
-    movableAsset = GetSingleAssetWithCapability(AIPointer, "Move")
+    movableAsset = GetIdleAssetWithCapability("Move")
     if movableAsset ~= -1 then
         x, y = GetNearestTileOfType(AIPointer, movableAsset, "None")
         if(0 > x) then
@@ -281,7 +283,7 @@ function OffensiveBarrack()
     SafeDistanceFromEnermy = 15;
     --change this setting to make the this offensive building closer or further from enermy
 
-    BuilderAsset = GetSingleAssetWithCapability(AIPointer, "BuildBarracks")
+    BuilderAsset = GetIdleAssetWithCapability("BuildBarracks")
     if BuilderAsset ~= -1 then
         buildAction = "BuildBarracks"
 
@@ -324,7 +326,7 @@ function OffensiveTower()
     SafeDistanceFromEnermy = 15;
     --change this setting to make the this offensive building closer or further from enermy
 
-    BuilderAsset = GetSingleAssetWithCapability(AIPointer, "BuildScoutTower")
+    BuilderAsset = GetIdleAssetWithCapability("BuildScoutTower")
     if BuilderAsset ~= -1 then
         buildAction = "BuildScoutTower"
         TownhallNumber =1
@@ -359,7 +361,7 @@ end
 function BuildLumberMill ()
     debugprint("BuildLumberMill")
     --print("BuildTownHall")
-    builderAsset = GetSingleAssetWithCapability(AIPointer, "BuildLumberMill")
+    builderAsset = GetIdleAssetWithCapability("BuildLumberMill")
     print(" Builder Asset ID: " .. builderAsset)
     debugprint("gotbuilder")
     if builderAsset ~= -1 then
@@ -396,7 +398,7 @@ end
 function BuildTownHall ()
     debugprint("BuildTownHall")
     --print("BuildTownHall")
-    builderAsset = GetSingleAssetWithCapability(AIPointer, "BuildTownHall")
+    builderAsset = GetIdleAssetWithCapability("BuildTownHall")
     --print(" Builder Asset ID: " .. builderAsset)
 	--debugprint("gotbuilder")
     if builderAsset ~= -1 then
@@ -429,10 +431,10 @@ end
 -- @return true if any unit is able to complete this command or if a townhall trains a peasants.
 function ActivatePeasants (trainMore)
     debugprint("ActivatePeasants")
-    goldMiners = CountAssetsWithAction(AIPointer, "MineGold")
-    lumberHarvesters = CountAssetsWithAction(AIPointer, "HarvestLumber")
-    miningAsset = GetSingleAssetWithCapability(AIPointer, "Mine")
-    townHallAsset = GetSingleAssetWithCapability(AIPointer, "BuildPeasant")
+    goldMiners = WorldState.ActionCount["MineGold"]
+    lumberHarvesters = WorldState.ActionCount["HarvestLumber"]
+    miningAsset = GetIdleAssetWithCapability("Mine")
+    townHallAsset = GetIdleAssetWithCapability("BuildPeasant")
     interruptableAsset = GetInterruptableAssetWithCapability(AIPointer, "MineGold", "Mine")
     if interruptableAsset == -1 then
         interruptableAsset = GetInterruptableAssetWithCapability(AIPointer, "HarvestLumber", "Mine")
@@ -446,15 +448,16 @@ function ActivatePeasants (trainMore)
         switchToGold = true
     end
     if miningAsset ~= -1 or (interruptableAsset ~= -1 and (switchToGold or switchToLumber)) then
-        if miningAsset~= -1 and (GetAssetLumber(miningAsset) ~= 0 or GetAssetGold(miningAsset) ~= 0) then
-            townHallX, townHallY = GetAssetTilePosition(townHallAsset)
+        miner = GetAssetHandle(AIPointer, miningAsset)
+        if miningAsset~= -1 and (miner:lumber() ~= 0 or miner:gold() ~= 0) then
+            townHallX, townHallY = GetAssetHandle(AIPointer, townHallAsset):pos()
             ConveyResources(miningAsset, townHallAsset, townHallX, townHallY)
         else
             if miningAsset == -1 then
                 miningAsset = interruptableAsset
             end
             --debugprint(goldMiners .. " " ..  GetPlayerGold(AIPointer) .. " " .. GetPlayerLumber(AIPointer) .. " ")
-            if goldMiners ~= 0 and (GetPlayerGold(AIPointer) > GetPlayerLumber(AIPointer) * 3 or switchToLumber) then
+            if goldMiners ~= 0 and (WorldState.Gold > WorldState.Lumber * 3 or switchToLumber) then
                 --debugprint("is true")
                 forestX, forestY = GetNearestTileOfType(AIPointer, miningAsset, "Forest")
                 if forestX >= 0 then
@@ -572,7 +575,7 @@ function BuildBuildings(buildingType)
 -- Gneral Building Handlers
 
     buildAction = buildingTypeToActionType[buildingType]
-    BuilderAsset = GetSingleAssetWithCapability(AIPointer, buildAction )
+    BuilderAsset = GetIdleAssetWithCapability(buildAction)
     --debugprint("BuildBuilding " .. buildingType .. nearType .. buildAction)
     --BuilderAsset, PlacementX, PlacementY = BuildBuilding(AIPointer,buildAction, buildingType, nearType)
     --debugprint("Build Asset Set: " .. BuilderAsset)
@@ -587,7 +590,7 @@ function BuildBuildings(buildingType)
     end
 
     if(buildingType=="Barracks") then
-        num = GetPlayerAssetCount(AIPointer,"Barracks")
+        num = PlayerAssetCount("Barracks")
 
         num_of_Defensive_Barracks = 2
         --change this setting to allow more or less barracks be built next to townhall
@@ -626,7 +629,7 @@ end
 --  @return True if any of the AI's units can successfully complete this command
 function TrainFootmen()
     debugprint("TrainFootmen")
-    trainerAsset = GetSingleAssetWithCapability(AIPointer, "BuildFootman")
+    trainerAsset = GetIdleAssetWithCapability("BuildFootman")
     
     if( trainerAsset ~= -1) then
         canApply = GetCanApplyCapability(AIPointer, trainerAsset, trainerAsset, "BuildFootman")
@@ -700,7 +703,7 @@ function AttackEnemies()
             targetColor = GetAssetColor(targetAsset)
 
             for i = 1, #locationTable, 3 do
-                AddCommandActor(AIPointer, CmdPointer, locationTable[i])
+                AddActor(locationTable[i])
             end
             targetType = GetAssetType(AIPointer, targetAsset)
             SetCommandAction(AIPointer, CmdPointer, "Attack")   
@@ -728,7 +731,7 @@ function GiveActorAction (actorID, action, x, y)
     debugprint("    AddedActor " .. actorID)
 
 
-    AddCommandActor(AIPointer, CmdPointer, actorID)
+    AddActor(actorID)
 
 
 
@@ -752,7 +755,7 @@ end
 -- @param actorID the AssetID of the peasant to mine
 function MineGold (actorID, mineX, mineY)
     SetCommandAction(AIPointer, CmdPointer, "Mine")
-    AddCommandActor(AIPointer, CmdPointer, actorID)
+    AddActor(actorID)
     SetCommandTargetType(AIPointer, CmdPointer, "GoldMine")
     SetCommandTargetPos(AIPointer, CmdPointer, mineX, mineY)
     
@@ -765,7 +768,7 @@ end
 -- @param actorID the AssetID of the peasant to convey
 function ConveyResources (actorID, townHallAssetID, townHallX, townHallY)
     SetCommandAction(AIPointer, CmdPointer, "Convey")
-    AddCommandActor(AIPointer, CmdPointer, actorID)
+    AddActor(actorID)
     SetCommandTargetColor(AIPointer, CmdPointer, AIColor)
     SetCommandTargetType(AIPointer, CmdPointer, GetAssetType(townHallAssetID))
     SetCommandTargetPos(AIPointer, CmdPointer, townHallX, townHallY)
@@ -773,6 +776,35 @@ end
 
 ---------------------------- Helper Functions ------------------------------------
 
+--- Adds an actor to the command and marks it as assigned for this calculation
+-- @param actorID the AssetID of the actor to add
+function AddActor (actorID)
+    AssignedAssets[actorID] = true
+    AddCommandActor(AIPointer, CmdPointer, actorID)
+end
+
+--- Gets the number of assets of a given type the player has control of, from the world state
+-- @param assetType name of the asset type, i.e. "TownHall"
+-- @return the number of assets of the type
+function PlayerAssetCount (assetType)
+    return WorldState.PlayerAssetCount[assetType] or 0
+end
+
+--- Gets an idle, unassigned asset with a given capability from the world state
+-- @param capability name of the capability, i.e. "Mine"
+-- @return the AssetID of the found asset, -1 if none was found
+function GetIdleAssetWithCapability (capability)
+    idleAssets = WorldState.IdleAssets[capability]
+    if idleAssets then
+        for i = 1, #idleAssets do
+            if not AssignedAssets[idleAssets[i]] then
+                return idleAssets[i]
+            end
+        end
+    end
+    return -1
+end
+
 function ConcatTables (t1, t2)
     for i = 1, #t2 do
         t1[#t1 + 1] = t2[i]
@@ -93,10 +93,52 @@ CAIPlayer::CAIPlayer(std::shared_ptr< CPlayerData > playerdata, int downsample,
     DCycle = 0;
     DDownSample = downsample;
     DDownSample = 100;
-    DLuaFile = luaFile.c_str();
+    DLuaFile = luaFile;
 }
 //Lua Getters
 
+#define ASSET_ID_TABLE_KEY      "AssetIDTable"
+
+/**
+ * Gets the asset ID table of the game the lua_State was set up for
+ *
+ * @param[in] L The lua_State set up by RegisterFunctions
+ *
+ * @return Pointer to the asset ID table
+ */
+CAssetIDTable *CAIPlayer::AssetIDTable(lua_State *L){
+    lua_getfield(L, LUA_REGISTRYINDEX, ASSET_ID_TABLE_KEY);
+    CAssetIDTable *Table = (CAssetIDTable *)lua_touserdata(L, -1);
+    lua_pop(L, 1);
+    return Table;
+}
+
+/**
+ * Looks up an asset by ID in the game the lua_State was set up for
+ *
+ * @param[in] L The lua_State set up by RegisterFunctions
+ * @param[in] assetID The ID of the asset
+ *
+ * @return The asset, nullptr if not found
+ */
+std::shared_ptr< CPlayerAsset > CAIPlayer::FindAsset(lua_State *L, int assetID){
+    CAssetIDTable *Table = AssetIDTable(L);
+    return Table ? Table->Find(assetID) : nullptr;
+}
+
+/**
+ * Looks up an asset by ID without copying the shared pointer
+ *
+ * @param[in] L The lua_State set up by RegisterFunctions
+ * @param[in] assetID The ID of the asset
+ *
+ * @return Raw pointer to the asset, nullptr if not found
+ */
+CPlayerAsset *CAIPlayer::FindAssetPtr(lua_State *L, int assetID){
+    CAssetIDTable *Table = AssetIDTable(L);
+    return Table ? Table->FindPtr(assetID) : nullptr;
+}
+
 /**
  * Gets the number of found assets of a given type
  * 
@@ -249,7 +291,7 @@ int CAIPlayer::GetSingleAssetWithOneOfTwoCapability(lua_State *L){
 int CAIPlayer::GetNearestTileOfType(lua_State *L){
     CAIPlayer* aiptr = (CAIPlayer*)lua_topointer(L, -3);
     int assetID = lua_tointeger(L, -2);
-    std::shared_ptr<CPlayerAsset> asset = FindAssetObj(assetID);
+    std::shared_ptr<CPlayerAsset> asset = FindAsset(L, assetID);
     CTerrainMap::ETileType tileType = TileNameToType(lua_tostring(L, -1)); //TODO: lua_tostring(L,-1) to CTerrainMap::ETileType
     CTilePosition unknownPosition = aiptr->DPlayerData->PlayerMap()->FindNearestReachableTileType(asset->TilePosition(), tileType);
     lua_pushnumber(L, unknownPosition.X());
@@ -275,8 +317,8 @@ int CAIPlayer::GetNearestTileOfTypeFromAsset(lua_State *L){
     CAIPlayer* aiptr = (CAIPlayer*)lua_topointer(L, -4);
     int assetID = lua_tointeger(L, -3);
     int centerAssetID = lua_tointeger(L, -2);
-    std::shared_ptr<CPlayerAsset> asset = FindAssetObj(assetID);
-    std::shared_ptr<CPlayerAsset> centerAsset = FindAssetObj(centerAssetID);
+    std::shared_ptr<CPlayerAsset> asset = FindAsset(L, assetID);
+    std::shared_ptr<CPlayerAsset> centerAsset = FindAsset(L, centerAssetID);
     CTerrainMap::ETileType tileType = TileNameToType(lua_tostring(L, -1)); //TODO: lua_tostring(L,-1) to CTerrainMap::ETileType
     //CTilePosition unknownPosition = aiptr->DPlayerData->PlayerMap()->FindNearestReachableTileType(asset->TilePosition(), tileType);
     CTilePosition unknownPosition = aiptr->DPlayerData->PlayerMap()->FindNearestReachableTileType(centerAsset->TilePosition(), tileType);
@@ -301,7 +343,7 @@ int CAIPlayer::GetNearestTileOfTypeFromAsset(lua_State *L){
 int CAIPlayer::GetNearestAssetToOfType(lua_State *L){
     CAIPlayer* aiptr = (CAIPlayer*)lua_topointer(L, -3);
     int assetID = lua_tointeger(L, -2);
-    std::shared_ptr<CPlayerAsset> builderAsset = FindAssetObj(assetID);
+    std::shared_ptr<CPlayerAsset> builderAsset = FindAsset(L, assetID);
     EAssetType searchType = ResolveAssetTypeFromName( aiptr, lua_tostring(L,-1));
     auto SearchedAsset = aiptr->DPlayerData->FindNearestAsset(builderAsset->Position(), searchType);
     lua_pushnumber(L, SearchedAsset->AssetID());
@@ -328,7 +370,7 @@ int CAIPlayer::GetBestAssetPlacement(lua_State *L){
     int posY = lua_tointeger(L, -4);
     CTilePosition* pos = new CTilePosition(posX, posY);
     int builderAssetID = lua_tointeger(L, -3);
-    std::shared_ptr<CPlayerAsset> builderAsset = FindAssetObj(builderAssetID);
+    std::shared_ptr<CPlayerAsset> builderAsset = FindAsset(L, builderAssetID);
     EAssetType assetToBuild = ResolveAssetTypeFromName( aiptr, lua_tostring(L,-2));
     int buffer = lua_tointeger(L, -1);
     CTilePosition placement = aiptr->DPlayerData->FindBestAssetPlacement(*pos, builderAsset, assetToBuild, buffer);
@@ -363,7 +405,7 @@ int CAIPlayer::FindAssetPlacementWithConstraints(lua_State *L){
     int HConstrants = lua_tointeger(L, -8);
     int VConstrants = lua_tointeger(L, -7);
 
-    std::shared_ptr<CPlayerAsset> builderAsset = FindAssetObj(lua_tointeger(L, -9));
+    std::shared_ptr<CPlayerAsset> builderAsset = FindAsset(L, lua_tointeger(L, -9));
     int targetX = lua_tointeger(L, -6);
     int targetY = lua_tointeger(L, -5);
 
@@ -396,7 +438,7 @@ int CAIPlayer::FindAssetPlacementWithConstraints(lua_State *L){
  */
 int CAIPlayer::GetAssetTilePosition(lua_State *L){
     int assetID = lua_tointeger(L, -1);
-    std::shared_ptr<CPlayerAsset> asset = FindAssetObj(assetID);
+    CPlayerAsset *asset = FindAssetPtr(L, assetID);
     CTilePosition position = asset->TilePosition();
     lua_pushnumber(L, position.X());
     lua_pushnumber(L, position.Y());
@@ -470,7 +512,7 @@ int CAIPlayer::GetInterruptableAssetWithCapability(lua_State *L){
 int CAIPlayer::GetAssetLumber(lua_State *L){
     CAIPlayer* aiptr = (CAIPlayer*)lua_topointer(L, -2);
     int assetID = lua_tointeger(L, -1);
-    std::shared_ptr<CPlayerAsset> asset = FindAssetObj(assetID);
+    CPlayerAsset *asset = FindAssetPtr(L, assetID);
     lua_pushnumber(L, asset->Lumber());
     return 1;
 }
@@ -488,7 +530,7 @@ int CAIPlayer::GetAssetLumber(lua_State *L){
 int CAIPlayer::GetAssetGold(lua_State *L){
     CAIPlayer* aiptr = (CAIPlayer*)lua_topointer(L, -2);
     int assetID = lua_tointeger(L, -1);
-    std::shared_ptr<CPlayerAsset> asset = FindAssetObj(assetID);
+    CPlayerAsset *asset = FindAssetPtr(L, assetID);
     lua_pushnumber(L, asset->Gold());
     return 1;
 }
@@ -506,7 +548,7 @@ int CAIPlayer::GetAssetGold(lua_State *L){
 int CAIPlayer::GetAssetType(lua_State *L){
     CAIPlayer* aiptr = (CAIPlayer*)lua_topointer(L, -2);
     int assetID = lua_tointeger(L, -1);
-    std::shared_ptr<CPlayerAsset> asset = FindAssetObj(assetID);
+    CPlayerAsset *asset = FindAssetPtr(L, assetID);
     lua_pushstring(L, CPlayerAssetType::TypeToName(asset->Type()).c_str());
     return 1;
 }
@@ -556,9 +598,9 @@ int CAIPlayer::GetPlayerLumber(lua_State *L){
 int CAIPlayer::GetCanApplyCapability(lua_State *L){
     CAIPlayer* aiptr = (CAIPlayer*)lua_topointer(L, -4);
     int assetID = lua_tointeger(L, -3);
-    std::shared_ptr<CPlayerAsset> asset = FindAssetObj(assetID);
+    std::shared_ptr<CPlayerAsset> asset = FindAsset(L, assetID);
     int targetID = lua_tointeger(L, -2);
-    std::shared_ptr<CPlayerAsset> target = FindAssetObj(targetID);
+    std::shared_ptr<CPlayerAsset> target = FindAsset(L, targetID);
     auto PlayerCapability = CPlayerCapability::FindCapability(lua_tostring(L,-1));
     if (PlayerCapability){
         lua_pushboolean(L, PlayerCapability->CanApply(asset, aiptr->DPlayerData, target));
@@ -768,7 +810,7 @@ int CAIPlayer::GetAllAssetOfOneType(lua_State *L){
  **/
 int CAIPlayer::SearchMapForEnemies(lua_State* L){
     CAIPlayer* aiptr = (CAIPlayer*)lua_topointer(L, -2);
-    auto TownHallAsset = FindAssetObj(lua_tointeger(L,-1));
+    auto TownHallAsset = FindAsset(L, lua_tointeger(L,-1));
     if(aiptr->DPlayerData->FindNearestEnemy(TownHallAsset->Position(), -1).expired()){
         lua_pushboolean(L, true);
         return 1;
@@ -811,7 +853,7 @@ int CAIPlayer::AddCommandActor(lua_State *L){
     CAIPlayer* aiptr = (CAIPlayer*)lua_topointer(L, -3);
     SPlayerCommandRequest* cmdptr = (SPlayerCommandRequest*)lua_topointer(L, -2);
     int actorID = lua_tointeger(L, -1);
-    auto asset = FindAssetObj(actorID);
+    auto asset = FindAsset(L, actorID);
     if(!asset) return 0;
     cmdptr->DActors.push_back(asset);
     aiptr->DAssignedAssets[asset->AssetID()] = true;
@@ -1021,7 +1063,7 @@ int CAIPlayer::GetNearestEnemyLocation(lua_State* L){
 */
 int CAIPlayer::GetAssetColor(lua_State* L){
     int assetID = lua_tointeger(L, -1);
-    std::shared_ptr<CPlayerAsset> asset = FindAssetObj(assetID);
+    std::shared_ptr<CPlayerAsset> asset = FindAsset(L, assetID);
     lua_pushstring(L, ColorTypeToName(asset->Color()).c_str());
     return 1;
 }
@@ -1035,13 +1077,290 @@ int CAIPlayer::GetAssetColor(lua_State* L){
 int CAIPlayer::CanInitiate(lua_State * L)
 {
     CAIPlayer* aiptr = (CAIPlayer*)lua_topointer(L, -3);
-    std::shared_ptr<CPlayerAsset> asset = FindAssetObj(lua_tointeger(L,-2));
+    std::shared_ptr<CPlayerAsset> asset = FindAsset(L, lua_tointeger(L,-2));
     EAssetCapabilityType capability = ResolveAssetCapabilityFromName(lua_tostring(L, -1));
     std::shared_ptr< CPlayerCapability > playerCapability = CPlayerCapability::FindCapability(capability);
     lua_pushboolean(L, playerCapability->CanInitiate(asset, aiptr->DPlayerData));
     return 1;
 }
 
+/**
+ * Gets a snapshot of the player's world state in a single call, so the brain
+ * does not need to cross into C++ once per asset type, capability or action.
+ * The returned table has the fields Gold, Lumber, Stone, FoodConsumption,
+ * FoodProduction, PlayerAssetCount[TypeName], FoundAssetCount[TypeName],
+ * ActionCount[ActionName], IdleAssets[CapabilityName] = { AssetIDs } and
+ * Assets = { AssetHandles } of all owned assets.
+ * Idle assets already assigned to a command are left out.
+ * 
+ * ---Parameters and returns are documented as Lua Side
+ *
+ * @param[in] AIPointer Pointer to the CAIPlayer to reference
+ *
+ * @return Table holding the world state of the player
+ */
+int CAIPlayer::GetWorldState(lua_State *L){
+    CAIPlayer* aiptr = (CAIPlayer*)lua_topointer(L, -1);
+    auto PlayerData = aiptr->DPlayerData;
+    int PlayerCounts[to_underlying(EAssetType::Max)] = {0};
+    int FoundCounts[to_underlying(EAssetType::Max)] = {0};
+    int ActionCounts[to_underlying(EAssetAction::Capability) + 1] = {0};
+    std::vector< int > IdleByCapability[to_underlying(EAssetCapabilityType::Max)];
+    int TotalConsumption = 0;
+    int TotalProduction = 0;
+
+    // Single pass over the visible map for the type counts
+    for(auto &Asset : PlayerData->PlayerMap()->Assets()){
+        int TypeIndex = to_underlying(Asset->Type());
+        if((0 <= TypeIndex)&&(TypeIndex < to_underlying(EAssetType::Max))){
+            FoundCounts[TypeIndex]++;
+            if(Asset->Color() == PlayerData->Color()){
+                PlayerCounts[TypeIndex]++;
+            }
+        }
+    }
+
+    // Single pass over the owned assets for actions, idle assets and food
+    for(auto &WeakAsset : PlayerData->Assets()){
+        if(auto Asset = WeakAsset.lock()){
+            for(int Index = 0; Index < to_underlying(EAssetAction::Capability) + 1; Index++){
+                if(Asset->HasAction((EAssetAction)Index)){
+                    ActionCounts[Index]++;
+                }
+            }
+            if((EAssetAction::None == Asset->Action())&&(EAssetType::None != Asset->Type())&&(!aiptr->DAssignedAssets[Asset->AssetID()])){
+                for(auto Capability : Asset->Capabilities()){
+                    IdleByCapability[to_underlying(Capability)].push_back(Asset->AssetID());
+                }
+            }
+            int AssetConsumption = Asset->FoodConsumption();
+            if(0 < AssetConsumption){
+                TotalConsumption += AssetConsumption;
+            }
+            else if((0 > AssetConsumption)&&((EAssetAction::Construct != Asset->Action())||(!Asset->CurrentCommand().DAssetTarget))){
+                TotalProduction += -AssetConsumption;
+            }
+        }
+    }
+
+    lua_newtable(L);
+    lua_pushnumber(L, PlayerData->Gold());
+    lua_setfield(L, -2, "Gold");
+    lua_pushnumber(L, PlayerData->Lumber());
+    lua_setfield(L, -2, "Lumber");
+    lua_pushnumber(L, PlayerData->Stone());
+    lua_setfield(L, -2, "Stone");
+    lua_pushnumber(L, TotalConsumption);
+    lua_setfield(L, -2, "FoodConsumption");
+    lua_pushnumber(L, TotalProduction);
+    lua_setfield(L, -2, "FoodProduction");
+
+    lua_newtable(L);
+    for(int Index = 1; Index < to_underlying(EAssetType::Max); Index++){
+        lua_pushnumber(L, PlayerCounts[Index]);
+        lua_setfield(L, -2, CPlayerAssetType::TypeToName((EAssetType)Index).c_str());
+    }
+    lua_setfield(L, -2, "PlayerAssetCount");
+
+    lua_newtable(L);
+    for(int Index = 1; Index < to_underlying(EAssetType::Max); Index++){
+        lua_pushnumber(L, FoundCounts[Index]);
+        lua_setfield(L, -2, CPlayerAssetType::TypeToName((EAssetType)Index).c_str());
+    }
+    lua_setfield(L, -2, "FoundAssetCount");
+
+    lua_newtable(L);
+    for(int Index = 0; Index < to_underlying(EAssetAction::Capability) + 1; Index++){
+        lua_pushnumber(L, ActionCounts[Index]);
+        lua_setfield(L, -2, ActionTypeToName((EAssetAction)Index).c_str());
+    }
+    lua_setfield(L, -2, "ActionCount");
+
+    lua_newtable(L);
+    for(int Index = 1; Index < to_underlying(EAssetCapabilityType::Max); Index++){
+        lua_newtable(L);
+        int ListIndex = 1;
+        for(auto AssetID : IdleByCapability[Index]){
+            lua_pushnumber(L, AssetID);
+            lua_rawseti(L, -2, ListIndex++);
+        }
+        lua_setfield(L, -2, CPlayerCapability::TypeToName((EAssetCapabilityType)Index).c_str());
+    }
+    lua_setfield(L, -2, "IdleAssets");
+
+    lua_newtable(L);
+    int AssetIndex = 1;
+    for(auto &WeakAsset : PlayerData->Assets()){
+        if(auto Asset = WeakAsset.lock()){
+            PushAssetHandle(L, Asset->AssetID());
+            lua_rawseti(L, -2, AssetIndex++);
+        }
+    }
+    lua_setfield(L, -2, "Assets");
+
+    return 1;
+}
+
+/**
+ * Gets a handle to an asset. The handle has the methods id, type, color, pos,
+ * gold, lumber, stone, hitpoints, action and alive, i.e. asset:gold()
+ * 
+ * ---Parameters and returns are documented as Lua Side
+ *
+ * @param[in] AIPointer Pointer to the CAIPlayer to reference
+ * @param[in] AssetID The ID of the asset
+ *
+ * @return Handle to the asset
+ */
+int CAIPlayer::GetAssetHandle(lua_State *L){
+    PushAssetHandle(L, lua_tointeger(L, -1));
+    return 1;
+}
+
+//Lua Asset Handles
+
+#define ASSET_HANDLE_METATABLE  "AssetHandle"
+
+/**
+ * Pushes a handle to an asset. The handle only holds the asset ID and the
+ * game's ID table, accessors resolve it through the table so no shared_ptr
+ * is copied.
+ *
+ * @param[in] L The lua_State to push the handle onto
+ * @param[in] assetID The ID of the asset
+ */
+void CAIPlayer::PushAssetHandle(lua_State *L, int assetID){
+    SAssetHandle *Handle = (SAssetHandle *)lua_newuserdata(L, sizeof(SAssetHandle));
+    Handle->DAssetIDTable = AssetIDTable(L);
+    Handle->DAssetID = assetID;
+    luaL_setmetatable(L, ASSET_HANDLE_METATABLE);
+}
+
+/**
+ * Resolves the asset handle at the stack index
+ *
+ * @param[in] L The lua_State holding the handle
+ * @param[in] index The stack index of the handle
+ *
+ * @return Raw pointer to the asset, nullptr if it no longer exists
+ */
+CPlayerAsset *CAIPlayer::CheckAssetHandle(lua_State *L, int index){
+    SAssetHandle *Handle = (SAssetHandle *)luaL_checkudata(L, index, ASSET_HANDLE_METATABLE);
+    return Handle->DAssetIDTable ? Handle->DAssetIDTable->FindPtr(Handle->DAssetID) : nullptr;
+}
+
+int CAIPlayer::AssetHandleID(lua_State *L){
+    SAssetHandle *Handle = (SAssetHandle *)luaL_checkudata(L, 1, ASSET_HANDLE_METATABLE);
+    lua_pushnumber(L, Handle->DAssetID);
+    return 1;
+}
+
+int CAIPlayer::AssetHandleType(lua_State *L){
+    CPlayerAsset *Asset = CheckAssetHandle(L, 1);
+    if(!Asset){
+        return 0;
+    }
+    lua_pushstring(L, CPlayerAssetType::TypeToName(Asset->Type()).c_str());
+    return 1;
+}
+
+int CAIPlayer::AssetHandleColor(lua_State *L){
+    CPlayerAsset *Asset = CheckAssetHandle(L, 1);
+    if(!Asset){
+        return 0;
+    }
+    lua_pushstring(L, ColorTypeToName(Asset->Color()).c_str());
+    return 1;
+}
+
+int CAIPlayer::AssetHandlePos(lua_State *L){
+    CPlayerAsset *Asset = CheckAssetHandle(L, 1);
+    if(!Asset){
+        return 0;
+    }
+    CTilePosition Position = Asset->TilePosition();
+    lua_pushnumber(L, Position.X());
+    lua_pushnumber(L, Position.Y());
+    return 2;
+}
+
+int CAIPlayer::AssetHandleGold(lua_State *L){
+    CPlayerAsset *Asset = CheckAssetHandle(L, 1);
+    if(!Asset){
+        return 0;
+    }
+    lua_pushnumber(L, Asset->Gold());
+    return 1;
+}
+
+int CAIPlayer::AssetHandleLumber(lua_State *L){
+    CPlayerAsset *Asset = CheckAssetHandle(L, 1);
+    if(!Asset){
+        return 0;
+    }
+    lua_pushnumber(L, Asset->Lumber());
+    return 1;
+}
+
+int CAIPlayer::AssetHandleStone(lua_State *L){
+    CPlayerAsset *Asset = CheckAssetHandle(L, 1);
+    if(!Asset){
+        return 0;
+    }
+    lua_pushnumber(L, Asset->Stone());
+    return 1;
+}
+
+int CAIPlayer::AssetHandleHitPoints(lua_State *L){
+    CPlayerAsset *Asset = CheckAssetHandle(L, 1);
+    if(!Asset){
+        return 0;
+    }
+    lua_pushnumber(L, Asset->HitPoints());
+    return 1;
+}
+
+int CAIPlayer::AssetHandleAction(lua_State *L){
+    CPlayerAsset *Asset = CheckAssetHandle(L, 1);
+    if(!Asset){
+        return 0;
+    }
+    lua_pushstring(L, ActionTypeToName(Asset->Action()).c_str());
+    return 1;
+}
+
+int CAIPlayer::AssetHandleAlive(lua_State *L){
+    CPlayerAsset *Asset = CheckAssetHandle(L, 1);
+    lua_pushboolean(L, Asset && Asset->Alive());
+    return 1;
+}
+
+/**
+ * Creates the metatable shared by all asset handles
+ *
+ * @param[in] L The lua_State the register the metatable into
+ */
+void CAIPlayer::RegisterAssetHandle(lua_State *L){
+    static const luaL_Reg Methods[] = {
+        {"id", AssetHandleID},
+        {"type", AssetHandleType},
+        {"color", AssetHandleColor},
+        {"pos", AssetHandlePos},
+        {"gold", AssetHandleGold},
+        {"lumber", AssetHandleLumber},
+        {"stone", AssetHandleStone},
+        {"hitpoints", AssetHandleHitPoints},
+        {"action", AssetHandleAction},
+        {"alive", AssetHandleAlive},
+        {nullptr, nullptr}
+    };
+
+    luaL_newmetatable(L, ASSET_HANDLE_METATABLE);
+    luaL_newlib(L, Methods);
+    lua_setfield(L, -2, "__index");
+    lua_pop(L, 1);
+}
+
 //Lua Registration
 
 /**
@@ -1050,6 +1369,9 @@ int CAIPlayer::CanInitiate(lua_State * L)
  * @param[in] L The lua_State the register the functions into
  */
 void CAIPlayer::RegisterFunctions(lua_State *L){
+    lua_pushlightuserdata(L, DPlayerData->AssetIDTable().get());
+    lua_setfield(L, LUA_REGISTRYINDEX, ASSET_ID_TABLE_KEY);
+
     //Getters
 
     lua_register(L, "FindAssetPlacementWithConstraints", FindAssetPlacementWithConstraints);
@@ -1086,6 +1408,9 @@ void CAIPlayer::RegisterFunctions(lua_State *L){
     lua_register(L, "GetNearestEnemy", GetNearestEnemy);
     lua_register(L, "GetAssetColor", GetAssetColor);
     lua_register(L, "CanInitiate", CanInitiate);
+    lua_register(L, "GetWorldState", GetWorldState);
+    lua_register(L, "GetAssetHandle", GetAssetHandle);
+    RegisterAssetHandle(L);
 
     //Command Setters
     lua_register(L, "SetCommandAction", SetCommandAction);
@@ -1122,8 +1447,7 @@ void CAIPlayer::CalculateCommand(SPlayerCommandRequest &command){
         //Register functions
         RegisterFunctions(AIL);
         //Load the brain
-        //luaL_dofile(AIL, DLuaFile);
-        luaL_dofile(AIL, "./scripts/brain.lua");
+        luaL_dofile(AIL, DLuaFile.c_str());
         //Set AI Pointer
         lua_pushlightuserdata(AIL, this);
         lua_setglobal(AIL, "AIPointer");
@@ -39,6 +39,7 @@
 #include "ApplicationData.h"
 #include "ApplicationPath.h"
 #include "AssetLoader.h"
+#include "PackDataContainer.h"
 #include "FileDataContainer.h"
 #include "MemoryDataSource.h"
 #include "MainMenuMode.h"
@@ -49,17 +50,24 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <algorithm>
+#include <sys/stat.h>
 extern "C" {
     #include "lua.h"
     #include "lauxlib.h"
     #include "lualib.h"
 }
 #include "EventHandler.h"
+#include "BattleMode.h"
 
 #define INITIAL_MAP_WIDTH       800
 #define INITIAL_MAP_HEIGHT      600
 #define TIMEOUT_INTERVAL        50
 #define TIMEOUT_FREQUENCY       (1000 / TIMEOUT_INTERVAL)
+#define RENDER_INTERVAL         16
+#define MAX_SIMULATION_STEPS    4
+#define MAX_SKIPPED_FRAMES      4
+#define FRAME_TIME_SMOOTHING    0.1
 #define MINI_MAP_MIN_WIDTH      128
 #define MINI_MAP_MIN_HEIGHT     128
 #define VEGITATE_SOUNDLIBMIXER  true
@@ -115,6 +123,11 @@ CApplicationData::CApplicationData(const std::string &appname, const SPrivateApp
 
     DMenuButtonState = CButtonRenderer::EButtonState::None;
 
+    DSimulationAccumulator = 0.0;
+    DRenderInterpolation = 1.0;
+    DConsecutiveSkippedFrames = 0;
+    ResetFrameStatistics();
+
     DGroupHotKeyMap[SGUIKeyType::Key0] = std::list< std::weak_ptr< CPlayerAsset > >();
     DGroupHotKeyMap[SGUIKeyType::Key1] = std::list< std::weak_ptr< CPlayerAsset > >();
     DGroupHotKeyMap[SGUIKeyType::Key2] = std::list< std::weak_ptr< CPlayerAsset > >();
@@ -375,11 +388,15 @@ void CApplicationData::Activate(){
     // Sets up the environment (i.e application path and directory/filesystem so the
     // game can find files it needs.
     CPath AppPath = GetApplicationPath().Containing();
-    std::shared_ptr< CDataContainer > TempDataContainer = std::make_shared< CDirectoryDataContainer >(AppPath.ToString() + "/data");
+    std::shared_ptr< CDataContainer > TempDataContainer = CPackDataContainer::OpenDataContainer(AppPath.ToString() + "/data", true);
     std::shared_ptr< CDataContainer > ImageDirectory = TempDataContainer->DataContainer("img");
     std::shared_ptr< CDataContainerIterator > FileIterator;
     std::shared_ptr< CDataSource > TempDataSource;
 
+    // Recolored tilesets are cached next to the data directory across runs
+    mkdir((AppPath.ToString() + "/cache").c_str(), S_IRWXU);
+    DTilesetCacheContainer = std::make_shared< CDirectoryDataContainer >(AppPath.ToString() + "/cache", true);
+
     // Instantiate AssetLoader with environment variables to load assets
     std::shared_ptr< CApplicationData > AppData = shared_from_this();
     CAssetLoader AssetLoader(AppData, TempDataContainer, ImageDirectory);
@@ -831,14 +848,7 @@ void CApplicationData::Activate(){
         return;
     }
 */
-PrintDebug(DEBUG_LOW, "Loading Wall\n");
-RenderSplashStep();
-TempDataSource = ImageDirectory->DataSource("Wall.dat");
-DAssetTilesets[to_underlying(EAssetType::Wall)] = std::make_shared< CGraphicMulticolorTileset > ();
-if(!DAssetTilesets[to_underlying(EAssetType::Wall)]->LoadTileset(DPlayerRecolorMap, TempDataSource)){
-    PrintError("Failed to load wall tileset.\n");
-    return;
-}
+    AssetLoader.LoadWall();
     AssetLoader.LoadBarracks();
 /**
     PrintDebug(DEBUG_LOW, "Loading Barracks\n");
@@ -906,12 +916,8 @@ if(!DAssetTilesets[to_underlying(EAssetType::Wall)]->LoadTileset(DPlayerRecolorM
     }
 */
 
-    RenderSplashStep();
-    for(auto AssetTileset : DAssetTilesets){
-        if(AssetTileset != nullptr){
-            AssetTileset->CreateClippingMasks();
-        }
-    }
+    // Clipping masks of the asset tilesets are created by the loader
+    AssetLoader.Finish();
     PrintDebug(DEBUG_LOW, "Assets Loaded\n");
 
     PrintDebug(DEBUG_LOW, "Loading res directory\n");
@@ -978,7 +984,9 @@ if(!DAssetTilesets[to_underlying(EAssetType::Wall)]->LoadTileset(DPlayerRecolorM
     // Set up game timer (how often to update game) and the current/next game mode
     DApplicationMode = DNextApplicationMode = CMainMenuMode::Instance();
 
-    DApplication->SetTimer(TIMEOUT_INTERVAL, this, TimeoutCallback);
+    // The game is stepped every TIMEOUT_INTERVAL, the timer paces the frames
+    DLastTimeoutTime = DLastFrameTime = std::chrono::steady_clock::now();
+    DApplication->SetTimer(RENDER_INTERVAL, this, TimeoutCallback);
 
     // Play background music
     DSoundLibraryMixer->StopSong();
@@ -987,24 +995,56 @@ if(!DAssetTilesets[to_underlying(EAssetType::Wall)]->LoadTileset(DPlayerRecolorM
 }
 
 /**
-* Is called whenever the timer fires, is used to update the game using the
-* methods from the mode the game is currently in. Always calls the current
-* mode's Input, Calculate, and Render functions. Updates the current mode
-* with the next mode and draws the cursor.
+* Is called whenever the timer fires. The game is advanced by the mode's
+* Input and Calculate functions in fixed steps of TIMEOUT_INTERVAL for the
+* time that has passed, so game time does not depend on how fast frames are
+* drawn. The frame is then drawn by the mode's Render function, with the
+* assets placed between the last two steps. When the steps cannot keep up
+* frames are skipped, and once MAX_SKIPPED_FRAMES are skipped in a row the
+* steps that are still behind are dropped. Updates the current mode with the
+* next mode and draws the cursor. The frame statistics of a mode are logged
+* when it is left.
 *
 * @return Nothing.
 *
 */
 
 bool CApplicationData::Timeout(){
-    DApplicationMode->Input(shared_from_this());
-    DApplicationMode->Calculate(shared_from_this());
-    DApplicationMode->Render(shared_from_this());
-
-    if(!DLeftDown || (2 != DLeftClick)){
-        DLeftClick = 0;
+    auto CurrentTime = std::chrono::steady_clock::now();
+    int Steps = 0;
+
+    DSimulationAccumulator += std::chrono::duration< double, std::milli >(CurrentTime - DLastTimeoutTime).count();
+    DLastTimeoutTime = CurrentTime;
+    // Steps stop at a mode change so the old mode renders once before the switch
+    while((TIMEOUT_INTERVAL <= DSimulationAccumulator)&&(MAX_SIMULATION_STEPS > Steps)&&!ModeIsChanging()){
+        DApplicationMode->Input(shared_from_this());
+        DApplicationMode->Calculate(shared_from_this());
+
+        if(!DLeftDown || (2 != DLeftClick)){
+            DLeftClick = 0;
+        }
+        DRightClick = 0;
+
+        DApplicationMode->IncrementTimer();
+        DSimulationAccumulator -= TIMEOUT_INTERVAL;
+        Steps++;
+    }
+    DFrameStatistics.DSimulationSteps += Steps;
+    if((TIMEOUT_INTERVAL <= DSimulationAccumulator)&&!ModeIsChanging()){
+        if(MAX_SKIPPED_FRAMES > DConsecutiveSkippedFrames){
+            DConsecutiveSkippedFrames++;
+            DFrameStatistics.DSkippedFrames++;
+            return true;
+        }
+        // Too far behind to catch up, the game slows down instead
+        DFrameStatistics.DDroppedSteps += static_cast<int>(DSimulationAccumulator / TIMEOUT_INTERVAL);
+        DSimulationAccumulator -= TIMEOUT_INTERVAL * static_cast<int>(DSimulationAccumulator / TIMEOUT_INTERVAL);
     }
-    DRightClick = 0;
+    DConsecutiveSkippedFrames = 0;
+    DRenderInterpolation = std::min(1.0, DSimulationAccumulator / TIMEOUT_INTERVAL);
+
+    auto RenderStartTime = std::chrono::steady_clock::now();
+    DApplicationMode->Render(shared_from_this());
 
     DCursorSet->DrawCursor(DWorkingBufferSurface, DCurrentX, DCurrentY, DCursorIndices[DCursorType]);
 
@@ -1012,13 +1052,53 @@ bool CApplicationData::Timeout(){
 
     DDrawingArea->Invalidate();
 
-    DApplicationMode->IncrementTimer();
+    auto FrameTime = std::chrono::steady_clock::now();
+    double RenderTime = std::chrono::duration< double, std::milli >(FrameTime - RenderStartTime).count();
+    double FrameInterval = std::chrono::duration< double, std::milli >(FrameTime - DLastFrameTime).count();
+
+    DLastFrameTime = FrameTime;
+    if(DFrameStatistics.DRenderedFrames){
+        DFrameStatistics.DAverageFrameTime += (FrameInterval - DFrameStatistics.DAverageFrameTime) * FRAME_TIME_SMOOTHING;
+        DFrameStatistics.DAverageRenderTime += (RenderTime - DFrameStatistics.DAverageRenderTime) * FRAME_TIME_SMOOTHING;
+    }
+    else{
+        DFrameStatistics.DAverageFrameTime = FrameInterval;
+        DFrameStatistics.DAverageRenderTime = RenderTime;
+    }
+    DFrameStatistics.DMaxRenderTime = std::max(DFrameStatistics.DMaxRenderTime, RenderTime);
+    DFrameStatistics.DRenderedFrames++;
+
     //PrintDebug(DEBUG_LOW, "Timer value is %lf\n", DApplicationMode->GetTime());
+    if(ModeIsChanging()){
+        PrintDebug(DEBUG_LOW, "Frames %d, skipped %d, steps %d, dropped steps %d, frame %.2lfms, render %.2lfms, max render %.2lfms\n", DFrameStatistics.DRenderedFrames, DFrameStatistics.DSkippedFrames, DFrameStatistics.DSimulationSteps, DFrameStatistics.DDroppedSteps, DFrameStatistics.DAverageFrameTime, DFrameStatistics.DAverageRenderTime, DFrameStatistics.DMaxRenderTime);
+        ResetFrameStatistics();
+        // The change may have loaded a map, that time is not played as steps
+        DSimulationAccumulator = 0.0;
+        DConsecutiveSkippedFrames = 0;
+        DLastTimeoutTime = DLastFrameTime = std::chrono::steady_clock::now();
+    }
     DApplicationMode = DNextApplicationMode;
 
     return true;
 }
 
+/**
+* Clears the frame statistics, they are kept for each mode
+*
+* @return Nothing.
+*
+*/
+
+void CApplicationData::ResetFrameStatistics(){
+    DFrameStatistics.DRenderedFrames = 0;
+    DFrameStatistics.DSkippedFrames = 0;
+    DFrameStatistics.DSimulationSteps = 0;
+    DFrameStatistics.DDroppedSteps = 0;
+    DFrameStatistics.DAverageFrameTime = 0.0;
+    DFrameStatistics.DAverageRenderTime = 0.0;
+    DFrameStatistics.DMaxRenderTime = 0.0;
+}
+
 /**
 * Returns a bool to either trigger the destruction or not destruction (lol)
 * of the main window.
@@ -1619,9 +1699,9 @@ void CApplicationData::LoadGameMap(int index){
     std::string luaFile;
 
     DGameModel = std::make_shared< CGameModel >(index, 0x123456789ABCDEFULL, DLoadingPlayerColors);
-    CEventHandler::SetGameModelReference(DGameModel);
-    CEventHandler::RegisterAction();
-    CEventHandler::SetEventScript(DGameModel->GetTriggerHandler()->GetEventScript());
+    DEventHandler = std::make_shared< CEventHandler >(DGameModel);
+    DEventHandler->RegisterAction();
+    DEventHandler->SetEndGameCall(CBattleMode::TriggeredEnd);
 
     // Apply AI difficulty settings, assign lua file for each AIPlayer object
     for(int Index = 1; Index < to_underlying(EPlayerColor::Max); Index++){
@@ -1632,13 +1712,13 @@ void CApplicationData::LoadGameMap(int index){
             int Downsample = 1;
             switch(DLoadingPlayerTypes[Index]){
                 case ptAIEasy:      Downsample = CPlayerAsset::UpdateFrequency();
-                                    luaFile = ".scripts/brain.lua";
+                                    luaFile = "./scripts/brain.lua";
                                     break;
                 case ptAIMedium:    Downsample = CPlayerAsset::UpdateFrequency() / 2;
-                                    luaFile = ".scripts/brain.lua";
+                                    luaFile = "./scripts/brain.lua";
                                     break;
                 default:            Downsample = CPlayerAsset::UpdateFrequency() / 4;
-                                    luaFile = ".scripts/brain.lua";
+                                    luaFile = "./scripts/brain.lua";
                                     break;
             }
             DAIPlayers[Index] = std::make_shared< CAIPlayer > (DGameModel->Player(static_cast<EPlayerColor>(Index)), Downsample, luaFile);
@@ -1646,6 +1726,19 @@ void CApplicationData::LoadGameMap(int index){
 
     }
 
+    // Recolor the tilesets for the colors in play now instead of on their
+    // first draw during the battle, other colors are never recolored
+    for(int Index = 1; Index < to_underlying(EPlayerColor::Max); Index++){
+        if(DGameModel->Player(static_cast<EPlayerColor>(Index))->IsAlive()){
+            for(auto &Tileset : DAssetTilesets){
+                if(Tileset){
+                    Tileset->ColoredTileset(Index - 1);
+                }
+            }
+            DIconTileset->ColoredTileset(Index - 1);
+        }
+    }
+
     DCurrentAssetCapability = EAssetCapabilityType::None;
 
     // Set up map dimensions and tiles
@@ -1839,7 +1932,6 @@ void CApplicationData::ResizeCanvases(){
         CurHeight = DViewportSurface->Height();
         if((ViewportWidth != CurWidth)||(ViewportHeight != CurHeight)){
             DViewportSurface = nullptr;
-            DViewportTypeSurface = nullptr;
         }
     }
     if(nullptr == DViewportSurface){
@@ -1856,7 +1948,6 @@ void CApplicationData::ResizeCanvases(){
         ResourceContext->SetSourceRGB(ColorBlack);
         ResourceContext->Rectangle(0, 0, ViewportWidth, ViewportHeight);
         ResourceContext->Fill();
-        DViewportTypeSurface = CGraphicFactory::CreateSurface(ViewportWidth, ViewportHeight, CGraphicSurface::ESurfaceFormat::ARGB32); //DDrawingArea->CreateSimilarSurface(ViewportWidth, ViewportHeight);
     }
     PrintDebug(DEBUG_LOW, "Resizing Complete\n");
 }
@@ -19,6 +19,7 @@
 #include "Tokenizer.h"
 #include "Debug.h"
 #include <queue>
+#include <set>
 #include <algorithm>
 #include "TriggerHandler.h"
 
@@ -55,7 +56,7 @@ std::vector< std::shared_ptr< CAssetDecoratedMap > > CAssetDecoratedMap::DAllMap
 */
 
 CAssetDecoratedMap::CAssetDecoratedMap() : CTerrainMap(){
-    
+    DTriggerHandlerIndex = -1;
 }
 
 /**
@@ -71,6 +72,7 @@ CAssetDecoratedMap::CAssetDecoratedMap(const CAssetDecoratedMap &map) : CTerrain
     DAssets = map.DAssets;
     DLumberAvailable = map.DLumberAvailable;
     DStoneAvailable = map.DStoneAvailable;
+    DTriggerHandlerIndex = map.DTriggerHandlerIndex;
     DAssetInitializationList = map.DAssetInitializationList;
     DResourceInitializationList = map.DResourceInitializationList;
 }
@@ -90,6 +92,7 @@ CAssetDecoratedMap::CAssetDecoratedMap(const CAssetDecoratedMap &map, const std:
     DAssets = map.DAssets;
     DLumberAvailable = map.DLumberAvailable;
     DStoneAvailable = map.DStoneAvailable;
+    DTriggerHandlerIndex = map.DTriggerHandlerIndex;
     
     for(auto &InitVal : map.DAssetInitializationList){
         auto NewInitVal = InitVal;
@@ -136,6 +139,7 @@ CAssetDecoratedMap &CAssetDecoratedMap::operator=(const CAssetDecoratedMap &map)
         DAssets = map.DAssets;
         DLumberAvailable = map.DLumberAvailable;
         DStoneAvailable = map.DStoneAvailable;
+        DTriggerHandlerIndex = map.DTriggerHandlerIndex;
         DAssetInitializationList = map.DAssetInitializationList;
         DResourceInitializationList = map.DResourceInitializationList;
     }
@@ -143,9 +147,11 @@ CAssetDecoratedMap &CAssetDecoratedMap::operator=(const CAssetDecoratedMap &map)
 }
 
 /**
-* Load in the data for all the maps from .map files  
+* Load in the data for all the maps from compiled .mapb bundles, and from
+* the .map files that have no valid bundle. A bundle whose .map has changed
+* since it was compiled is out of date, and its .map is loaded instead.
 *
-* @param[in] container Used to load in data from .map files
+* @param[in] container Used to load in data from .mapb and .map files
 *
 * @return true if iterated through file
 *
@@ -153,14 +159,51 @@ CAssetDecoratedMap &CAssetDecoratedMap::operator=(const CAssetDecoratedMap &map)
 
 bool CAssetDecoratedMap::LoadMaps(std::shared_ptr< CDataContainer > container){
     auto FileIterator = container->First();
+    std::vector< std::string > Filenames;
+    std::set< std::string > LoadedBundles;
     if(FileIterator == nullptr){
         PrintError("FileIterator == nullptr\n");
         return false;
     }
     while((FileIterator != nullptr)&&(FileIterator->IsValid())){
-        std::string Filename = FileIterator->Name();
+        Filenames.push_back(FileIterator->Name());
         FileIterator->Next();
-        if(Filename.rfind(".map") == (Filename.length() - 4)){
+    }
+    // Compiled bundles are loaded first, the text map of the same name is the fallback
+    std::sort(Filenames.begin(), Filenames.end());
+    for(auto &Filename : Filenames){
+        int ExtensionLength = CMapBundle::DExtension.length();
+
+        if((Filename.length() > ExtensionLength)&&(Filename.rfind(CMapBundle::DExtension) == (Filename.length() - ExtensionLength))){
+            std::shared_ptr< CAssetDecoratedMap > TempMap = std::make_shared< CAssetDecoratedMap >();
+            CMapBundle Bundle;
+            std::string MapFilename = Filename.substr(0, Filename.length() - ExtensionLength) + ".map";
+
+            if(Bundle.Load(container->DataSource(Filename))){
+                CMapBundleReader Reader = Bundle.Reader();
+
+                if(std::binary_search(Filenames.begin(), Filenames.end(), MapFilename)&&(Bundle.SourceChecksum() != CMapBundle::Checksum(container->DataSource(MapFilename)))){
+                    PrintDebug(DEBUG_LOW,"Map bundle \"%s\" is out of date.\n",Filename.c_str());
+                    continue;
+                }
+
+                if(TempMap->LoadMap(Reader)){
+                    PrintDebug(DEBUG_LOW,"Loaded map bundle \"%s\".\n",Filename.c_str());
+                    LoadedBundles.insert(Filename.substr(0, Filename.length() - ExtensionLength));
+                    TempMap->RenderTerrain();
+                    DMapNameTranslation[TempMap->MapName()] = DAllMaps.size();
+                    DAllMaps.push_back(TempMap);
+                    continue;
+                }
+            }
+            PrintError("Failed to load map bundle \"%s\".\n",Filename.c_str());
+        }
+    }
+    for(auto &Filename : Filenames){
+        if((Filename.length() > 4)&&(Filename.rfind(".map") == (Filename.length() - 4))){
+            if(LoadedBundles.count(Filename.substr(0, Filename.length() - 4))){
+                continue;
+            }
             std::shared_ptr< CAssetDecoratedMap > TempMap = std::make_shared< CAssetDecoratedMap >();
 
             if(!TempMap->LoadMap(container->DataSource(Filename))){
@@ -623,8 +666,7 @@ bool CAssetDecoratedMap::LoadMap(std::shared_ptr< CDataSource > source){
     std::vector< std::string > Tokens;
     SResourceInitialization TempResourceInit;
     SAssetInitialization TempAssetInit;
-    int ResourceCount, AssetCount, InitialLumber = 400;
-    int InitialStone = 400;
+    int ResourceCount, AssetCount;
     bool ReturnStatus = false;
     
     if(!CTerrainMap::LoadMap(source)){
@@ -655,10 +697,6 @@ bool CAssetDecoratedMap::LoadMap(std::shared_ptr< CDataSource > source){
             TempResourceInit.DGold = std::stoi(Tokens[1]);
             TempResourceInit.DLumber = std::stoi(Tokens[2]);
             TempResourceInit.DStone = std::stoi(Tokens[3]);
-            if(EPlayerColor::None == TempResourceInit.DColor){
-                InitialLumber = TempResourceInit.DLumber;
-                InitialStone = TempResourceInit.DStone;
-            }
             
             DResourceInitializationList.push_back(TempResourceInit);
         }
@@ -696,33 +734,10 @@ bool CAssetDecoratedMap::LoadMap(std::shared_ptr< CDataSource > source){
             DAssetInitializationList.push_back(TempAssetInit);
         }
         
-        DLumberAvailable.resize(DTerrainMap.size());
-        for(int RowIndex = 0; RowIndex < DLumberAvailable.size(); RowIndex++){
-            DLumberAvailable[RowIndex].resize(DTerrainMap[RowIndex].size());
-            for(int ColIndex = 0; ColIndex < DTerrainMap[RowIndex].size(); ColIndex++){
-                if(ETerrainTileType::Forest == DTerrainMap[RowIndex][ColIndex]){
-                    DLumberAvailable[RowIndex][ColIndex] =  DPartials[RowIndex][ColIndex] ? InitialLumber : 0;
-                }
-                else{
-                    DLumberAvailable[RowIndex][ColIndex] =  0;
-                }
-            }
-        }
+        InitializeAvailableResources();
 
+        DTriggerHandlerIndex = CTriggerHandler::HandlerCount();
         CTriggerHandler::LoadTriggers(source);
-        
-        DStoneAvailable.resize(DTerrainMap.size());
-        for(int RowIndex = 0; RowIndex < DStoneAvailable.size(); RowIndex++){
-            DStoneAvailable[RowIndex].resize(DTerrainMap[RowIndex].size());
-            for(int ColIndex = 0; ColIndex < DTerrainMap[RowIndex].size(); ColIndex++){
-                if(ETerrainTileType::Rock == DTerrainMap[RowIndex][ColIndex]){
-                    DStoneAvailable[RowIndex][ColIndex] = DPartials[RowIndex][ColIndex] ? InitialStone : 0;
-                }
-                else{
-                    DStoneAvailable[RowIndex][ColIndex] =  0;
-                }
-            }
-        }
 
         ReturnStatus = true;
     }
@@ -735,6 +750,149 @@ LoadMapExit:
     
 }
 
+/**
+* Fills the available lumber and stone of the forest and rock tiles with
+* the initial amounts of the None entry of the resource initialization list
+*
+* @param[in] Nothing
+*
+* @return Nothing
+*
+*/
+
+void CAssetDecoratedMap::InitializeAvailableResources(){
+    int InitialLumber = 400;
+    int InitialStone = 400;
+
+    for(auto &ResourceInit : DResourceInitializationList){
+        if(EPlayerColor::None == ResourceInit.DColor){
+            InitialLumber = ResourceInit.DLumber;
+            InitialStone = ResourceInit.DStone;
+        }
+    }
+    DLumberAvailable.resize(DTerrainMap.size());
+    DStoneAvailable.resize(DTerrainMap.size());
+    for(int RowIndex = 0; RowIndex < DTerrainMap.size(); RowIndex++){
+        DLumberAvailable[RowIndex].resize(DTerrainMap[RowIndex].size());
+        DStoneAvailable[RowIndex].resize(DTerrainMap[RowIndex].size());
+        for(int ColIndex = 0; ColIndex < DTerrainMap[RowIndex].size(); ColIndex++){
+            if(ETerrainTileType::Forest == DTerrainMap[RowIndex][ColIndex]){
+                DLumberAvailable[RowIndex][ColIndex] =  DPartials[RowIndex][ColIndex] ? InitialLumber : 0;
+            }
+            else{
+                DLumberAvailable[RowIndex][ColIndex] =  0;
+            }
+            if(ETerrainTileType::Rock == DTerrainMap[RowIndex][ColIndex]){
+                DStoneAvailable[RowIndex][ColIndex] = DPartials[RowIndex][ColIndex] ? InitialStone : 0;
+            }
+            else{
+                DStoneAvailable[RowIndex][ColIndex] =  0;
+            }
+        }
+    }
+}
+
+/**
+* Loads the map from a compiled map bundle: terrain, resource and asset
+* initialization lists, then the triggers
+*
+* @param[in] reader Reader over the payload of a validated bundle
+*
+* @return true or false if loaded successfully or not
+*
+*/
+
+bool CAssetDecoratedMap::LoadMap(CMapBundleReader &reader){
+    SResourceInitialization TempResourceInit;
+    SAssetInitialization TempAssetInit;
+    int ResourceCount, AssetCount, Value;
+
+    if(!CTerrainMap::LoadMap(reader)){
+        PrintError("Invalid map bundle terrain.\n");
+        return false;
+    }
+    if(!reader.ReadInt(ResourceCount)||(0 > ResourceCount)){
+        PrintError("Failed to read map resource count.\n");
+        return false;
+    }
+    DResourceInitializationList.clear();
+    for(int Index = 0; Index <= ResourceCount; Index++){
+        if(!reader.ReadInt(Value)||!reader.ReadInt(TempResourceInit.DGold)||!reader.ReadInt(TempResourceInit.DLumber)||!reader.ReadInt(TempResourceInit.DStone)){
+            PrintError("Failed to read map resource %d.\n", Index);
+            return false;
+        }
+        TempResourceInit.DColor = static_cast<EPlayerColor>(Value);
+        if((0 == Index)&&(EPlayerColor::None != TempResourceInit.DColor)){
+            PrintError("Expected first resource to be for color None.\n");
+            return false;
+        }
+        DResourceInitializationList.push_back(TempResourceInit);
+    }
+    if(!reader.ReadInt(AssetCount)||(0 > AssetCount)){
+        PrintError("Failed to read map asset count.\n");
+        return false;
+    }
+    DAssetInitializationList.clear();
+    for(int Index = 0; Index < AssetCount; Index++){
+        int X, Y;
+
+        if(!reader.ReadString(TempAssetInit.DType)||!reader.ReadInt(Value)||!reader.ReadInt(X)||!reader.ReadInt(Y)){
+            PrintError("Failed to read map asset %d.\n", Index);
+            return false;
+        }
+        if((0 > X)||(0 > Y)||(Width() <= X)||(Height() <= Y)){
+            PrintError("Invalid asset position %d (%d, %d).\n", Index, X, Y);
+            return false;
+        }
+        TempAssetInit.DColor = static_cast<EPlayerColor>(Value);
+        TempAssetInit.DTilePosition.X(X);
+        TempAssetInit.DTilePosition.Y(Y);
+        DAssetInitializationList.push_back(TempAssetInit);
+    }
+    InitializeAvailableResources();
+
+    try{
+        DTriggerHandlerIndex = CTriggerHandler::HandlerCount();
+        if(!CTriggerHandler::LoadTriggers(reader)){
+            PrintError("Failed to read map triggers.\n");
+            return false;
+        }
+    }
+    catch(std::exception &E){
+        PrintError("%s\n",E.what());
+        return false;
+    }
+    return true;
+}
+
+/**
+* Writes the map to a map bundle, including the triggers loaded with it
+*
+* @param[in] writer The bundle being built
+*
+* @return Nothing
+*
+*/
+
+void CAssetDecoratedMap::SaveMap(CMapBundleWriter &writer) const{
+    CTerrainMap::SaveMap(writer);
+    writer.WriteInt(DResourceInitializationList.size() - 1);
+    for(auto &ResourceInit : DResourceInitializationList){
+        writer.WriteInt(to_underlying(ResourceInit.DColor));
+        writer.WriteInt(ResourceInit.DGold);
+        writer.WriteInt(ResourceInit.DLumber);
+        writer.WriteInt(ResourceInit.DStone);
+    }
+    writer.WriteInt(DAssetInitializationList.size());
+    for(auto &AssetInit : DAssetInitializationList){
+        writer.WriteString(AssetInit.DType);
+        writer.WriteInt(to_underlying(AssetInit.DColor));
+        writer.WriteInt(AssetInit.DTilePosition.X());
+        writer.WriteInt(AssetInit.DTilePosition.Y());
+    }
+    CTriggerHandler::SaveTriggers(DTriggerHandlerIndex, writer);
+}
+
 /**
 * Get function, return the list of assets DAssets 
 *
@@ -852,6 +1010,7 @@ bool CAssetDecoratedMap::UpdateMap(const CVisibilityMap &vismap, const CAssetDec
                 Cell = 0;
             }
         }
+        AllTilesChanged();
     }
     while(Iterator != DAssets.end()){
         CTilePosition CurPosition = (*Iterator)->TilePosition();
@@ -894,8 +1053,11 @@ bool CAssetDecoratedMap::UpdateMap(const CVisibilityMap &vismap, const CAssetDec
             //VisType = CVisibilityMap::ETileVisibility::Visible;
 
             if((CVisibilityMap::ETileVisibility::Partial == VisType)||(CVisibilityMap::ETileVisibility::PartialPartial == VisType)||(CVisibilityMap::ETileVisibility::Visible == VisType)){
-                DMap[YPos][XPos] = resmap.DMap[YPos][XPos];
-                DMapIndices[YPos][XPos] = resmap.DMapIndices[YPos][XPos];
+                if((DMap[YPos][XPos] != resmap.DMap[YPos][XPos])||(DMapIndices[YPos][XPos] != resmap.DMapIndices[YPos][XPos])){
+                    DMap[YPos][XPos] = resmap.DMap[YPos][XPos];
+                    DMapIndices[YPos][XPos] = resmap.DMapIndices[YPos][XPos];
+                    TileChanged(XPos, YPos);
+                }
             }
         }
     }
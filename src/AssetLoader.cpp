@@ -31,6 +31,7 @@
  *
  */
 #include "AssetLoader.h"
+#include <algorithm>
 
 /**
  * Constructor initializes protected data members with parameter values of the map
@@ -44,6 +45,220 @@ CAssetLoader::CAssetLoader(std::shared_ptr< CApplicationData> PassedAppData, std
     AppData = PassedAppData;
     TempDataContainer = PassedDataContainer;
     ImageDirectory = PassedImageDirectory;
+    DNextDecode = 0;
+    DNextHandOff = 0;
+    DStopWorkers = false;
+}
+
+/**
+ * Destructor stops the workers, jobs not yet handed off are dropped
+ *
+ * @param[in] None
+ *
+ * @return None
+*/
+CAssetLoader::~CAssetLoader(){
+    StopWorkers();
+}
+
+/**
+ * Queues a job, starting the workers on the first one. Jobs that have
+ * already been decoded are handed off so the splash screen keeps
+ * progressing while jobs are queued.
+ *
+ * @param[in] name Name of the asset used in the error message
+ * @param[in] decode Loads the asset on a worker, returns true on success
+ * @param[in] handoff Stores the asset in ApplicationData on the main thread
+ *
+ * @return None
+*/
+void CAssetLoader::QueueJob(const std::string &name, std::function< bool() > decode, std::function< void() > handoff){
+    {
+        std::lock_guard< std::mutex > Lock(DJobMutex);
+
+        DJobs.push_back(SLoadJob{name, decode, handoff, false, false});
+        if(DWorkers.empty()){
+            int WorkerCount = std::max< int >(1, std::thread::hardware_concurrency());
+
+            for(int Index = 0; Index < WorkerCount; Index++){
+                DWorkers.push_back(std::thread(&CAssetLoader::DecodeJobs, this));
+            }
+        }
+    }
+    DJobQueued.notify_one();
+    HandOffJobs(false);
+}
+
+/**
+ * Queues loading a tileset
+ *
+ * @param[in] name Name of the tileset used in the error message
+ * @param[in] filename Name of the tileset file in the image directory
+ * @param[in] clippingmasks Create the clipping masks of the tileset
+ * @param[in] handoff Stores the loaded tileset on the main thread
+ *
+ * @return None
+*/
+void CAssetLoader::QueueTileset(const std::string &name, const std::string &filename, bool clippingmasks, std::function< void(std::shared_ptr< CGraphicTileset >) > handoff){
+    auto Tileset = std::make_shared< CGraphicTileset >();
+    auto Directory = ImageDirectory;
+
+    QueueJob(name, [Tileset, Directory, filename, clippingmasks](){
+        if(!Tileset->LoadTileset(Directory->DataSource(filename))){
+            return false;
+        }
+        if(clippingmasks){
+            Tileset->CreateClippingMasks();
+        }
+        return true;
+    }, [Tileset, handoff](){
+        handoff(Tileset);
+    });
+}
+
+/**
+ * Queues loading a tileset recolored for each player color, the colors are
+ * recolored on first use and cached under the name of the tileset file
+ *
+ * @param[in] name Name of the tileset used in the error message
+ * @param[in] filename Name of the tileset file in the image directory
+ * @param[in] clippingmasks Create the clipping masks of the tileset
+ * @param[in] handoff Stores the loaded tileset on the main thread
+ *
+ * @return None
+*/
+void CAssetLoader::QueueMulticolorTileset(const std::string &name, const std::string &filename, bool clippingmasks, std::function< void(std::shared_ptr< CGraphicMulticolorTileset >) > handoff){
+    auto Tileset = std::make_shared< CGraphicMulticolorTileset >();
+    auto Directory = ImageDirectory;
+    auto RecolorMap = AppData->DPlayerRecolorMap;
+
+    Tileset->SetCache(AppData->DTilesetCacheContainer, filename.substr(0, filename.rfind('.')));
+    QueueJob(name, [Tileset, Directory, RecolorMap, filename, clippingmasks](){
+        if(!Tileset->LoadTileset(RecolorMap, Directory->DataSource(filename))){
+            return false;
+        }
+        if(clippingmasks){
+            Tileset->CreateClippingMasks();
+        }
+        return true;
+    }, [Tileset, handoff](){
+        handoff(Tileset);
+    });
+}
+
+/**
+ * Queues loading the tileset of an asset type, the clipping masks of asset
+ * tilesets are created by the workers as well
+ *
+ * @param[in] name Name of the tileset used in the error message
+ * @param[in] filename Name of the tileset file in the image directory
+ * @param[in] type The asset type
+ *
+ * @return None
+*/
+void CAssetLoader::QueueAssetTileset(const std::string &name, const std::string &filename, EAssetType type){
+    auto Data = AppData;
+
+    QueueMulticolorTileset(name, filename, true, [Data, type](std::shared_ptr< CGraphicMulticolorTileset > tileset){
+        Data->DAssetTilesets[to_underlying(type)] = tileset;
+    });
+}
+
+/**
+ * Worker loop, decodes jobs in the order they were queued until stopped
+ *
+ * @param[in] None
+ *
+ * @return None
+*/
+void CAssetLoader::DecodeJobs(){
+    std::unique_lock< std::mutex > Lock(DJobMutex);
+
+    while(true){
+        DJobQueued.wait(Lock, [this](){
+            return DStopWorkers || (DNextDecode < DJobs.size());
+        });
+        if(DStopWorkers){
+            return;
+        }
+        // References to deque elements stay valid while more are queued
+        SLoadJob &Job = DJobs[DNextDecode++];
+
+        Lock.unlock();
+        bool Success = Job.DDecode();
+        Lock.lock();
+        Job.DSuccess = Success;
+        Job.DDone = true;
+        DJobDecoded.notify_all();
+    }
+}
+
+/**
+ * Hands off decoded jobs in the order they were queued, rendering a splash
+ * step for each
+ *
+ * @param[in] wait Wait for all queued jobs to be decoded
+ *
+ * @return None
+*/
+void CAssetLoader::HandOffJobs(bool wait){
+    std::unique_lock< std::mutex > Lock(DJobMutex);
+
+    while(DNextHandOff < DJobs.size()){
+        SLoadJob &Job = DJobs[DNextHandOff];
+
+        if(!Job.DDone){
+            if(!wait){
+                break;
+            }
+            DJobDecoded.wait(Lock, [&Job](){
+                return Job.DDone;
+            });
+        }
+        DNextHandOff++;
+        Lock.unlock();
+        if(Job.DSuccess){
+            Job.DHandOff();
+        }
+        else{
+            PrintError("Failed to load %s.\n", Job.DName.c_str());
+        }
+        AppData->RenderSplashStep();
+        Lock.lock();
+    }
+}
+
+/**
+ * Stops and joins the workers
+ *
+ * @param[in] None
+ *
+ * @return None
+*/
+void CAssetLoader::StopWorkers(){
+    {
+        std::lock_guard< std::mutex > Lock(DJobMutex);
+
+        DStopWorkers = true;
+    }
+    DJobQueued.notify_all();
+    for(auto &Worker : DWorkers){
+        Worker.join();
+    }
+    DWorkers.clear();
+}
+
+/**
+ * Waits for all queued assets to load and hands them off to
+ * ApplicationData, must be called before any of them is used
+ *
+ * @param[in] None
+ *
+ * @return None
+*/
+void CAssetLoader::Finish(){
+    HandOffJobs(true);
+    StopWorkers();
 }
 
 /**
@@ -54,14 +269,12 @@ CAssetLoader::CAssetLoader(std::shared_ptr< CApplicationData> PassedAppData, std
  * @return None
 */
 void CAssetLoader::LoadIconAsset(){
+    auto Data = AppData;
+
     PrintDebug(DEBUG_LOW, "Loading Icons\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("Icons.dat");
-    AppData->DIconTileset = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DIconTileset->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load icons.\n");
-        return;
-    }
+    QueueMulticolorTileset("icons", "Icons.dat", false, [Data](std::shared_ptr< CGraphicMulticolorTileset > tileset){
+        Data->DIconTileset = tileset;
+    });
 }
 
 /**
@@ -72,17 +285,14 @@ void CAssetLoader::LoadIconAsset(){
  * @return None
 */
 void CAssetLoader::LoadMiniIcons(){
+    auto Data = AppData;
+
     PrintDebug(DEBUG_LOW, "Loading Mini Icons\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("MiniIcons.dat");
-    AppData->DMiniIconTileset = std::make_shared< CGraphicTileset > ();
-    if(!AppData->DMiniIconTileset->LoadTileset(TempDataSource)){
-        PrintError("Failed to load mini icons.\n");
-        return;
-    }
+    QueueTileset("mini icons", "MiniIcons.dat", false, [Data](std::shared_ptr< CGraphicTileset > tileset){
+        Data->DMiniIconTileset = tileset;
+    });
 }
 
-
 /**
  * Loads the corpse image asset into ApplicationData
  *
@@ -91,15 +301,12 @@ void CAssetLoader::LoadMiniIcons(){
  * @return None
 */
 void CAssetLoader::LoadCorpse(){
+    auto Data = AppData;
+
     PrintDebug(DEBUG_LOW, "Loading Corpse\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("Corpse.dat");
-    AppData->DCorpseTileset = std::make_shared< CGraphicTileset > ();
-    if(!AppData->DCorpseTileset->LoadTileset(TempDataSource)){
-        PrintError("Failed to load corpse tileset.\n");
-        return;
-    }
-    AppData->DCorpseTileset->CreateClippingMasks();
+    QueueTileset("corpse tileset", "Corpse.dat", true, [Data](std::shared_ptr< CGraphicTileset > tileset){
+        Data->DCorpseTileset = tileset;
+    });
 }
 
 /**
@@ -110,16 +317,12 @@ void CAssetLoader::LoadCorpse(){
  * @return None
 */
 void CAssetLoader::LoadFireSmall(){
+    auto Data = AppData;
+
     PrintDebug(DEBUG_LOW, "Loading FireSmall\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("FireSmall.dat");
-    auto FireTileset = std::make_shared< CGraphicTileset > ();
-    if(!FireTileset->LoadTileset(TempDataSource)){
-        PrintError("Failed to load fire small tileset.\n");
-        return;
-    }
-    FireTileset->CreateClippingMasks();
-    AppData->DFireTilesets.push_back(FireTileset);
+    QueueTileset("fire small tileset", "FireSmall.dat", true, [Data](std::shared_ptr< CGraphicTileset > tileset){
+        Data->DFireTilesets.push_back(tileset);
+    });
 }
 
 /**
@@ -130,16 +333,12 @@ void CAssetLoader::LoadFireSmall(){
  * @return None
 */
 void CAssetLoader::LoadFireLarge(){
+    auto Data = AppData;
+
     PrintDebug(DEBUG_LOW, "Loading FireLarge\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("FireLarge.dat");
-    auto FireTileset = std::make_shared< CGraphicTileset > ();
-    if(!FireTileset->LoadTileset(TempDataSource)){
-        PrintError("Failed to load fire large tileset.\n");
-        return;
-    }
-    FireTileset->CreateClippingMasks();
-    AppData->DFireTilesets.push_back(FireTileset);
+    QueueTileset("fire large tileset", "FireLarge.dat", true, [Data](std::shared_ptr< CGraphicTileset > tileset){
+        Data->DFireTilesets.push_back(tileset);
+    });
 }
 
 /**
@@ -150,15 +349,12 @@ void CAssetLoader::LoadFireLarge(){
  * @return None
 */
 void CAssetLoader::LoadBuildingDeath(){
+    auto Data = AppData;
+
     PrintDebug(DEBUG_LOW, "Loading BuildingDeath\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("BuildingDeath.dat");
-    AppData->DBuildingDeathTileset = std::make_shared< CGraphicTileset > ();
-    if(!AppData->DBuildingDeathTileset->LoadTileset(TempDataSource)){
-        PrintError("Failed to load building death tileset.\n");
-        return;
-    }
-    AppData->DBuildingDeathTileset->CreateClippingMasks();
+    QueueTileset("building death tileset", "BuildingDeath.dat", true, [Data](std::shared_ptr< CGraphicTileset > tileset){
+        Data->DBuildingDeathTileset = tileset;
+    });
 }
 
 /**
@@ -169,14 +365,12 @@ void CAssetLoader::LoadBuildingDeath(){
  * @return None
 */
 void CAssetLoader::LoadArrow(){
+    auto Data = AppData;
+
     PrintDebug(DEBUG_LOW, "Loading Arrow\n");
-    TempDataSource = ImageDirectory->DataSource("Arrow.dat");
-    AppData->DArrowTileset = std::make_shared< CGraphicTileset > ();
-    if(!AppData->DArrowTileset->LoadTileset(TempDataSource)){
-        PrintError("Failed to load arrow tileset.\n");
-        return;
-    }
-    AppData->DArrowTileset->CreateClippingMasks();
+    QueueTileset("arrow tileset", "Arrow.dat", true, [Data](std::shared_ptr< CGraphicTileset > tileset){
+        Data->DArrowTileset = tileset;
+    });
 }
 
 /**
@@ -187,15 +381,17 @@ void CAssetLoader::LoadArrow(){
  * @return None
 */
 void CAssetLoader::LoadAssetColor(){
+    auto Data = AppData;
+    auto RecolorMap = std::make_shared< CGraphicRecolorMap > ();
+    auto Directory = ImageDirectory;
+
     PrintDebug(DEBUG_LOW, "Loading AssetColor\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("AssetColor.dat");
-    AppData->DAssetRecolorMap = std::make_shared< CGraphicRecolorMap > ();
-    if(!AppData->DAssetRecolorMap->Load(TempDataSource)){
-        PrintError("Failed to load asset color map.\n");
-        return;
-    }
-    AppData->DAssetTilesets[to_underlying(EAssetType::None)] = nullptr;
+    QueueJob("asset color map", [RecolorMap, Directory](){
+        return RecolorMap->Load(Directory->DataSource("AssetColor.dat"));
+    }, [Data, RecolorMap](){
+        Data->DAssetRecolorMap = RecolorMap;
+        Data->DAssetTilesets[to_underlying(EAssetType::None)] = nullptr;
+    });
 }
 
 /**
@@ -207,13 +403,7 @@ void CAssetLoader::LoadAssetColor(){
 */
 void CAssetLoader::LoadPeasant(){
     PrintDebug(DEBUG_LOW, "Loading Peasant\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("Peasant.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::Peasant)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::Peasant)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load peasant tileset.\n");
-        return;
-    }
+    QueueAssetTileset("peasant tileset", "Peasant.dat", EAssetType::Peasant);
 }
 
 /**
@@ -225,13 +415,7 @@ void CAssetLoader::LoadPeasant(){
 */
 void CAssetLoader::LoadFootman(){
     PrintDebug(DEBUG_LOW, "Loading Footman\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("Footman.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::Footman)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::Footman)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load footman tileset.\n");
-        return;
-    }
+    QueueAssetTileset("footman tileset", "Footman.dat", EAssetType::Footman);
 }
 
 /**
@@ -243,13 +427,7 @@ void CAssetLoader::LoadFootman(){
 */
 void CAssetLoader::LoadArcher(){
     PrintDebug(DEBUG_LOW, "Loading Archer\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("Archer.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::Archer)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::Archer)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load archer tileset.\n");
-        return;
-    }
+    QueueAssetTileset("archer tileset", "Archer.dat", EAssetType::Archer);
 }
 
 /**
@@ -261,13 +439,7 @@ void CAssetLoader::LoadArcher(){
 */
 void CAssetLoader::LoadRanger(){
     PrintDebug(DEBUG_LOW, "Loading Ranger\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("Ranger.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::Ranger)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::Ranger)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load archer tileset.\n");
-        return;
-    }
+    QueueAssetTileset("ranger tileset", "Ranger.dat", EAssetType::Ranger);
 }
 
 /**
@@ -279,13 +451,7 @@ void CAssetLoader::LoadRanger(){
 */
 void CAssetLoader::LoadGoldMine(){
     PrintDebug(DEBUG_LOW, "Loading GoldMine\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("GoldMine.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::GoldMine)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::GoldMine)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load gold mine tileset.\n");
-        return;
-    }
+    QueueAssetTileset("gold mine tileset", "GoldMine.dat", EAssetType::GoldMine);
 }
 
 /**
@@ -297,13 +463,7 @@ void CAssetLoader::LoadGoldMine(){
 */
 void CAssetLoader::LoadTownHall(){
     PrintDebug(DEBUG_LOW, "Loading TownHall\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("TownHall.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::TownHall)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::TownHall)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load town hall tileset.\n");
-        return;
-    }
+    QueueAssetTileset("town hall tileset", "TownHall.dat", EAssetType::TownHall);
 }
 
 /**
@@ -315,13 +475,7 @@ void CAssetLoader::LoadTownHall(){
 */
 void CAssetLoader::LoadKeep(){
     PrintDebug(DEBUG_LOW, "Loading Keep\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("Keep.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::Keep)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::Keep)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load keep tileset.\n");
-        return;
-    }
+    QueueAssetTileset("keep tileset", "Keep.dat", EAssetType::Keep);
 }
 
 /**
@@ -333,13 +487,7 @@ void CAssetLoader::LoadKeep(){
 */
 void CAssetLoader::LoadCastle(){
     PrintDebug(DEBUG_LOW, "Loading Castle\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("Castle.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::Castle)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::Castle)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load castle tileset.\n");
-        return;
-    }
+    QueueAssetTileset("castle tileset", "Castle.dat", EAssetType::Castle);
 }
 
 /**
@@ -351,13 +499,19 @@ void CAssetLoader::LoadCastle(){
 */
 void CAssetLoader::LoadFarm(){
     PrintDebug(DEBUG_LOW, "Loading Farm\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("Farm.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::Farm)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::Farm)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load farm tileset.\n");
-        return;
-    }
+    QueueAssetTileset("farm tileset", "Farm.dat", EAssetType::Farm);
+}
+
+/**
+ * Loads the wall asset into ApplicationData
+ *
+ * @param[in] None
+ *
+ * @return None
+*/
+void CAssetLoader::LoadWall(){
+    PrintDebug(DEBUG_LOW, "Loading Wall\n");
+    QueueAssetTileset("wall tileset", "Wall.dat", EAssetType::Wall);
 }
 
 /**
@@ -369,13 +523,7 @@ void CAssetLoader::LoadFarm(){
 */
 void CAssetLoader::LoadBarracks(){
     PrintDebug(DEBUG_LOW, "Loading Barracks\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("Barracks.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::Barracks)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::Barracks)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load barracks tileset.\n");
-        return;
-    }
+    QueueAssetTileset("barracks tileset", "Barracks.dat", EAssetType::Barracks);
 }
 
 /**
@@ -387,13 +535,7 @@ void CAssetLoader::LoadBarracks(){
 */
 void CAssetLoader::LoadBlacksmith(){
     PrintDebug(DEBUG_LOW, "Loading Blacksmith\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("Blacksmith.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::Blacksmith)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::Blacksmith)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load blacksmith tileset.\n");
-        return;
-    }
+    QueueAssetTileset("blacksmith tileset", "Blacksmith.dat", EAssetType::Blacksmith);
 }
 
 /**
@@ -405,13 +547,7 @@ void CAssetLoader::LoadBlacksmith(){
 */
 void CAssetLoader::LoadLumberMill(){
     PrintDebug(DEBUG_LOW, "Loading LumberMill\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("LumberMill.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::LumberMill)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::LumberMill)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load lumber mill tileset.\n");
-        return;
-    }
+    QueueAssetTileset("lumber mill tileset", "LumberMill.dat", EAssetType::LumberMill);
 }
 
 /**
@@ -423,16 +559,9 @@ void CAssetLoader::LoadLumberMill(){
 */
 void CAssetLoader::LoadScoutTower(){
     PrintDebug(DEBUG_LOW, "Loading ScoutTower\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("ScoutTower.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::ScoutTower)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::ScoutTower)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load scout tower tileset.\n");
-        return;
-    }
+    QueueAssetTileset("scout tower tileset", "ScoutTower.dat", EAssetType::ScoutTower);
 }
 
-
 /**
  * Loads the guard tower asset into ApplicationData
  *
@@ -442,13 +571,7 @@ void CAssetLoader::LoadScoutTower(){
 */
 void CAssetLoader::LoadGuardTower(){
     PrintDebug(DEBUG_LOW, "Loading GuardTower\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("GuardTower.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::GuardTower)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::GuardTower)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load guard tower tileset.\n");
-        return;
-    }
+    QueueAssetTileset("guard tower tileset", "GuardTower.dat", EAssetType::GuardTower);
 }
 
 /**
@@ -460,12 +583,5 @@ void CAssetLoader::LoadGuardTower(){
 */
 void CAssetLoader::LoadCannonTower(){
     PrintDebug(DEBUG_LOW, "Loading CannonTower\n");
-    AppData->RenderSplashStep();
-    TempDataSource = ImageDirectory->DataSource("CannonTower.dat");
-    AppData->DAssetTilesets[to_underlying(EAssetType::CannonTower)] = std::make_shared< CGraphicMulticolorTileset > ();
-    if(!AppData->DAssetTilesets[to_underlying(EAssetType::CannonTower)]->LoadTileset(AppData->DPlayerRecolorMap, TempDataSource)){
-        PrintError("Failed to load cannon tower tileset.\n");
-        return;
-    }
+    QueueAssetTileset("cannon tower tileset", "CannonTower.dat", EAssetType::CannonTower);
 }
-
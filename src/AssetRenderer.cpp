@@ -36,8 +36,11 @@
 
 #include "AssetRenderer.h"
 #include "PixelType.h"
+#include "PixelBlend.h"
 #include "Debug.h"
 #include <algorithm>
+#include <cstdlib>
+#include <array>
 #include <iostream>
 
 #define TARGET_FREQUENCY        10
@@ -68,6 +71,8 @@ CAssetRenderer::CAssetRenderer(std::shared_ptr< CGraphicRecolorMap > colors, std
     DArrowTileset = arrowtileset;
     DPlayerData = player;
     DPlayerMap = map;
+    DRenderRect = SRectangle{0, 0, 0, 0};
+    DInterpolation = 1.0;
     
     DPixelColors.resize(to_underlying(EPlayerColor::Max) + 3);
     DPixelColors[to_underlying(EPlayerColor::None)] = colors->ColorValue(colors->FindColor("none"), 0);
@@ -349,51 +354,126 @@ int CAssetRenderer::UpdateFrequency(int freq){
     return freq;
 }
 
-using SAssetRenderData = struct ASSETRENDERERDATA_TAG{
-    EAssetType DType;
-    int DX;
-    int DY;
-    int DBottomY;
-    int DTileIndex;
-    int DColorIndex;
-    uint32_t DPixelColor;
-};
+/**
+ * Position an asset is drawn at, between its position before the last
+ * timestep and its current one by the interpolation. Assets that moved
+ * further than a tile were placed rather than walked, and are drawn at
+ * their current position.
+ *
+ * @param[in] asset The asset being drawn
+ *
+ * @return The pixel position to draw the asset at
+ */
+CPixelPosition CAssetRenderer::DrawnPosition(std::shared_ptr< CPlayerAsset > asset) const{
+    CPixelPosition Current = asset->Position();
+    CPixelPosition Previous = asset->PreviousPosition();
+    int DeltaX = Current.X() - Previous.X();
+    int DeltaY = Current.Y() - Previous.Y();
+
+    if((1.0 <= DInterpolation)||(CPosition::TileWidth() < std::abs(DeltaX))||(CPosition::TileHeight() < std::abs(DeltaY))){
+        return Current;
+    }
+    return CPixelPosition(Previous.X() + static_cast<int>(DeltaX * DInterpolation), Previous.Y() + static_cast<int>(DeltaY * DInterpolation));
+}
+
+/**
+ * Sorts the render queue into the order assets are drawn, by bottom Y and
+ * then type, with an LSD radix sort over 8 bit digits of the sort key. The
+ * sort is stable, and digits that are the same for all assets are skipped.
+ *
+ * @return None
+ */
+void CAssetRenderer::SortRenderQueue(){
+    DRenderScratch.resize(DRenderQueue.size());
+    for(int Shift = 0; Shift < 32; Shift += 8){
+        std::array< size_t, 257 > Offsets;
+        bool SingleDigit = false;
+        
+        Offsets.fill(0);
+        for(auto &RenderData : DRenderQueue){
+            Offsets[((RenderKey(RenderData) >> Shift) & 0xFF) + 1]++;
+        }
+        for(int Digit = 1; Digit < 257; Digit++){
+            SingleDigit |= Offsets[Digit] == DRenderQueue.size();
+            Offsets[Digit] += Offsets[Digit - 1];
+        }
+        if(SingleDigit){
+            continue;
+        }
+        for(auto &RenderData : DRenderQueue){
+            DRenderScratch[Offsets[(RenderKey(RenderData) >> Shift) & 0xFF]++] = RenderData;
+        }
+        DRenderQueue.swap(DRenderScratch);
+    }
+}
 
 /**
- * Used to determine the order in which assets should be rendered by
- * comparing them two at a time
+ * Blends an asset tile from the colored tileset of its color directly into
+ * locked surface pixels, limited to the bounds of the tile's non transparent
+ * pixels and clipped to the surface.
  *
- * @param[in] first Data from first asset to be compared
- * @param[in[ second Data from second asset to be compared
+ * @param[in] pixels The locked pixels of the surface
+ * @param[in] stride Bytes per row of pixels
+ * @param[in] width Width of the surface
+ * @param[in] height Height of the surface
+ * @param[in] renderdata The asset tile to draw
  *
- * @return True if first is rendered first, false otherwise
+ * @return True if drawn, false if its colored tileset has no ARGB32 pixels
  */
-bool CompareRenderData(const SAssetRenderData &first, const SAssetRenderData &second){
-    if(first.DBottomY < second.DBottomY){
-        return true;   
+bool CAssetRenderer::BlitAsset(uint8_t *pixels, int stride, int width, int height, const SAssetRenderData &renderdata){
+    auto &Tileset = DTilesets[to_underlying(renderdata.DType)];
+    int AtlasIndex = to_underlying(renderdata.DType) * to_underlying(EPlayerColor::Max) + renderdata.DColorIndex;
+    
+    if((0 > renderdata.DColorIndex)||(renderdata.DColorIndex >= Tileset->ColorCount())){
+        return true;
     }
-    if(first.DBottomY > second.DBottomY){
-        return false;        
+    if(!DAtlasPixels[AtlasIndex]){
+        auto Atlas = Tileset->ColoredTileset(renderdata.DColorIndex);
+        
+        if(!Atlas||(CGraphicSurface::ESurfaceFormat::ARGB32 != Atlas->Format())){
+            return false;
+        }
+        DAtlasPixels[AtlasIndex] = Atlas->LockPixels(DAtlasStrides[AtlasIndex]);
+        if(!DAtlasPixels[AtlasIndex]){
+            return false;
+        }
+        DLockedAtlases.push_back(Atlas);
     }
+    const SRectangle &Bounds = Tileset->TileBounds(renderdata.DTileIndex);
+    int Left = std::max(0, renderdata.DX + Bounds.DXPosition);
+    int Top = std::max(0, renderdata.DY + Bounds.DYPosition);
+    int Right = std::min(width, renderdata.DX + Bounds.DXPosition + Bounds.DWidth);
+    int Bottom = std::min(height, renderdata.DY + Bounds.DYPosition + Bounds.DHeight);
+    const uint8_t *TilePixels = DAtlasPixels[AtlasIndex] + DAtlasStrides[AtlasIndex] * renderdata.DTileIndex * Tileset->TileHeight();
     
-    return first.DX <= second.DX;
+    for(int YPos = Top; YPos < Bottom; YPos++){
+        const uint32_t *Source = (const uint32_t *)(TilePixels + DAtlasStrides[AtlasIndex] * (YPos - renderdata.DY));
+        
+        CPixelBlend::Over((uint32_t *)(pixels + stride * YPos) + Left, Source + (Left - renderdata.DX), Right - Left);
+    }
+    return true;
 }
 
 /**
  * Used to render assets on the map after establishing the order
  * in which they should be rendered.
  *
+ * The assets are queued, sorted by SortRenderQueue and blended straight
+ * into the pixels of the surface from the colored tilesets, which serve as
+ * per color sprite atlases. The render queue is kept for PixelType.
+ *
  * @param[in] surface The ground tileset, new assets are rendered on top of this
- * @param[in] typesurface For use with GraphicFactoryCairo surface creation function
  * @param[in] rect The area of the screen on which rendering will occur
  *
  * @return None
  *
  */
-void CAssetRenderer::DrawAssets(std::shared_ptr<CGraphicSurface> surface, std::shared_ptr<CGraphicSurface> typesurface, const SRectangle &rect){
+void CAssetRenderer::DrawAssets(std::shared_ptr<CGraphicSurface> surface, const SRectangle &rect){
     int ScreenRightX = rect.DXPosition + rect.DWidth - 1;
     int ScreenBottomY = rect.DYPosition + rect.DHeight - 1;
-    std::list< SAssetRenderData > FinalRenderList;
+    
+    DRenderQueue.clear();
+    DRenderRect = rect;
     
     for(auto &AssetIterator : DPlayerMap->Assets()){
         SAssetRenderData TempRenderData;
@@ -404,8 +484,9 @@ void CAssetRenderer::DrawAssets(std::shared_ptr<CGraphicSurface> surface, std::s
         if((0 <= to_underlying(TempRenderData.DType))&&(to_underlying(TempRenderData.DType) < static_cast<int>(DTilesets.size()))){
             CPixelType PixelType(*AssetIterator); 
             int RightX;
-            TempRenderData.DX = AssetIterator->PositionX() + (AssetIterator->Size() - 1) * CPosition::HalfTileWidth() - DTilesets[to_underlying(TempRenderData.DType)]->TileHalfWidth();
-            TempRenderData.DY = AssetIterator->PositionY() + (AssetIterator->Size() - 1) * CPosition::HalfTileHeight() - DTilesets[to_underlying(TempRenderData.DType)]->TileHalfHeight();
+            CPixelPosition DrawPosition = DrawnPosition(AssetIterator);
+            TempRenderData.DX = DrawPosition.X() + (AssetIterator->Size() - 1) * CPosition::HalfTileWidth() - DTilesets[to_underlying(TempRenderData.DType)]->TileHalfWidth();
+            TempRenderData.DY = DrawPosition.Y() + (AssetIterator->Size() - 1) * CPosition::HalfTileHeight() - DTilesets[to_underlying(TempRenderData.DType)]->TileHalfHeight();
             TempRenderData.DPixelColor = PixelType.ToPixelColor();
 
             RightX = TempRenderData.DX + DTilesets[to_underlying(TempRenderData.DType)]->TileWidth() - 1;
@@ -540,21 +621,77 @@ void CAssetRenderer::DrawAssets(std::shared_ptr<CGraphicSurface> surface, std::s
                     default:                            break;
                 }
                 if(0 <= TempRenderData.DTileIndex){
-                    FinalRenderList.push_back(TempRenderData);
+                    DRenderQueue.push_back(TempRenderData);
                 }
             }
         }
     }
-    FinalRenderList.sort(CompareRenderData);
-    for(auto &RenderIterator : FinalRenderList){
+    SortRenderQueue();
+    
+    int Stride;
+    uint8_t *Pixels = nullptr;
+    
+    if(CGraphicSurface::ESurfaceFormat::ARGB32 == surface->Format()){
+        Pixels = surface->LockPixels(Stride);
+    }
+    DAtlasPixels.assign(DTilesets.size() * to_underlying(EPlayerColor::Max), nullptr);
+    DAtlasStrides.assign(DAtlasPixels.size(), 0);
+    for(auto &RenderIterator : DRenderQueue){
         if(RenderIterator.DTileIndex < DTilesets[to_underlying(RenderIterator.DType)]->TileCount()){
+            if(Pixels && BlitAsset(Pixels, Stride, surface->Width(), surface->Height(), RenderIterator)){
+                continue;
+            }
+            if(Pixels){
+                surface->UnlockPixels();
+            }
             DTilesets[to_underlying(RenderIterator.DType)]->DrawTile(surface, RenderIterator.DX, RenderIterator.DY, RenderIterator.DTileIndex, RenderIterator.DColorIndex);
-            DTilesets[to_underlying(RenderIterator.DType)]->DrawClipped(typesurface, RenderIterator.DX, RenderIterator.DY, RenderIterator.DTileIndex, RenderIterator.DPixelColor);
         }
         else{
+            if(Pixels){
+                surface->UnlockPixels();
+            }
             DBuildingDeathTileset->DrawTile(surface, RenderIterator.DX, RenderIterator.DY, RenderIterator.DTileIndex);
         }
+        if(Pixels){
+            Pixels = surface->LockPixels(Stride);
+        }
+    }
+    if(Pixels){
+        surface->UnlockPixels();
+    }
+    for(auto &Atlas : DLockedAtlases){
+        Atlas->UnlockPixels();
+    }
+    DLockedAtlases.clear();
+}
+
+/**
+ * Finds the asset drawn at a position by the last DrawAssets, testing the
+ * clipping masks of the drawn tiles from the top most asset down.
+ *
+ * @param[in] xpos X position on the detailed map
+ * @param[in] ypos Y position on the detailed map
+ * @param[out] pixeltype The pixel type of the asset at the position
+ *
+ * @return True if an asset was drawn at the position, false otherwise
+ *
+ */
+bool CAssetRenderer::PixelType(int xpos, int ypos, CPixelType &pixeltype) const{
+    int XPos = xpos - DRenderRect.DXPosition;
+    int YPos = ypos - DRenderRect.DYPosition;
+    
+    for(auto RenderIterator = DRenderQueue.rbegin(); RenderIterator != DRenderQueue.rend(); RenderIterator++){
+        auto &Tileset = DTilesets[to_underlying(RenderIterator->DType)];
+        
+        if(RenderIterator->DTileIndex >= Tileset->TileCount()){
+            continue;
+        }
+        if(Tileset->ClippedPixel(RenderIterator->DTileIndex, XPos - RenderIterator->DX, YPos - RenderIterator->DY)){
+            pixeltype = CPixelType((RenderIterator->DPixelColor>>16) & 0xFF, (RenderIterator->DPixelColor>>8) & 0xFF, RenderIterator->DPixelColor & 0xFF);
+            return true;
+        }
     }
+    return false;
 }
 
 /**
@@ -706,9 +843,10 @@ void CAssetRenderer::DrawSelections(std::shared_ptr<CGraphicSurface> surface, co
             else if((0 <= to_underlying(TempRenderData.DType))&&(to_underlying(TempRenderData.DType) < DTilesets.size())){
                 int RightX, RectWidth, RectHeight;
                 bool OnScreen = true;
+                CPixelPosition DrawPosition = DrawnPosition(LockedAsset);
                 
-                TempRenderData.DX = LockedAsset->PositionX() - CPosition::HalfTileWidth();
-                TempRenderData.DY = LockedAsset->PositionY() - CPosition::HalfTileHeight();
+                TempRenderData.DX = DrawPosition.X() - CPosition::HalfTileWidth();
+                TempRenderData.DY = DrawPosition.Y() - CPosition::HalfTileHeight();
                 RectWidth = CPosition::TileWidth() * LockedAsset->Size();
                 RectHeight = CPosition::TileHeight() * LockedAsset->Size();
                 RightX = TempRenderData.DX + RectWidth;
@@ -754,9 +892,10 @@ void CAssetRenderer::DrawOverlays(std::shared_ptr<CGraphicSurface> surface, cons
             if(EAssetAction::Attack == AssetIterator->Action()){
                 int RightX;
                 bool OnScreen = true;
+                CPixelPosition DrawPosition = DrawnPosition(AssetIterator);
                 
-                TempRenderData.DX = AssetIterator->PositionX() - DArrowTileset->TileWidth()/2;
-                TempRenderData.DY = AssetIterator->PositionY() - DArrowTileset->TileHeight()/2;
+                TempRenderData.DX = DrawPosition.X() - DArrowTileset->TileWidth()/2;
+                TempRenderData.DY = DrawPosition.Y() - DArrowTileset->TileHeight()/2;
                 RightX = TempRenderData.DX + DArrowTileset->TileWidth();
                 TempRenderData.DBottomY = TempRenderData.DY + DArrowTileset->TileHeight();
                 
@@ -948,7 +1087,8 @@ void CAssetRenderer::DrawPlacement(std::shared_ptr<CGraphicSurface> surface, con
 
 /**
  * Used to render assets on the mini map corresponding to assets rendered
- * on the actual map
+ * on the actual map, filling the tiles of each asset directly in the pixels
+ * of the surface
  *
  * @param[in] surface The surface on which minimap assets are rendered
  *
@@ -956,28 +1096,59 @@ void CAssetRenderer::DrawPlacement(std::shared_ptr<CGraphicSurface> surface, con
  *
  */
 void CAssetRenderer::DrawMiniAssets(std::shared_ptr<CGraphicSurface> surface){
-    auto ResourceContext = surface->CreateResourceContext();
+    int Stride;
+    
+    if((CGraphicSurface::ESurfaceFormat::ARGB32 != surface->Format())&&(CGraphicSurface::ESurfaceFormat::RGB24 != surface->Format())){
+        return;
+    }
+    uint8_t *Pixels = surface->LockPixels(Stride);
+    if(!Pixels){
+        return;
+    }
     if(nullptr != DPlayerData){
         for(auto &AssetIterator : DPlayerMap->Assets()){
             EPlayerColor AssetColor = AssetIterator->Color();
-            int Size = AssetIterator->Size();
             if(AssetColor == DPlayerData->Color()){
                 AssetColor = EPlayerColor::Max;
             }
-            ResourceContext->SetSourceRGB(DPixelColors[to_underlying(AssetColor)]);
-            ResourceContext->Rectangle(AssetIterator->TilePositionX(), AssetIterator->TilePositionY(), Size, Size);
-            ResourceContext->Fill();
+            FillMiniAsset(Pixels, Stride, surface->Width(), surface->Height(), AssetIterator->TilePositionX(), AssetIterator->TilePositionY(), AssetIterator->Size(), DPixelColors[to_underlying(AssetColor)]);
         }
     }
     else{
         for(auto &AssetIterator : DPlayerMap->AssetInitializationList()){
-            EPlayerColor AssetColor = AssetIterator.DColor;
             int Size = CPlayerAssetType::FindDefaultFromName(AssetIterator.DType)->Size();
 
-            ResourceContext->SetSourceRGB(DPixelColors[to_underlying(AssetColor)]);
-            ResourceContext->Rectangle(AssetIterator.DTilePosition.X(), AssetIterator.DTilePosition.Y(), Size, Size);
-            ResourceContext->Fill();
+            FillMiniAsset(Pixels, Stride, surface->Width(), surface->Height(), AssetIterator.DTilePosition.X(), AssetIterator.DTilePosition.Y(), Size, DPixelColors[to_underlying(AssetIterator.DColor)]);
         }
     }
+    surface->UnlockPixels();
+}
+
+/**
+ * Fills the square of an asset in minimap pixels, clipped to the minimap
+ *
+ * @param[in] pixels The locked pixels of the minimap surface
+ * @param[in] stride Bytes per row of pixels
+ * @param[in] width Width of the minimap surface
+ * @param[in] height Height of the minimap surface
+ * @param[in] xpos X tile position of the asset
+ * @param[in] ypos Y tile position of the asset
+ * @param[in] size Size of the asset in tiles
+ * @param[in] rgb Color of the asset
+ *
+ * @return None
+ *
+ */
+void CAssetRenderer::FillMiniAsset(uint8_t *pixels, int stride, int width, int height, int xpos, int ypos, int size, uint32_t rgb){
+    int Left = std::max(0, xpos);
+    int Top = std::max(0, ypos);
+    int Right = std::min(width, xpos + size);
+    int Bottom = std::min(height, ypos + size);
+    
+    for(int YPos = Top; YPos < Bottom; YPos++){
+        uint32_t *Pixel = (uint32_t *)(pixels + YPos * stride);
+        
+        std::fill(Pixel + Left, Pixel + std::max(Left, Right), 0xFF000000 | rgb);
+    }
 }
 
@@ -300,7 +300,7 @@ void CBattleMode::Input(std::shared_ptr< CApplicationData > context){
     if(CApplicationData::uictViewport == ComponentType){
         CPixelPosition TempPosition(context->ScreenToDetailedMap(CPixelPosition(CurrentX, CurrentY)));
         CPixelPosition ViewPortPosition = context->ScreenToViewport(CPixelPosition(CurrentX, CurrentY));
-        CPixelType PixelType = CPixelType::GetPixelType(context->DViewportTypeSurface, ViewPortPosition);
+        CPixelType PixelType = context->DViewportRenderer->PixelType(ViewPortPosition);
 
         if(context->DRightClick && !context->DRightDown && context->DSelectedPlayerAssets.size()){
             bool CanMove = true;
@@ -683,7 +683,7 @@ void CBattleMode::Input(std::shared_ptr< CApplicationData > context){
 *
 */
 void CBattleMode::Calculate(std::shared_ptr< CApplicationData > context){
-    context->DGameModel->GetTriggerHandler()->Resolve(ETriggerType::Time, false, EPlayerColor::None, -1, 1, new int[1]{(int)(GetTime() * 1000)});
+    context->DGameModel->GetTriggerHandler()->Resolve(ETriggerType::Time, false, EPlayerColor::None, -1, STriggerArgs::Time((int)(GetTime() * 1000)));
     //PrintDebug(DEBUG_LOW, "Started CBattleMode::Calculate\n");
 
     // number of players left in the battle
@@ -723,35 +723,7 @@ void CBattleMode::Calculate(std::shared_ptr< CApplicationData > context){
 
     PrintDebug(DEBUG_LOW, "Finished 1st for loop and started 2nd for loop\n");
     for(int Index = 1; Index < to_underlying(EPlayerColor::Max); Index++){
-        if(EAssetCapabilityType::None != context->DPlayerCommands[Index].DAction){
-            auto PlayerCapability = CPlayerCapability::FindCapability(context->DPlayerCommands[Index].DAction);
-            if(PlayerCapability){
-                std::shared_ptr< CPlayerAsset > NewTarget;
-                
-                if((CPlayerCapability::ETargetType::None != PlayerCapability->TargetType())&&(CPlayerCapability::ETargetType::Player != PlayerCapability->TargetType())){
-                    if(EAssetType::None == context->DPlayerCommands[Index].DTargetType){
-                        NewTarget = context->DGameModel->Player(static_cast<EPlayerColor>(Index))->CreateMarker(context->DPlayerCommands[Index].DTargetLocation, true);
-                    }
-                    else{
-                        NewTarget = context->DGameModel->Player(context->DPlayerCommands[Index].DTargetColor)->SelectAsset(context->DPlayerCommands[Index].DTargetLocation, context->DPlayerCommands[Index].DTargetType).lock();
-                        //IL: If nullptr is returned will crash. Make sure to use the right player data.
-                    }
-                }
-
-        PrintDebug(DEBUG_LOW, "Started 3rd for loop (nested)\n");
-
-                for(auto &WeakActor : context->DPlayerCommands[Index].DActors){
-                    if(auto Actor = WeakActor.lock()){
-                        auto NewActor = FindAssetObj(Actor->AssetID());
-                        if(PlayerCapability->CanApply(NewActor, context->DGameModel->Player(static_cast<EPlayerColor>(Index)), NewTarget) && (NewActor->Interruptible() || (EAssetCapabilityType::Cancel == context->DPlayerCommands[Index].DAction))){
-                            PlayerCapability->ApplyCapability(NewActor, context->DGameModel->Player(static_cast<EPlayerColor>(Index)), NewTarget);
-                        }
-                    }
-                }
-		PrintDebug(DEBUG_LOW, "Finished 3rd for loop (nested)\n");
-            }
-            context->DPlayerCommands[Index].DAction = EAssetCapabilityType::None;
-        }
+        context->DGameModel->ApplyPlayerCommand(static_cast<EPlayerColor>(Index), context->DPlayerCommands[Index]);
     }
 
     PrintDebug(DEBUG_LOW,"Finished 2nd for loop(nested)\n");
@@ -788,6 +760,11 @@ void CBattleMode::Calculate(std::shared_ptr< CApplicationData > context){
         }
     }
     PrintDebug(DEBUG_LOW, "Finished 1st while (4th loop)\n");
+
+    // Events are played once per step, frames may be skipped or drawn several times a step
+    SRectangle ViewportRectangle({context->DViewportRenderer->ViewportX(),context->DViewportRenderer->ViewportY(),context->DViewportRenderer->LastViewportWidth(),context->DViewportRenderer->LastViewportHeight()});
+
+    context->DSoundEventRenderer->RenderEvents(ViewportRectangle);
   //  PrintDebug(DEBUG_LOW, "Finished CBattleMode::Calculate\n");
 }
 
@@ -867,7 +844,8 @@ void CBattleMode::Render(std::shared_ptr< CApplicationData > context){
             SelectedAndMarkerAssets.push_back(Asset);
         }
     }
-    context->DViewportRenderer->DrawViewport(context->DViewportSurface, context->DViewportTypeSurface, SelectedAndMarkerAssets, TempRectangle, context->DCurrentAssetCapability);
+    context->DAssetRenderer->Interpolation(context->DRenderInterpolation);
+    context->DViewportRenderer->DrawViewport(context->DViewportSurface, SelectedAndMarkerAssets, TempRectangle, context->DCurrentAssetCapability);
     context->DMiniMapRenderer->DrawMiniMap(context->DMiniMapSurface);
 
     context->DWorkingBufferSurface->Draw(context->DMiniMapSurface, context->DMiniMapXOffset, context->DMiniMapYOffset, -1, -1, 0, 0);
@@ -879,7 +857,7 @@ void CBattleMode::Render(std::shared_ptr< CApplicationData > context){
     switch(context->FindUIComponentType(CPixelPosition(CurrentX, CurrentY))){
         case CApplicationData::uictViewport:        {
                                                         CPixelPosition ViewportCursorLocation = context->ScreenToViewport(CPixelPosition(CurrentX, CurrentY));
-                                                        CPixelType PixelType = CPixelType::GetPixelType(context->DViewportTypeSurface, ViewportCursorLocation.X(), ViewportCursorLocation.Y());
+                                                        CPixelType PixelType = context->DViewportRenderer->PixelType(ViewportCursorLocation);
                                                         context->DCursorType = CApplicationData::ctPointer;
                                                         if(EAssetCapabilityType::None == context->DCurrentAssetCapability){
                                                             if(PixelType.Color() == context->DPlayerColor){
@@ -924,9 +902,6 @@ void CBattleMode::Render(std::shared_ptr< CApplicationData > context){
         default:                                    context->DCursorType = CApplicationData::ctPointer;
                                                     break;
     }
-    SRectangle ViewportRectangle({context->DViewportRenderer->ViewportX(),context->DViewportRenderer->ViewportY(),context->DViewportRenderer->LastViewportWidth(),context->DViewportRenderer->LastViewportHeight()});
-
-    context->DSoundEventRenderer->RenderEvents(ViewportRectangle);
    // PrintDebug(DEBUG_LOW, "Finished CBattleMode::Render\n");
 }
 
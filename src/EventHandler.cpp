@@ -1,6 +1,5 @@
 #include "EventHandler.h"
 #include "Debug.h"
-#include "BattleMode.h"
 #include "GameModel.h"
 
 extern "C" {
@@ -9,21 +8,53 @@ extern "C" {
     #include "lualib.h"
 }
 
-std::shared_ptr< CGameModel > CEventHandler::DGameModel;
-std::string CEventHandler::DEventScript;
+#define EVENT_HANDLER_KEY       "EventHandler"
 
-void CEventHandler::SetGameModelReference (std::shared_ptr< CGameModel > ptr){
+/**
+ * Creates the event handler of a game. Each game has its own handler, the
+ * Lua side functions find it through the registry of the lua_State.
+ *
+ * @param[in] ptr The game model events are applied to
+ */
+CEventHandler::CEventHandler (std::shared_ptr< CGameModel > ptr){
     DGameModel = ptr;
+    DEventScript = ptr->GetTriggerHandler()->GetEventScript();
+    DEndGameColor = EPlayerColor::None;
 }
 
+CEventHandler *CEventHandler::Instance (lua_State *L){
+    lua_getfield(L, LUA_REGISTRYINDEX, EVENT_HANDLER_KEY);
+    CEventHandler *Handler = (CEventHandler *)lua_touserdata(L, -1);
+    lua_pop(L, 1);
+    return Handler;
+}
+
+/**
+ * Routes the events of the game's trigger handler to this event handler
+ */
 void CEventHandler::RegisterAction (){
-    CTriggerHandler::DEventCall = &DoEvent;
+    std::weak_ptr< CEventHandler > WeakThis = shared_from_this();
+
+    DGameModel->GetTriggerHandler()->SetEventCall([WeakThis](int offenderID, std::string event, std::vector< std::string > params, EPlayerColor color){
+        if(auto Handler = WeakThis.lock()){
+            Handler->DoEvent(offenderID, event, params, color);
+        }
+    });
 }
 
 void CEventHandler::SetEventScript (std::string scriptName){
     DEventScript = scriptName;
 }
 
+/**
+ * Sets what is called when an event ends the game
+ *
+ * @param[in] endgamecall Function taking whether the game was won
+ */
+void CEventHandler::SetEndGameCall (std::function< void(bool) > endgamecall){
+    DEndGameCall = endgamecall;
+}
+
 void CEventHandler::DoEvent (int offenderID, std::string event, std::vector< std::string > params, EPlayerColor color){
 	printf("DoEvent\n");
 	
@@ -56,6 +87,9 @@ void CEventHandler::DoEvent (int offenderID, std::string event, std::vector< std
  * @param[in] L The lua_State the register the functions into
  */
  void CEventHandler::RegisterFunctions (lua_State *L){
+    lua_pushlightuserdata(L, this);
+    lua_setfield(L, LUA_REGISTRYINDEX, EVENT_HANDLER_KEY);
+
     lua_register(L, "EndGame_CPP", EndGame);
     lua_register(L, "ChangeResources_CPP", ChangeResources);
     lua_register(L, "ModifyAssetHealth_CPP", ModifyAssetHealth);
@@ -68,7 +102,8 @@ void CEventHandler::DoEvent (int offenderID, std::string event, std::vector< std
 
 
 /**
- * Ends battle mode
+ * Ends battle mode, the player whose trigger ended it is kept as the
+ * EndGameColor
  * 
  * ---Parameters and returns are documented as Lua Side
  *
@@ -76,7 +111,13 @@ void CEventHandler::DoEvent (int offenderID, std::string event, std::vector< std
  */
 int CEventHandler::EndGame (lua_State *L){
     bool won = lua_toboolean(L, -1);
-    CBattleMode::TriggeredEnd(won);
+    CEventHandler *Handler = Instance(L);
+    lua_getglobal(L, "PlayerColor");
+    Handler->DEndGameColor = static_cast<EPlayerColor>(lua_tointeger(L, -1));
+    lua_pop(L, 1);
+    if(Handler->DEndGameCall){
+        Handler->DEndGameCall(won);
+    }
     return 0;
 }
 
@@ -86,10 +127,10 @@ int CEventHandler::ChangeResources (lua_State *L){
     int amount = lua_tointeger(L,-2);
     std::string type = std::string(lua_tostring(L, -1));
     if (type == "Gold"){
-        DGameModel->Player(color)->IncrementGold(amount);
+        Instance(L)->DGameModel->Player(color)->IncrementGold(amount);
     }
     else if(type == "Lumber"){
-        DGameModel->Player(color)->IncrementLumber(amount);
+        Instance(L)->DGameModel->Player(color)->IncrementLumber(amount);
     }
     return 0;
 }
@@ -97,7 +138,9 @@ int CEventHandler::ChangeResources (lua_State *L){
 int CEventHandler::ModifyAssetHealth (lua_State *L){
     int offenderID = lua_tointeger(L, -2);
     int delta = lua_tointeger(L, -1);
-    std::shared_ptr< CPlayerAsset > asset = FindAssetObj(offenderID);
+    std::shared_ptr< CPlayerAsset > asset = Instance(L)->DGameModel->FindAsset(offenderID);
+    if(!asset) // if nullptr is returned
+        return 0;
     if (delta > 0)
         asset->IncrementHitPoints(delta);
     else if (delta < 0)
@@ -108,7 +151,7 @@ int CEventHandler::ModifyAssetHealth (lua_State *L){
 int CEventHandler::RemoveAsset(lua_State *L)
 {
     int offenderID = lua_tointeger(L,-1);
-    std::shared_ptr< CPlayerAsset > asset = FindAssetObj(offenderID);
+    std::shared_ptr< CPlayerAsset > asset = Instance(L)->DGameModel->FindAsset(offenderID);
     if(!asset) // if nullptr is returned
         return 0;
     SAssetCommand cmd;
@@ -127,7 +170,7 @@ int CEventHandler::AddAsset(lua_State *L)
     int amount = lua_tointeger(L, -1);
     EAssetType AssetType = CPlayerAssetType::NameToType(assetName);
 
-    auto asset = DGameModel->Player(color)->CreateAsset(assetName);
+    auto asset = Instance(L)->DGameModel->Player(color)->CreateAsset(assetName);
     CTilePosition position = CTilePosition(positionX,positionY);
 
     asset->TilePosition(position);
@@ -137,7 +180,7 @@ int CEventHandler::AddAsset(lua_State *L)
         
     // else if(EAssetType::StoneQuarry == asset->Type()) asset->Stone = amount //not yet implemented
 
-
+    return 0;
 }
 
 /**
@@ -147,7 +190,8 @@ int CEventHandler::AddUpgrade(lua_State *L)
 {
     printf("add\n");
     EPlayerColor color = static_cast<EPlayerColor>(lua_tointeger(L,-2));
-    DGameModel->Player(color)->AddUpgrade(lua_tostring(L,-1));
+    Instance(L)->DGameModel->Player(color)->AddUpgrade(lua_tostring(L,-1));
+    return 0;
 }
 
 /**
@@ -158,5 +202,6 @@ int CEventHandler::RemoveUpgrade(lua_State *L)
 
     printf("rmv\n");
     EPlayerColor color = static_cast<EPlayerColor>(lua_tointeger(L,-2));
-    DGameModel->Player(color)->RemoveUpgrade(lua_tostring(L,-1));
+    Instance(L)->DGameModel->Player(color)->RemoveUpgrade(lua_tostring(L,-1));
+    return 0;
 }
\ No newline at end of file
@@ -150,14 +150,17 @@ void CDirectoryDataContainerIterator::Next(){
 /** 
  * Initializes the path to the directory for the directory container.
  * 
- * @param[in] path The path to a directory.
+ * @param[in] path     The path to a directory.
+ * @param[in] mapfiles Memory map the files read from the directory and its
+ *                     sub directories.
  * 
  * @return Nothing.
  * 
  */
 
-CDirectoryDataContainer::CDirectoryDataContainer(const std::string &path) : CDataContainer(){
+CDirectoryDataContainer::CDirectoryDataContainer(const std::string &path, bool mapfiles) : CDataContainer(){
     DFullPath = CPath::CurrentPath().Simplify(path).ToString();
+    DMapFiles = mapfiles;
 }
 
 CDirectoryDataContainer::~CDirectoryDataContainer(){
@@ -192,7 +195,7 @@ std::shared_ptr< CDataSource > CDirectoryDataContainer::DataSource(const std::st
 
     // checks if file exists
     if(FileName.length() && (access(FileName.c_str(), F_OK) != -1)){
-        return std::make_shared< CFileDataSource >(FileName);
+        return std::make_shared< CFileDataSource >(FileName, -1, DMapFiles);
     }
     return nullptr;
 }
@@ -226,7 +229,7 @@ std::shared_ptr< CDataContainer > CDirectoryDataContainer::Container(){
     std::string ContainerName = CPath(DFullPath).Containing().ToString();
 
     if(ContainerName.length()){
-        return std::make_shared< CDirectoryDataContainer >(ContainerName);
+        return std::make_shared< CDirectoryDataContainer >(ContainerName, DMapFiles);
     }
     return nullptr;
 }
@@ -242,7 +245,7 @@ std::shared_ptr< CDataContainer > CDirectoryDataContainer::DataContainer(const s
     std::string ContainerName = CPath(DFullPath).Simplify(CPath(name)).ToString();
 
     if(ContainerName.length()){
-        return std::make_shared< CDirectoryDataContainer >(ContainerName);
+        return std::make_shared< CDirectoryDataContainer >(ContainerName, DMapFiles);
     }
     return nullptr;
 }
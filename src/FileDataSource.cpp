@@ -36,45 +36,100 @@
 #include "Path.h"
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <climits>
+
+#define FILE_DATA_SOURCE_BUFFER_SIZE    65536
 
 /**
  * Creates a data source for reading from files. If handed a valid file
  * descriptor (meaning a valid open file), then it won't try to reopen
- * the file.
+ * the file. Files opened by the source are read through a buffer, or are
+ * memory mapped if requested so their content can be viewed without any
+ * copy. Handed in descriptors are not buffered as they may be shared with
+ * a channel.
  * 
  * @param[in] filename The name of file to open for reading.
  * @param[in] fd       The file descriptor for an open file or -1 by default
+ * @param[in] mapfile  Memory map the file, falls back to buffered reads if
+ *                     the file cannot be mapped
  * 
  * @return Nothing.
  * 
  */
 
-CFileDataSource::CFileDataSource(const std::string &filename, int fd) : CDataSource(){
+CFileDataSource::CFileDataSource(const std::string &filename, int fd, bool mapfile) : CDataSource(){
     DFullPath = CPath::CurrentPath().Simplify(filename).ToString();
 
     DFileHandle = fd;
+    DBufferOffset = 0;
+    DBufferLength = 0;
+    DMappedData = nullptr;
+    DMappedLength = 0;
+    DMappedOffset = 0;
     if(DFullPath.length() && (0 > fd)){
         DFileHandle = open(DFullPath.c_str(), O_RDONLY);
         DCloseFile = true;
+        if(mapfile && (0 <= DFileHandle)){
+            struct stat FileStat;
+
+            // Empty files cannot be mapped, they are left to read()
+            if((0 == fstat(DFileHandle, &FileStat))&&S_ISREG(FileStat.st_mode)&&(0 < FileStat.st_size)&&(FileStat.st_size <= INT_MAX)){
+                void *Data = mmap(nullptr, FileStat.st_size, PROT_READ, MAP_PRIVATE, DFileHandle, 0);
+
+                if(MAP_FAILED != Data){
+                    DMappedData = (const char *)Data;
+                    DMappedLength = FileStat.st_size;
+                    return;
+                }
+            }
+        }
+        DBuffer.resize(FILE_DATA_SOURCE_BUFFER_SIZE);
     }
 }
 
 /** 
- * Closes the current file if open.
+ * Unmaps and closes the current file if open.
  * 
  * @return Nothing.
  * 
  */
 
 CFileDataSource::~CFileDataSource(){
+    if(DMappedData){
+        munmap((void *)DMappedData, DMappedLength);
+    }
     if(DCloseFile && (0 <= DFileHandle)){
         close(DFileHandle);
     }
 }
 
 /**
- * Reads from the current open file.
+ * Refills the buffer with a single read of the file, only called once the
+ * buffer is empty.
+ *
+ * @return true if any bytes were read.
+ *
+ */
+
+bool CFileDataSource::FillBuffer(){
+    int BytesRead = read(DFileHandle, DBuffer.data(), DBuffer.size());
+
+    DBufferOffset = 0;
+    DBufferLength = 0 < BytesRead ? BytesRead : 0;
+    return 0 < DBufferLength;
+}
+
+/**
+ * Reads from the current open file. Mapped files are copied from the
+ * mapping. Otherwise buffered bytes are copied first, then the buffer is
+ * refilled until length bytes are read or the file ends, and what is left
+ * of reads at least as large as the buffer goes straight to the file.
+ * Handed in descriptors are read with a single read().
  * 
  * @param[in] data   The buffer to store data read from the file.
  * @param[in] length The number of bytes to read.
@@ -84,18 +139,121 @@ CFileDataSource::~CFileDataSource(){
  */ 
 
 int CFileDataSource::Read(void *data, int length){
-    if(0 <= DFileHandle){
+    if(DMappedData){
+        int BytesCopied = std::min(length, DMappedLength - DMappedOffset);
+
+        if(0 >= BytesCopied){
+            return -1;
+        }
+        memcpy(data, DMappedData + DMappedOffset, BytesCopied);
+        DMappedOffset += BytesCopied;
+        return BytesCopied;
+    }
+    if(DBuffer.empty()&&(0 <= DFileHandle)){
         int BytesRead = read(DFileHandle, data, length);
 
         if(0 < BytesRead){
             return BytesRead;
         }
     }
+    else if(0 <= DFileHandle){
+        char *Destination = (char *)data;
+        int BytesCopied = 0;
+
+        // Only the end of the file ends the read short, as with read() on a file
+        while(BytesCopied < length){
+            if(DBufferOffset < DBufferLength){
+                int Count = std::min(length - BytesCopied, DBufferLength - DBufferOffset);
+
+                memcpy(Destination + BytesCopied, DBuffer.data() + DBufferOffset, Count);
+                DBufferOffset += Count;
+                BytesCopied += Count;
+            }
+            else if(length - BytesCopied < (int)DBuffer.size()){
+                if(!FillBuffer()){
+                    break;
+                }
+            }
+            else{
+                int BytesRead = read(DFileHandle, Destination + BytesCopied, length - BytesCopied);
+
+                if(0 >= BytesRead){
+                    break;
+                }
+                BytesCopied += BytesRead;
+            }
+        }
+        if(0 < BytesCopied){
+            return BytesCopied;
+        }
+    }
     return -1;
 }
 
 /**
- * Creates a directory data container for I/O for the current path.
+ * Returns the buffered bytes of the file without consuming them, filling
+ * the buffer if it is empty. All unread bytes of a mapped file are
+ * returned.
+ * 
+ * @param[out] data Set to the first buffered byte.
+ * 
+ * @return Number of bytes buffered, 0 at the end of the file or -1 if the
+ * source is not buffered.
+ * 
+ */ 
+
+int CFileDataSource::Peek(const void *&data){
+    if(DMappedData){
+        data = DMappedData + DMappedOffset;
+        return DMappedLength - DMappedOffset;
+    }
+    if(DBuffer.empty()||(0 > DFileHandle)){
+        return -1;
+    }
+    if((DBufferOffset == DBufferLength)&&(!FillBuffer())){
+        return 0;
+    }
+    data = DBuffer.data() + DBufferOffset;
+    return DBufferLength - DBufferOffset;
+}
+
+/**
+ * Consumes bytes previously returned by Peek.
+ * 
+ * @param[in] length The number of bytes to consume.
+ * 
+ * @return Nothing.
+ * 
+ */ 
+
+void CFileDataSource::Skip(int length){
+    if(DMappedData){
+        DMappedOffset = std::min(DMappedOffset + std::max(length, 0), DMappedLength);
+        return;
+    }
+    DBufferOffset = std::min(DBufferOffset + std::max(length, 0), DBufferLength);
+}
+
+/**
+ * Returns the unread bytes of a mapped file without copying them.
+ * 
+ * @param[out] length The number of unread bytes.
+ * 
+ * @return The first unread byte, nullptr if the file is not mapped.
+ * 
+ */ 
+
+const void *CFileDataSource::View(int &length){
+    if(!DMappedData){
+        return nullptr;
+    }
+    length = DMappedLength - DMappedOffset;
+    return DMappedData + DMappedOffset;
+}
+
+/**
+ * Creates a directory data container for I/O for the current path, mapping
+ * its files if this file is mapped.
  * 
  * @return A new directory data container.
  * 
@@ -105,7 +263,7 @@ std::shared_ptr< CDataContainer > CFileDataSource::Container(){
     std::string ContainerName = CPath(DFullPath).Containing().ToString();
 
     if(ContainerName.length()){
-        return std::make_shared< CDirectoryDataContainer >(ContainerName);
+        return std::make_shared< CDirectoryDataContainer >(ContainerName, nullptr != DMappedData);
 
     }
     return nullptr;
@@ -38,8 +38,10 @@
 #include "Debug.h"
 #include "FileDataSink.h"
 #include "GraphicFactory.h"
+#include "PixelBlend.h"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 
 /**
  * Constructor initializes protected data members with parameter values of the map
@@ -63,10 +65,155 @@ CFogRenderer::CFogRenderer(std::shared_ptr< CGraphicTileset > tileset, std::shar
     }
     DSeenIndex = DFogIndices[0x00];
     DNoneIndex = DBlackIndices[0x00];
+    DMapWidth = 0;
+    DMapHeight = 0;
+    
+    // Keep the fog tiles as raw pixels so they can be blended without the surface
+    int TilePixelCount = DTileset->TileWidth() * DTileset->TileHeight();
+    DTilePixels.resize(DTileset->TileCount() * TilePixelCount);
+    for(int Index = 0; Index < DTileset->TileCount(); Index++){
+        if(!DTileset->TilePixels(Index, DTilePixels.data() + Index * TilePixelCount)){
+            PrintError("Failed to read pixels of fog tile %d.\n", Index);
+        }
+    }
+}
+
+/**
+ * Finds how dark the fog of a tile is on the minimap
+ *
+ * @param[in] xindex X index of the tile
+ * @param[in] yindex Y index of the tile
+ *
+ * @return Alpha of the black fog over the tile
+*/
+uint8_t CFogRenderer::MiniMapAlpha(int xindex, int yindex) const{
+    switch(DMap->TileType(xindex, yindex)){
+        case CVisibilityMap::ETileVisibility::None:             return 0xFF;
+        case CVisibilityMap::ETileVisibility::Seen:
+        case CVisibilityMap::ETileVisibility::SeenPartial:      return 0xA8;
+        case CVisibilityMap::ETileVisibility::Visible:          return 0x00;
+        default:                                                return 0x54;
+    }
 }
 
 /**
- * Draws the map to include the fog of war based on unit coordinates.
+ * Computes the partial fog indices of a tile by probing its 8 neighbours.
+ * The fog mask has the bits of the visible neighbours set, the black mask
+ * those of the neighbours that were ever seen.
+ *
+ * @param[in] xindex X index of the tile
+ * @param[in] yindex Y index of the tile
+ * @param[out] fogmask Index into DFogIndices
+ * @param[out] blackmask Index into DBlackIndices
+ *
+ * @return None
+*/
+void CFogRenderer::TileMasks(int xindex, int yindex, uint8_t &fogmask, uint8_t &blackmask) const{
+    int VisibilityMask = 0x1;
+    
+    fogmask = blackmask = 0;
+    for(int YOff = -1; YOff < 2; YOff++){
+        for(int XOff = -1; XOff < 2; XOff++){
+            if(YOff || XOff){
+                CVisibilityMap::ETileVisibility VisTile = DMap->TileType(xindex + XOff, yindex + YOff);
+                
+                if(CVisibilityMap::ETileVisibility::Visible == VisTile){
+                    fogmask |= VisibilityMask;   
+                }
+                if((CVisibilityMap::ETileVisibility::Visible == VisTile)||(CVisibilityMap::ETileVisibility::Partial == VisTile)||(CVisibilityMap::ETileVisibility::Seen == VisTile)){
+                    blackmask |= VisibilityMask;   
+                }
+                VisibilityMask <<= 1;
+            }
+        }
+    }
+}
+
+/**
+ * Recomputes the minimap alpha and partial fog indices of a tile of the map
+ *
+ * @param[in] xindex X index of the tile
+ * @param[in] yindex Y index of the tile
+ *
+ * @return None
+*/
+void CFogRenderer::UpdateTile(int xindex, int yindex){
+    if((0 > xindex)||(0 > yindex)||(DMapWidth <= xindex)||(DMapHeight <= yindex)){
+        return;
+    }
+    int Index = yindex * DMapWidth + xindex;
+    
+    DMiniMapAlphas[Index] = MiniMapAlpha(xindex, yindex);
+    TileMasks(xindex, yindex, DFogMasks[Index], DBlackMasks[Index]);
+}
+
+/**
+ * Brings the fog up to date with the tiles whose visibility changed since
+ * the last update, or with the whole map if it changed entirely. The
+ * partial fog indices of a tile depend on its neighbours, so the
+ * neighbours of each changed tile are updated as well.
+ *
+ * @return None
+*/
+void CFogRenderer::UpdateTiles(){
+    if(DMap->TakeChangedTiles(DChangedTiles)||(DMap->Width() != DMapWidth)||(DMap->Height() != DMapHeight)){
+        DMapWidth = DMap->Width();
+        DMapHeight = DMap->Height();
+        DMiniMapAlphas.resize(DMapWidth * DMapHeight);
+        DFogMasks.resize(DMapWidth * DMapHeight);
+        DBlackMasks.resize(DMapWidth * DMapHeight);
+        for(int YIndex = 0; YIndex < DMapHeight; YIndex++){
+            for(int XIndex = 0; XIndex < DMapWidth; XIndex++){
+                UpdateTile(XIndex, YIndex);
+            }
+        }
+        return;
+    }
+    for(auto &Tile : DChangedTiles){
+        for(int YOff = -1; YOff < 2; YOff++){
+            for(int XOff = -1; XOff < 2; XOff++){
+                UpdateTile(Tile.X() + XOff, Tile.Y() + YOff);
+            }
+        }
+    }
+}
+
+/**
+ * Blends a fog tile over locked surface pixels, clipped to a rectangle
+ *
+ * @param[in] pixels The locked pixels of the surface
+ * @param[in] stride Bytes per row of pixels
+ * @param[in] clip Rectangle of the pixels that may be drawn
+ * @param[in] xpos X position of the tile
+ * @param[in] ypos Y position of the tile
+ * @param[in] tileindex Index of the fog tile
+ *
+ * @return None
+*/
+void CFogRenderer::BlendTile(uint8_t *pixels, int stride, const SRectangle &clip, int xpos, int ypos, int tileindex){
+    int TileWidth = DTileset->TileWidth();
+    int TileHeight = DTileset->TileHeight();
+    
+    if((0 > tileindex)||(tileindex >= DTileset->TileCount())){
+        return;
+    }
+    int Left = std::max(xpos, clip.DXPosition);
+    int Top = std::max(ypos, clip.DYPosition);
+    int Right = std::min(xpos + TileWidth, clip.DXPosition + clip.DWidth);
+    int Bottom = std::min(ypos + TileHeight, clip.DYPosition + clip.DHeight);
+    const uint32_t *TilePixels = DTilePixels.data() + tileindex * TileWidth * TileHeight;
+    
+    for(int YPos = Top; YPos < Bottom; YPos++){
+        uint32_t *Pixel = (uint32_t *)(pixels + YPos * stride);
+        
+        CPixelBlend::Over(Pixel + Left, TilePixels + (YPos - ypos) * TileWidth + (Left - xpos), Right - Left);
+    }
+}
+
+/**
+ * Draws the map to include the fog of war based on unit coordinates. The
+ * fog tiles are blended directly over the surface pixels using the partial
+ * fog indices kept up to date by UpdateTiles.
  *
  * @param[in] surface Shared pointer of CGraphicSurface 
  * @param[in] rect Constant reference to a SRectangle object
@@ -74,107 +221,88 @@ CFogRenderer::CFogRenderer(std::shared_ptr< CGraphicTileset > tileset, std::shar
  * @return None
 */
 void CFogRenderer::DrawMap(std::shared_ptr<CGraphicSurface> surface, const SRectangle &rect){
-    int TileWidth, TileHeight;
+    int TileWidth, TileHeight, Stride;
+    SRectangle Clip{0, 0, std::min(rect.DWidth, surface->Width()), std::min(rect.DHeight, surface->Height())};
     
     TileWidth = DTileset->TileWidth();
     TileHeight = DTileset->TileHeight();
+    if((CGraphicSurface::ESurfaceFormat::ARGB32 != surface->Format())&&(CGraphicSurface::ESurfaceFormat::RGB24 != surface->Format())){
+        return;
+    }
+    UpdateTiles();
+    uint8_t *Pixels = surface->LockPixels(Stride);
+    if(!Pixels){
+        return;
+    }
 
     // Draw the visible map based on the coordinates in the parameters
     for(int YIndex = rect.DYPosition / TileHeight, YPos = -(rect.DYPosition % TileHeight); YPos < rect.DHeight; YIndex++, YPos += TileHeight){
         for(int XIndex = rect.DXPosition / TileWidth, XPos = -(rect.DXPosition % TileWidth); XPos < rect.DWidth; XIndex++, XPos += TileWidth){
             CVisibilityMap::ETileVisibility TileType = DMap->TileType(XIndex, YIndex);
+            uint8_t FogMask, BlackMask;
 
             //NN: I demand all tiles be considered visible >:V
             //TileType = CVisibilityMap::ETileVisibility::Visible;
             
             if(CVisibilityMap::ETileVisibility::None == TileType){
-                DTileset->DrawTile(surface, XPos, YPos, DNoneIndex);
+                BlendTile(Pixels, Stride, Clip, XPos, YPos, DNoneIndex);
                 continue;
             }
             else if(CVisibilityMap::ETileVisibility::Visible == TileType){
                 continue;
             }
+            if((0 <= XIndex)&&(0 <= YIndex)&&(DMapWidth > XIndex)&&(DMapHeight > YIndex)){
+                FogMask = DFogMasks[YIndex * DMapWidth + XIndex];
+                BlackMask = DBlackMasks[YIndex * DMapWidth + XIndex];
+            }
+            else{
+                TileMasks(XIndex, YIndex, FogMask, BlackMask);
+            }
             if((CVisibilityMap::ETileVisibility::Seen == TileType)||(CVisibilityMap::ETileVisibility::SeenPartial == TileType)){
-                DTileset->DrawTile(surface, XPos, YPos, DSeenIndex);
+                BlendTile(Pixels, Stride, Clip, XPos, YPos, DSeenIndex);
             }
             if((CVisibilityMap::ETileVisibility::PartialPartial == TileType)||(CVisibilityMap::ETileVisibility::Partial == TileType)){
-                int VisibilityIndex = 0, VisibilityMask = 0x1;
-                
-                for(int YOff = -1; YOff < 2; YOff++){
-                    for(int XOff = -1; XOff < 2; XOff++){
-                        if(YOff || XOff){
-                            CVisibilityMap::ETileVisibility VisTile = DMap->TileType(XIndex + XOff, YIndex + YOff);
-                            
-                            if(CVisibilityMap::ETileVisibility::Visible == VisTile){
-                                VisibilityIndex |= VisibilityMask;   
-                            }
-                            VisibilityMask <<= 1;
-                        }
-                    }
-                }
-                DTileset->DrawTile(surface, XPos, YPos, DFogIndices[VisibilityIndex]);
+                BlendTile(Pixels, Stride, Clip, XPos, YPos, DFogIndices[FogMask]);
             }
-            
             if((CVisibilityMap::ETileVisibility::PartialPartial == TileType)||(CVisibilityMap::ETileVisibility::SeenPartial == TileType)){
-                int VisibilityIndex = 0, VisibilityMask = 0x1;
-                
-                for(int YOff = -1; YOff < 2; YOff++){
-                    for(int XOff = -1; XOff < 2; XOff++){
-                        if(YOff || XOff){
-                            CVisibilityMap::ETileVisibility VisTile = DMap->TileType(XIndex + XOff, YIndex + YOff);
-                            
-                            if((CVisibilityMap::ETileVisibility::Visible == VisTile)||(CVisibilityMap::ETileVisibility::Partial == VisTile)||(CVisibilityMap::ETileVisibility::Seen == VisTile)){
-                                VisibilityIndex |= VisibilityMask;   
-                            }
-                            VisibilityMask <<= 1;
-                        }
-                    }
-                }
-                DTileset->DrawTile(surface, XPos, YPos, DBlackIndices[VisibilityIndex]);
+                BlendTile(Pixels, Stride, Clip, XPos, YPos, DBlackIndices[BlackMask]);
             }
         }
     }
+    surface->UnlockPixels();
 }
 
 /**
- * Similar to CFogRenderer::DrawMap, this function calculate sand renders fog of war for the minimap
+ * Similar to CFogRenderer::DrawMap, this function renders fog of war for the
+ * minimap, blending the fog of each tile directly over the surface pixels
  *
  * @param[in] surface Shared pointer of CGraphicSurface 
  *
  * @return None
 */
 void CFogRenderer::DrawMiniMap(std::shared_ptr<CGraphicSurface> surface){
-    auto ResourceContext = surface->CreateResourceContext();
+    int Stride;
+    
+    if((CGraphicSurface::ESurfaceFormat::ARGB32 != surface->Format())&&(CGraphicSurface::ESurfaceFormat::RGB24 != surface->Format())){
+        return;
+    }
+    UpdateTiles();
+    uint8_t *Pixels = surface->LockPixels(Stride);
+    if(!Pixels){
+        return;
+    }
+    int Width = std::min(surface->Width(), DMapWidth);
+    int Height = std::min(surface->Height(), DMapHeight);
+    std::vector< uint32_t > FogPixels(Width);
     
-    ResourceContext->SetLineWidth(1);
-    ResourceContext->SetLineCap(CGraphicResourceContext::ELineCap::Square);
-    for(int YPos = 0; YPos < DMap->Height(); YPos++){
-        int XPos = 0;
+    for(int YPos = 0; YPos < Height; YPos++){
+        const uint8_t *Alpha = DMiniMapAlphas.data() + YPos * DMapWidth;
         
-        // Draw the visible map based on the coordinates in the parameters
-        while(XPos < DMap->Width()){
-            auto TileType = DMap->TileType(XPos, YPos);
-            int XAnchor = XPos;
-            while((XPos < DMap->Width())&&(DMap->TileType(XPos, YPos) == TileType)){
-                XPos++;   
-            }
-            if(CVisibilityMap::ETileVisibility::Visible != TileType){
-                uint32_t ColorRGBA = 0x00000000;
-                switch(TileType){
-                    case CVisibilityMap::ETileVisibility::None:           ColorRGBA = 0xFF000000;
-                                                                            break;
-                    case CVisibilityMap::ETileVisibility::Seen:
-                    case CVisibilityMap::ETileVisibility::SeenPartial:    ColorRGBA = 0xA8000000;
-                                                                            break;
-                    default:                                                ColorRGBA = 0x54000000;
-                                                                            break;                                   
-                }
-                ResourceContext->SetSourceRGBA(ColorRGBA);
-                ResourceContext->MoveTo(XAnchor,YPos);
-                ResourceContext->LineTo(XPos - 1,YPos);
-                ResourceContext->Stroke();   
-            }
+        // Fog is black, so as a premultiplied pixel it is only its alpha
+        for(int XPos = 0; XPos < Width; XPos++){
+            FogPixels[XPos] = uint32_t(Alpha[XPos]) << 24;
         }
+        CPixelBlend::Over((uint32_t *)(Pixels + YPos * Stride), FogPixels.data(), Width);
     }
+    surface->UnlockPixels();
 }
-
@@ -39,27 +39,6 @@
 #include <algorithm>
 #include <stdlib.h>
 
-int GAssetIDCount = 0;
-std::map< int, std::shared_ptr< CPlayerAsset > > GAssetIDMap;
-
-std::shared_ptr< CPlayerAsset > FindAssetObj(int AssetID){
-    auto Iterator = GAssetIDMap.find(AssetID);
-
-    if(Iterator != GAssetIDMap.end())
-        return Iterator->second;
-    return nullptr;
-}
-
-void MapNewAssetObj(std::shared_ptr< CPlayerAsset > CreatedAsset){
-    GAssetIDMap.insert(std::pair < int, std::shared_ptr< CPlayerAsset > >(GAssetIDCount, CreatedAsset));
-    GAssetIDCount++;
-}
-
-int GetAssetIDCount(){
-    return GAssetIDCount;
-}
-
-
 /**
 *  Calculates the range in terms of tile width using Pythagorean Theorem
 *
@@ -79,14 +58,17 @@ int RangeToDistanceSquared(int range){
 *  Initializes resources from the map and player assets with the correct tile position, color, and type.
 *
 *  @param[in] map A shared pointer to CAssetDecoratedMap
+*  @param[in] handler A shared pointer to the game's CTriggerHandler
+*  @param[in] idtable A shared pointer to the game's asset ID table
 *  @param[in] color A variable that stores the player's color
 *
 */
-CPlayerData::CPlayerData(std::shared_ptr< CAssetDecoratedMap > map, std::shared_ptr< CTriggerHandler > handler, EPlayerColor color){
+CPlayerData::CPlayerData(std::shared_ptr< CAssetDecoratedMap > map, std::shared_ptr< CTriggerHandler > handler, std::shared_ptr< CAssetIDTable > idtable, EPlayerColor color){
     DIsAI = true;
     DGameCycle = 0;
     DColor = color;
     DTriggerHandler = handler;
+    DAssetIDTable = idtable;
     DActualMap = map;
     DAssetTypes = CPlayerAssetType::DuplicateRegistry(color);
     DPlayerMap = DActualMap->CreateInitializeMap();
@@ -94,6 +76,9 @@ CPlayerData::CPlayerData(std::shared_ptr< CAssetDecoratedMap > map, std::shared_
     DGold = 0;
     DLumber = 0;
     DStone = 0;
+    DGoldGathered = 0;
+    DLumberGathered = 0;
+    DStoneGathered = 0;
     DAssetsCreated = (int*)calloc((int)EAssetType::Max * sizeof(int), sizeof(int));
     DAssetsLost = (int*)calloc((int)EAssetType::Max * sizeof(int), sizeof(int));
     DAssetsDestroyed = (int*)calloc((int)EAssetType::Max * sizeof(int), sizeof(int));
@@ -197,7 +182,7 @@ std::shared_ptr< CPlayerAsset > CPlayerData::CreateMarker(const CPixelPosition &
 std::shared_ptr< CPlayerAsset > CPlayerData::CreateAsset(const std::string &assettypename){
     std::shared_ptr< CPlayerAsset > CreatedAsset = (*DAssetTypes)[assettypename]->Construct();
 
-    MapNewAssetObj(CreatedAsset);
+    DAssetIDTable->Insert(CreatedAsset);
 
     CreatedAsset->CreationCycle(DGameCycle);
     DAssets.push_back(CreatedAsset);
@@ -224,6 +209,7 @@ void CPlayerData::DeleteAsset(std::shared_ptr< CPlayerAsset > asset){
         Iterator++;
     }
     DActualMap->RemoveAsset(asset);
+    DAssetIDTable->Remove(asset->AssetID());
 
     ResolveNewAssetCounts();
 }
@@ -232,33 +218,33 @@ void CPlayerData::ResolveNewAssetCounts(){
     int counts[(int)EAssetType::Max];
     for (int i = 0; i < (int)EAssetType::Max; i++)
         counts[i] = PlayerAssetCount(static_cast<EAssetType>(i));
-    DTriggerHandler->Resolve(ETriggerType::AssetCount, DIsAI, DColor, -1, (int)EAssetType::Max, counts);
+    DTriggerHandler->Resolve(ETriggerType::AssetCount, DIsAI, DColor, -1, STriggerArgs::AssetCounts(counts));
 }
 
 void CPlayerData::IncrementCreated(std::shared_ptr< CPlayerAsset > asset){
     EAssetType assetType = asset->Type();
     DAssetsCreated[(int)assetType]++;
-    DTriggerHandler->Resolve(ETriggerType::AssetsCreated, DIsAI, DColor, asset->AssetID(), (int)EAssetType::Max, DAssetsCreated);
+    DTriggerHandler->Resolve(ETriggerType::AssetsCreated, DIsAI, DColor, asset->AssetID(), STriggerArgs::AssetCounts(DAssetsCreated));
 }
 
 void CPlayerData::IncrementLost(std::shared_ptr< CPlayerAsset > asset){
     //printf("Lost AI?%d Lost%d\n", (int)DIsAI, (int)asset->Type());
     EAssetType assetType = asset->Type();
     DAssetsLost[(int)assetType]++;
-    DTriggerHandler->Resolve(ETriggerType::AssetsLost, DIsAI, DColor, asset->AssetID(), (int)EAssetType::Max, DAssetsLost);
+    DTriggerHandler->Resolve(ETriggerType::AssetsLost, DIsAI, DColor, asset->AssetID(), STriggerArgs::AssetCounts(DAssetsLost));
 }
 
 void CPlayerData::IncrementDestroyed(std::shared_ptr< CPlayerAsset > asset, std::shared_ptr< CPlayerAsset > destroyer){
     //printf("Destroyed AI?%d Destroyed%d\n", (int)DIsAI, (int)asset->Type());
     EAssetType assetType = asset->Type();
     DAssetsDestroyed[(int)assetType]++;
-    DTriggerHandler->Resolve(ETriggerType::AssetsDestroyed, DIsAI, DColor, destroyer->AssetID(), (int)EAssetType::Max, DAssetsDestroyed);
+    DTriggerHandler->Resolve(ETriggerType::AssetsDestroyed, DIsAI, DColor, destroyer->AssetID(), STriggerArgs::AssetCounts(DAssetsDestroyed));
 }
 
 void CPlayerData::CheckAssetLocations(){
     for (auto WeakAsset : DAssets){
         if (auto Asset = WeakAsset.lock()){
-            DTriggerHandler->Resolve(ETriggerType::AssetLocation, DIsAI, DColor, Asset->AssetID(), 3, new int[3]{(int)Asset->Type(), Asset->TilePositionX(), Asset->TilePositionY()});
+            DTriggerHandler->Resolve(ETriggerType::AssetLocation, DIsAI, DColor, Asset->AssetID(), STriggerArgs::AssetLocation(Asset->Type(), Asset->TilePositionX(), Asset->TilePositionY()));
         }
     }
 }
@@ -297,6 +283,45 @@ bool CPlayerData::AssetRequirementsMet(const std::string &assettypename){
     return true;
 }
 
+/**
+*  Checks if the player can see a shared game event, events of its own
+*  assets are always seen, others only when on a visible tile. The neutral
+*  player sees all events.
+*
+*  @param[in] event The game event
+*
+*  @return true if the player can see the event
+*
+*/
+bool CPlayerData::CanSeeEvent(const SGameEvent &event) const{
+    if((EPlayerColor::None == DColor)||(!event.DAsset)||(event.DAsset->Color() == DColor)){
+        return true;
+    }
+    switch(DVisibilityMap->TileType(event.DAsset->TilePositionX(), event.DAsset->TilePositionY())){
+        case CVisibilityMap::ETileVisibility::PartialPartial:
+        case CVisibilityMap::ETileVisibility::Partial:
+        case CVisibilityMap::ETileVisibility::Visible:   return true;
+        default:                                          return false;
+    }
+}
+
+/**
+*  Adds the shared game events from first on that the player can see to the
+*  events of the player, only their indices are kept
+*
+*  @param[in] first Index of the first shared game event to check
+*
+*  @return Nothing
+*
+*/
+void CPlayerData::SelectGameEvents(int first){
+    for(int Index = first; Index < DSharedGameEvents->size(); Index++){
+        if(CanSeeEvent((*DSharedGameEvents)[Index])){
+            DSharedGameEventIndices.push_back(Index);
+        }
+    }
+}
+
 /**
 *  Updates what is visible on the map
 *
@@ -1025,12 +1050,16 @@ CGameModel::CGameModel(int mapindex, uint64_t seed, const std::array< EPlayerCol
     DStonePerQuarry = 100;
 
     DRandomNumberGenerator.Seed(seed);
+    DTurnOrderGenerator.Seed(seed);
     DActualMap = CAssetDecoratedMap::DuplicateMap(mapindex, newcolors);
-    DTriggerHandler = CTriggerHandler::DuplicateHandler(mapindex);
+    DTriggerHandler = CTriggerHandler::DuplicateHandler(DActualMap->TriggerHandlerIndex());
     DTriggerHandler->ActivateTriggers();
+    DAssetIDTable = std::make_shared< CAssetIDTable >();
+    DGameEvents = std::make_shared< std::vector< SGameEvent > >();
 
     for(int PlayerIndex = 0; PlayerIndex < to_underlying(EPlayerColor::Max); PlayerIndex++){
-        DPlayers[PlayerIndex] = std::make_shared< CPlayerData > (DActualMap, DTriggerHandler, static_cast<EPlayerColor>(PlayerIndex));
+        DPlayers[PlayerIndex] = std::make_shared< CPlayerData > (DActualMap, DTriggerHandler, DAssetIDTable, static_cast<EPlayerColor>(PlayerIndex));
+        DPlayers[PlayerIndex]->SharedGameEvents(DGameEvents);
     }
     DAssetOccupancyMap.resize(DActualMap->Height());
     for(auto &Row : DAssetOccupancyMap){
@@ -1074,6 +1103,44 @@ std::shared_ptr< CPlayerData > CGameModel::Player(EPlayerColor color) const{
     return DPlayers[to_underlying(color)];
 }
 
+/**
+*  Applies a command requested by a player (human or AI) to the actors of the command
+*
+*  @param[in] color The color of the player issuing the command
+*  @param[in] command The requested command, its action is reset to None once applied
+*
+*  @return Nothing
+*
+*/
+void CGameModel::ApplyPlayerCommand(EPlayerColor color, SPlayerCommandRequest &command){
+    if(EAssetCapabilityType::None == command.DAction){
+        return;
+    }
+    auto PlayerCapability = CPlayerCapability::FindCapability(command.DAction);
+    if(PlayerCapability){
+        std::shared_ptr< CPlayerAsset > NewTarget;
+
+        if((CPlayerCapability::ETargetType::None != PlayerCapability->TargetType())&&(CPlayerCapability::ETargetType::Player != PlayerCapability->TargetType())){
+            if(EAssetType::None == command.DTargetType){
+                NewTarget = Player(color)->CreateMarker(command.DTargetLocation, true);
+            }
+            else{
+                NewTarget = Player(command.DTargetColor)->SelectAsset(command.DTargetLocation, command.DTargetType).lock();
+                //IL: If nullptr is returned will crash. Make sure to use the right player data.
+            }
+        }
+
+        for(auto &WeakActor : command.DActors){
+            if(auto Actor = WeakActor.lock()){
+                if(PlayerCapability->CanApply(Actor, Player(color), NewTarget) && (Actor->Interruptible() || (EAssetCapabilityType::Cancel == command.DAction))){
+                    PlayerCapability->ApplyCapability(Actor, Player(color), NewTarget);
+                }
+            }
+        }
+    }
+    command.DAction = EAssetCapabilityType::None;
+}
+
 /**
 * Compares two elements of Asset list for sort function 
 *
@@ -1097,7 +1164,9 @@ bool CompareTurnOrder(std::shared_ptr< CPlayerAsset > a, std::shared_ptr< CPlaye
 *
 */
 void CGameModel::Timestep(){
-    std::vector< SGameEvent > CurrentEvents;
+    // Events of the step go to the shared buffer, players only index those they see
+    std::vector< SGameEvent > &CurrentEvents = *DGameEvents;
+    int FirstEvent = CurrentEvents.size();
     SGameEvent TempEvent;
 
     for(auto &Row : DAssetOccupancyMap){
@@ -1113,6 +1182,8 @@ void CGameModel::Timestep(){
 
     //places asset on occupancy map if not mining or conveying gold or lumber
     for(auto &Asset : DActualMap->Assets()){
+        // Renderers interpolate from where the asset was before this step
+        Asset->StorePreviousPosition();
         if((EAssetAction::ConveyGold != Asset->Action())&&(EAssetAction::ConveyLumber != Asset->Action())&&(EAssetAction::MineGold != Asset->Action())&&(EAssetAction::ConveyStone != Asset->Action())){
             DAssetOccupancyMap[Asset->TilePositionY()][Asset->TilePositionX()] = Asset;
         }
@@ -1132,7 +1203,7 @@ void CGameModel::Timestep(){
 
     // assign each asset a pseudo-random turn order
     for(auto &Asset : AllAssets){
-        Asset->AssignTurnOrder();
+        Asset->AssignTurnOrder(DTurnOrderGenerator.Random());
         if(Asset->Speed()){
             MobileAssets.push_back(Asset);
         }
@@ -1675,6 +1746,7 @@ void CGameModel::Timestep(){
                 SAssetCommand Command = Asset->CurrentCommand();
                 CTilePosition NextTarget(DPlayers[to_underlying(Asset->Color())]->PlayerMap()->Width()-1,DPlayers[to_underlying(Asset->Color())]->PlayerMap()->Height()-1);
 
+                DPlayers[to_underlying(Asset->Color())]->GatherResources(Asset->Gold(), Asset->Lumber(), Asset->Stone());
                 DPlayers[to_underlying(Asset->Color())]->IncrementGold(Asset->Gold());
                 DPlayers[to_underlying(Asset->Color())]->IncrementLumber(Asset->Lumber());
                 DPlayers[to_underlying(Asset->Color())]->IncrementStone(Asset->Stone());
@@ -1800,7 +1872,7 @@ void CGameModel::Timestep(){
     DGameCycle++;
     for(int PlayerIndex = 0; PlayerIndex < to_underlying(EPlayerColor::Max); PlayerIndex++){
         DPlayers[PlayerIndex]->IncrementCycle();
-        DPlayers[PlayerIndex]->AppendGameEvents(CurrentEvents);
+        DPlayers[PlayerIndex]->SelectGameEvents(FirstEvent);
     }
 }
 
@@ -1811,6 +1883,7 @@ void CGameModel::Timestep(){
 *
 */
 void CGameModel::ClearGameEvents(){
+    DGameEvents->clear();
     for(int PlayerIndex = 0; PlayerIndex < to_underlying(EPlayerColor::Max); PlayerIndex++){
         DPlayers[PlayerIndex]->ClearGameEvents();
     }
@@ -15,6 +15,7 @@
     ownership of this material.
 */
 #include "GraphicFactoryCairo.h"
+#include "GraphicFactorySoftware.h"
 #include <vector>
 #include "Debug.h"
 
@@ -39,13 +40,14 @@ void CGraphicResourceContextCairo::SetLineWidth(double width){
 }
 
 void CGraphicResourceContextCairo::SetSourceSurface(std::shared_ptr<CGraphicSurface> srcsurface, int xpos, int ypos){
-    std::shared_ptr<CGraphicSurfaceCairo> CairoSourceSurface;
+    cairo_surface_t *SourceSurface;
     
     if(!srcsurface){
         return;
     }
-    CairoSourceSurface = std::dynamic_pointer_cast<CGraphicSurfaceCairo>(srcsurface);
-    cairo_set_source_surface(DResourceContext, CairoSourceSurface->DSurface, xpos, ypos);
+    SourceSurface = CGraphicSurfaceCairo::CairoSurface(srcsurface);
+    cairo_set_source_surface(DResourceContext, SourceSurface, xpos, ypos);
+    cairo_surface_destroy(SourceSurface);
 }
 
 void CGraphicResourceContextCairo::SetLineCap(ELineCap cap){
@@ -113,13 +115,14 @@ void CGraphicResourceContextCairo::Clip(){
 }
 
 void CGraphicResourceContextCairo::MaskSurface(std::shared_ptr<CGraphicSurface> srcsurface, int xpos, int ypos){
-    std::shared_ptr<CGraphicSurfaceCairo> CairoSourceSurface; 
+    cairo_surface_t *SourceSurface;
     
     if(!srcsurface){
         return;
     }
-    CairoSourceSurface = std::dynamic_pointer_cast<CGraphicSurfaceCairo>(srcsurface);
-    cairo_mask_surface(DResourceContext, CairoSourceSurface->DSurface, xpos, ypos);
+    SourceSurface = CGraphicSurfaceCairo::CairoSurface(srcsurface);
+    cairo_mask_surface(DResourceContext, SourceSurface, xpos, ypos);
+    cairo_surface_destroy(SourceSurface);
 }
 
 
@@ -136,12 +139,11 @@ void CGraphicResourceContextCairo::Restore(){
 }
 
 void CGraphicResourceContextCairo::DrawSurface(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, int width, int height, int sxpos, int sypos){
-    std::shared_ptr<CGraphicSurfaceCairo> CairoSourceSurface; 
+    cairo_surface_t *SourceSurface;
     
     if(!srcsurface){
         return;
     }
-    CairoSourceSurface = std::dynamic_pointer_cast<CGraphicSurfaceCairo>(srcsurface);   
     if(srcsurface->Width() < sxpos + width){
         width = srcsurface->Width() - sxpos;   
     }
@@ -156,18 +158,19 @@ void CGraphicResourceContextCairo::DrawSurface(std::shared_ptr<CGraphicSurface>
         height = srcsurface->Height() - sypos;
         height = 0 > height ? 0 : height;
     }
-    cairo_set_source_surface(DResourceContext, CairoSourceSurface->DSurface, dxpos - sxpos, dypos - sypos);
+    SourceSurface = CGraphicSurfaceCairo::CairoSurface(srcsurface);
+    cairo_set_source_surface(DResourceContext, SourceSurface, dxpos - sxpos, dypos - sypos);
     cairo_rectangle(DResourceContext, dxpos, dypos, width, height);
     cairo_fill(DResourceContext);    
+    cairo_surface_destroy(SourceSurface);
 }
 
 void CGraphicResourceContextCairo::CopySurface(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, int width, int height, int sxpos, int sypos){
-    std::shared_ptr<CGraphicSurfaceCairo> CairoSourceSurface; 
+    cairo_surface_t *SourceSurface;
     
     if(!srcsurface){
         return;
     }
-    CairoSourceSurface = std::dynamic_pointer_cast<CGraphicSurfaceCairo>(srcsurface);
     if(srcsurface->Width() < sxpos + width){
         width = srcsurface->Width() - sxpos;   
     }
@@ -182,12 +185,40 @@ void CGraphicResourceContextCairo::CopySurface(std::shared_ptr<CGraphicSurface>
         height = srcsurface->Height() - sypos;
         height = 0 > height ? 0 : height;
     }
+    SourceSurface = CGraphicSurfaceCairo::CairoSurface(srcsurface);
     Save();
-    cairo_set_source_surface(DResourceContext, CairoSourceSurface->DSurface, dxpos - sxpos, dypos - sypos);
+    cairo_set_source_surface(DResourceContext, SourceSurface, dxpos - sxpos, dypos - sypos);
     cairo_rectangle(DResourceContext, dxpos, dypos, width, height);
     cairo_set_operator(DResourceContext, CAIRO_OPERATOR_SOURCE);
     cairo_fill(DResourceContext);    
     Restore();
+    cairo_surface_destroy(SourceSurface);
+}
+
+static cairo_format_t CairoFormat(CGraphicSurface::ESurfaceFormat format){
+    switch(format){
+        case CGraphicSurface::ESurfaceFormat::ARGB32:   return CAIRO_FORMAT_ARGB32;
+        case CGraphicSurface::ESurfaceFormat::RGB24:    return CAIRO_FORMAT_RGB24;
+        case CGraphicSurface::ESurfaceFormat::A8:       return CAIRO_FORMAT_A8;
+        case CGraphicSurface::ESurfaceFormat::A1:       return CAIRO_FORMAT_A1;
+        default:                                        return CAIRO_FORMAT_ARGB32;
+    }
+}
+
+// Returns a new reference to the Cairo surface of any surface, surfaces of
+// other backends are wrapped without a copy as they share the Cairo layout
+cairo_surface_t *CGraphicSurfaceCairo::CairoSurface(std::shared_ptr<CGraphicSurface> surface){
+    std::shared_ptr<CGraphicSurfaceCairo> CairoSourceSurface;
+    uint8_t *Pixels;
+    int Stride;
+    
+    CairoSourceSurface = std::dynamic_pointer_cast<CGraphicSurfaceCairo>(surface);
+    if(CairoSourceSurface){
+        return cairo_surface_reference(CairoSourceSurface->DSurface);
+    }
+    Pixels = surface->LockPixels(Stride);
+    surface->UnlockPixels();
+    return cairo_image_surface_create_for_data(Pixels, CairoFormat(surface->Format()), surface->Width(), surface->Height(), Stride);
 }
 
 std::shared_ptr<CGraphicResourceContext> CGraphicSurfaceCairo::CreateResourceContext(){
@@ -220,6 +251,22 @@ uint32_t CGraphicSurfaceCairo::PixelAt(int xpos, int ypos){
     }
 }
 
+uint8_t *CGraphicSurfaceCairo::LockPixels(int &stride){
+    if(!DSurface){
+        stride = 0;
+        return nullptr;
+    }
+    cairo_surface_flush(DSurface);
+    stride = cairo_image_surface_get_stride(DSurface);
+    return cairo_image_surface_get_data(DSurface);
+}
+
+void CGraphicSurfaceCairo::UnlockPixels(){
+    if(DSurface){
+        cairo_surface_mark_dirty(DSurface);
+    }
+}
+
 void CGraphicSurfaceCairo::Clear(int xpos, int ypos, int width, int height){
     if(Width() < xpos + width){
         width = Width() - xpos;   
@@ -466,31 +513,45 @@ void CGraphicSurfaceCairo::Transform(std::shared_ptr<CGraphicSurface> srcsurface
     
 }
 
+CGraphicFactory::EBackend CGraphicFactory::DBackend = CGraphicFactory::EBackend::Cairo;
+
 std::shared_ptr<CGraphicSurface> CGraphicFactory::CreateSurface(int width, int height, CGraphicSurface::ESurfaceFormat format){
-    cairo_format_t Format;
-    switch(format){
-        case CGraphicSurface::ESurfaceFormat::ARGB32:   Format = CAIRO_FORMAT_ARGB32;
-                                                        break;
-        case CGraphicSurface::ESurfaceFormat::RGB24:    Format = CAIRO_FORMAT_RGB24;
-                                                        break;
-        case CGraphicSurface::ESurfaceFormat::A8:       Format = CAIRO_FORMAT_A8;
-                                                        break;
-        case CGraphicSurface::ESurfaceFormat::A1:       Format = CAIRO_FORMAT_A1;
-                                                        break;
-        default:                                        Format = CAIRO_FORMAT_ARGB32;
-                                                        break;
+    if(EBackend::Software == DBackend){
+        return std::make_shared<CGraphicSurfaceSoftware>(width, height, format);
     }
-    return std::shared_ptr<CGraphicSurface>(new CGraphicSurfaceCairo(cairo_image_surface_create(Format, width, height)));   
+    return std::shared_ptr<CGraphicSurface>(new CGraphicSurfaceCairo(cairo_image_surface_create(CairoFormat(format), width, height)));   
 }
 
 cairo_status_t GraphicFactoryCairoDataRead(void *closure, unsigned char *data, unsigned int length){
     CDataSource *DataSource = static_cast< CDataSource * >(closure);
+    int BytesRead;
     
-    return DataSource->Read(data, length) ? CAIRO_STATUS_SUCCESS : CAIRO_STATUS_READ_ERROR;
+    // Sources may return less than asked for, libpng needs all of it
+    while(length){
+        BytesRead = DataSource->Read(data, length);
+        if(0 >= BytesRead){
+            return CAIRO_STATUS_READ_ERROR;
+        }
+        data += BytesRead;
+        length -= BytesRead;
+    }
+    return CAIRO_STATUS_SUCCESS;
 }
 
 std::shared_ptr<CGraphicSurface> CGraphicFactory::LoadSurface(std::shared_ptr< CDataSource > source){
-    return std::shared_ptr<CGraphicSurface>(new CGraphicSurfaceCairo(cairo_image_surface_create_from_png_stream(GraphicFactoryCairoDataRead, source.get())));
+    std::shared_ptr<CGraphicSurface> CairoSurface(new CGraphicSurfaceCairo(cairo_image_surface_create_from_png_stream(GraphicFactoryCairoDataRead, source.get())));
+    std::shared_ptr<CGraphicSurface> SoftwareSurface;
+    
+    if(EBackend::Software != DBackend){
+        return CairoSurface;
+    }
+    // Cairo only decodes the PNG, the pixels are moved into a software surface
+    if(CAIRO_STATUS_SUCCESS != cairo_surface_status(std::static_pointer_cast<CGraphicSurfaceCairo>(CairoSurface)->DSurface)){
+        return CairoSurface;
+    }
+    SoftwareSurface = CreateSurface(CairoSurface->Width(), CairoSurface->Height(), CairoSurface->Format());
+    SoftwareSurface->Copy(CairoSurface, 0, 0, -1, -1, 0, 0);
+    return SoftwareSurface;
 }
 
 cairo_status_t GraphicFactoryCairoDataWrite(void *closure, const unsigned char *data, unsigned int length){
@@ -500,12 +561,15 @@ cairo_status_t GraphicFactoryCairoDataWrite(void *closure, const unsigned char *
 }
 
 bool CGraphicFactory::StoreSurface(std::shared_ptr< CDataSink > sink, std::shared_ptr<CGraphicSurface> surface){
-    std::shared_ptr<CGraphicSurfaceCairo> CairoSourceSurface;
+    cairo_surface_t *SourceSurface;
+    bool Stored;
     
     if(!surface){
         return false;
     }
-    CairoSourceSurface = std::dynamic_pointer_cast<CGraphicSurfaceCairo>(surface);
-    return cairo_surface_write_to_png_stream(CairoSourceSurface->DSurface, GraphicFactoryCairoDataWrite, sink.get()) == CAIRO_STATUS_SUCCESS;
+    SourceSurface = CGraphicSurfaceCairo::CairoSurface(surface);
+    Stored = cairo_surface_write_to_png_stream(SourceSurface, GraphicFactoryCairoDataWrite, sink.get()) == CAIRO_STATUS_SUCCESS;
+    cairo_surface_destroy(SourceSurface);
+    return Stored;
 }
 
@@ -0,0 +1,732 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#include "GraphicFactorySoftware.h"
+#include "PixelBlend.h"
+#include "Debug.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Reads a pixel of any format as premultiplied ARGB32, A1 pixels are stored
+// least significant bit first in 32 bit words like Cairo does
+static inline uint32_t ReadPixel(const uint8_t *row, int xpos, CGraphicSurface::ESurfaceFormat format){
+    switch(format){
+        case CGraphicSurface::ESurfaceFormat::ARGB32:   return ((const uint32_t *)row)[xpos];
+        case CGraphicSurface::ESurfaceFormat::RGB24:    return ((const uint32_t *)row)[xpos] | 0xFF000000;
+        case CGraphicSurface::ESurfaceFormat::A8:       return uint32_t(row[xpos]) << 24;
+        default:                                        return (((const uint32_t *)row)[xpos >> 5] >> (xpos & 0x1F)) & 0x1 ? 0xFF000000 : 0x00000000;
+    }
+}
+
+// Writes a premultiplied ARGB32 pixel in any format, A1 keeps pixels with at
+// least half alpha
+static inline void WritePixel(uint8_t *row, int xpos, CGraphicSurface::ESurfaceFormat format, uint32_t pixel){
+    switch(format){
+        case CGraphicSurface::ESurfaceFormat::ARGB32:
+        case CGraphicSurface::ESurfaceFormat::RGB24:    ((uint32_t *)row)[xpos] = pixel;
+                                                        break;
+        case CGraphicSurface::ESurfaceFormat::A8:       row[xpos] = pixel >> 24;
+                                                        break;
+        default:                                        if(pixel & 0x80000000){
+                                                            ((uint32_t *)row)[xpos >> 5] |= 0x1U << (xpos & 0x1F);
+                                                        }
+                                                        else{
+                                                            ((uint32_t *)row)[xpos >> 5] &= ~(0x1U << (xpos & 0x1F));
+                                                        }
+                                                        break;
+    }
+}
+
+// Multiplies all channels of a pixel by scale / 255
+static inline uint32_t ScalePixel(uint32_t pixel, uint32_t scale){
+    uint32_t RB = (pixel & 0x00FF00FF) * scale + 0x00800080;
+    uint32_t AG = ((pixel >> 8) & 0x00FF00FF) * scale + 0x00800080;
+
+    RB = ((RB + ((RB >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    AG = (AG + ((AG >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+    return RB | AG;
+}
+
+static inline uint32_t OverPixel(uint32_t dest, uint32_t src){
+    return src + ScalePixel(dest, 0xFF - (src >> 24));
+}
+
+static inline bool DirectFormat(CGraphicSurface::ESurfaceFormat format){
+    return (CGraphicSurface::ESurfaceFormat::ARGB32 == format)||(CGraphicSurface::ESurfaceFormat::RGB24 == format);
+}
+
+// Fraction of pixel index covered by the range low to high
+static inline double Overlap(int index, double low, double high){
+    return std::max(0.0, std::min(index + 1.0, high) - std::max(double(index), low));
+}
+
+// Clamps the size of a blit like the Cairo surfaces do, negative sizes take
+// the rest of the source, and clips it to the source and destination
+static bool ClipBlit(int &dxpos, int &dypos, int &width, int &height, int &sxpos, int &sypos, int srcwidth, int srcheight, int destwidth, int destheight){
+    if((srcwidth < sxpos + width)||(0 > width)){
+        width = srcwidth - sxpos;
+    }
+    if((srcheight < sypos + height)||(0 > height)){
+        height = srcheight - sypos;
+    }
+    if(0 > sxpos){
+        dxpos -= sxpos;
+        width += sxpos;
+        sxpos = 0;
+    }
+    if(0 > sypos){
+        dypos -= sypos;
+        height += sypos;
+        sypos = 0;
+    }
+    if(0 > dxpos){
+        sxpos -= dxpos;
+        width += dxpos;
+        dxpos = 0;
+    }
+    if(0 > dypos){
+        sypos -= dypos;
+        height += dypos;
+        dypos = 0;
+    }
+    width = std::min(width, destwidth - dxpos);
+    height = std::min(height, destheight - dypos);
+    return (0 < width)&&(0 < height);
+}
+
+CGraphicResourceContextSoftware::CGraphicResourceContextSoftware(std::shared_ptr<CGraphicSurfaceSoftware> target) : DTarget(target){
+    DState.DSourceColor = 0xFF000000;
+    DState.DSourceX = DState.DSourceY = 0.0;
+    DState.DSourceScaleX = DState.DSourceScaleY = 1.0;
+    DState.DScaleX = DState.DScaleY = 1.0;
+    DState.DLineWidth = 2.0;
+    DState.DClipLeft = DState.DClipTop = 0;
+    DState.DClipRight = DTarget->Width();
+    DState.DClipBottom = DTarget->Height();
+    DPathX = DPathY = 0.0;
+}
+
+void CGraphicResourceContextSoftware::SetSourceRGB(uint32_t rgb){
+    SetSourceRGBA(0xFF000000 | rgb);
+}
+
+void CGraphicResourceContextSoftware::SetSourceRGB(double r, double g, double b){
+    SetSourceRGBA(r, g, b, 1.0);
+}
+
+void CGraphicResourceContextSoftware::SetSourceRGBA(uint32_t rgba){
+    DState.DSourceSurface = nullptr;
+    DState.DSourceColor = ScalePixel(rgba | 0xFF000000, rgba >> 24);
+}
+
+void CGraphicResourceContextSoftware::SetSourceRGBA(double r, double g, double b, double a){
+    auto Channel = [](double value){
+        return uint32_t(std::max(0.0, std::min(1.0, value)) * 255.0 + 0.5);
+    };
+
+    SetSourceRGBA((Channel(a)<<24) | (Channel(r)<<16) | (Channel(g)<<8) | Channel(b));
+}
+
+void CGraphicResourceContextSoftware::SetSourceSurface(std::shared_ptr<CGraphicSurface> srcsurface, int xpos, int ypos){
+    if(!srcsurface){
+        return;
+    }
+    DState.DSourceSurface = srcsurface;
+    DState.DSourceX = xpos * DState.DScaleX;
+    DState.DSourceY = ypos * DState.DScaleY;
+    DState.DSourceScaleX = DState.DScaleX;
+    DState.DSourceScaleY = DState.DScaleY;
+}
+
+void CGraphicResourceContextSoftware::SetLineWidth(double width){
+    DState.DLineWidth = width;
+}
+
+void CGraphicResourceContextSoftware::SetLineCap(ELineCap cap){
+
+}
+
+void CGraphicResourceContextSoftware::SetLineJoin(ELineJoin join){
+
+}
+
+void CGraphicResourceContextSoftware::Scale(double sx, double sy){
+    DState.DScaleX *= sx;
+    DState.DScaleY *= sy;
+}
+
+// Paints a span of a row with the source, the coverage (nullptr if fully
+// covered) and alpha scale the source. The span is blended over the target,
+// or replaces it where covered if source is set.
+void CGraphicResourceContextSoftware::PaintSpan(int xpos, int ypos, int width, const uint8_t *coverage, uint8_t alpha, bool source){
+    if((DState.DClipTop > ypos)||(DState.DClipBottom <= ypos)){
+        return;
+    }
+    if(DState.DClipLeft > xpos){
+        int Skip = DState.DClipLeft - xpos;
+
+        xpos += Skip;
+        width -= Skip;
+        coverage = coverage ? coverage + Skip : nullptr;
+    }
+    width = std::min(width, DState.DClipRight - xpos);
+    if(0 >= width){
+        return;
+    }
+    int Stride;
+    uint8_t *Dest = DTarget->LockPixels(Stride) + Stride * ypos;
+    CGraphicSurface::ESurfaceFormat Format = DTarget->Format();
+    bool FullCoverage = !coverage && (0xFF == alpha);
+
+    if(!DState.DSourceSurface && FullCoverage && DirectFormat(Format) && (source||(0xFF000000 == (DState.DSourceColor & 0xFF000000)))){
+        std::fill((uint32_t *)Dest + xpos, (uint32_t *)Dest + xpos + width, DState.DSourceColor);
+        return;
+    }
+    DSpanPixels.resize(width);
+    uint32_t *Span = DSpanPixels.data();
+
+    if(DState.DSourceSurface){
+        auto Source = DState.DSourceSurface;
+        int SrcStride;
+        const uint8_t *SrcPixels = Source->LockPixels(SrcStride);
+        CGraphicSurface::ESurfaceFormat SrcFormat = Source->Format();
+        int SrcY = int(std::floor((ypos + 0.5 - DState.DSourceY) / DState.DSourceScaleY));
+        double SrcX = (xpos + 0.5 - DState.DSourceX) / DState.DSourceScaleX;
+        double SrcStep = 1.0 / DState.DSourceScaleX;
+
+        if(!SrcPixels||(0 > SrcY)||(SrcY >= Source->Height())){
+            std::fill(Span, Span + width, 0x00000000);
+        }
+        else{
+            const uint8_t *SrcRow = SrcPixels + SrcStride * SrcY;
+
+            for(int Col = 0; Col < width; Col++){
+                int XPos = int(std::floor(SrcX + Col * SrcStep));
+
+                Span[Col] = (0 <= XPos)&&(XPos < Source->Width()) ? ReadPixel(SrcRow, XPos, SrcFormat) : 0x00000000;
+            }
+        }
+        Source->UnlockPixels();
+    }
+    else{
+        std::fill(Span, Span + width, DState.DSourceColor);
+    }
+    if(FullCoverage && !source && DirectFormat(Format)){
+        CPixelBlend::Over((uint32_t *)Dest + xpos, Span, width);
+        return;
+    }
+    for(int Col = 0; Col < width; Col++){
+        uint32_t Coverage = coverage ? coverage[Col] : 0xFF;
+
+        if(0xFF != alpha){
+            Coverage = (Coverage * alpha + 0x7F) / 0xFF;
+        }
+        if(!Coverage){
+            continue;
+        }
+        uint32_t Pixel = Span[Col];
+
+        if(source){
+            if(0xFF != Coverage){
+                Pixel = ScalePixel(Pixel, Coverage) + ScalePixel(ReadPixel(Dest, xpos + Col, Format), 0xFF - Coverage);
+            }
+        }
+        else{
+            Pixel = OverPixel(ReadPixel(Dest, xpos + Col, Format), 0xFF == Coverage ? Pixel : ScalePixel(Pixel, Coverage));
+        }
+        WritePixel(Dest, xpos + Col, Format, Pixel);
+    }
+}
+
+// Paints the runs of a row that have coverage
+void CGraphicResourceContextSoftware::PaintCoverage(int xpos, int ypos, int width, const uint8_t *coverage, bool source){
+    int Col = 0;
+
+    while(Col < width){
+        bool Full = true;
+
+        while((Col < width) && !coverage[Col]){
+            Col++;
+        }
+        int Start = Col;
+
+        while((Col < width) && coverage[Col]){
+            Full &= 0xFF == coverage[Col];
+            Col++;
+        }
+        if(Col > Start){
+            PaintSpan(xpos + Start, ypos, Col - Start, Full ? nullptr : coverage + Start, 0xFF, source);
+        }
+    }
+}
+
+// Paints the area of outer that is not within inner, with the edges of both
+// antialiased by the fraction of each pixel they cover
+void CGraphicResourceContextSoftware::PaintRegion(const SPathRectangle &outer, const SPathRectangle &inner, bool source){
+    int Left = std::max(DState.DClipLeft, int(std::floor(outer.DLeft)));
+    int Top = std::max(DState.DClipTop, int(std::floor(outer.DTop)));
+    int Right = std::min(DState.DClipRight, int(std::ceil(outer.DRight)));
+    int Bottom = std::min(DState.DClipBottom, int(std::ceil(outer.DBottom)));
+
+    if((Left >= Right)||(Top >= Bottom)){
+        return;
+    }
+    std::vector< double > OuterX(Right - Left), InnerX(Right - Left);
+
+    for(int Col = Left; Col < Right; Col++){
+        OuterX[Col - Left] = Overlap(Col, outer.DLeft, outer.DRight);
+        InnerX[Col - Left] = Overlap(Col, inner.DLeft, inner.DRight);
+    }
+    DCoverage.resize(Right - Left);
+    for(int Row = Top; Row < Bottom; Row++){
+        double OuterY = Overlap(Row, outer.DTop, outer.DBottom);
+        double InnerY = Overlap(Row, inner.DTop, inner.DBottom);
+
+        for(int Col = 0; Col < Right - Left; Col++){
+            DCoverage[Col] = uint8_t(std::max(0.0, OuterX[Col] * OuterY - InnerX[Col] * InnerY) * 255.0 + 0.5);
+        }
+        PaintCoverage(Left, Row, Right - Left, DCoverage.data(), source);
+    }
+}
+
+void CGraphicResourceContextSoftware::StrokeLine(const SPathLine &line){
+    double HalfWidth = DState.DLineWidth * DState.DScaleX / 2.0;
+    double HalfHeight = DState.DLineWidth * DState.DScaleY / 2.0;
+    double DeltaX = line.DX2 - line.DX1;
+    double DeltaY = line.DY2 - line.DY1;
+    SPathRectangle Empty{0.0, 0.0, 0.0, 0.0};
+
+    if(0.0 == DeltaY){
+        PaintRegion(SPathRectangle{std::min(line.DX1, line.DX2), line.DY1 - HalfHeight, std::max(line.DX1, line.DX2), line.DY1 + HalfHeight}, Empty, false);
+    }
+    else if(0.0 == DeltaX){
+        PaintRegion(SPathRectangle{line.DX1 - HalfWidth, std::min(line.DY1, line.DY2), line.DX1 + HalfWidth, std::max(line.DY1, line.DY2)}, Empty, false);
+    }
+    else{
+        // Steps a pixel at a time along the major axis, painting the width of
+        // the line across the minor axis
+        double Length = std::sqrt(DeltaX * DeltaX + DeltaY * DeltaY);
+        int Steps = int(std::ceil(std::max(std::fabs(DeltaX), std::fabs(DeltaY))));
+
+        for(int Step = 0; Step <= Steps; Step++){
+            double XPos = line.DX1 + DeltaX * Step / Steps;
+            double YPos = line.DY1 + DeltaY * Step / Steps;
+
+            if(std::fabs(DeltaX) >= std::fabs(DeltaY)){
+                double Extent = HalfHeight * Length / std::fabs(DeltaX);
+
+                PaintRegion(SPathRectangle{std::floor(XPos), YPos - Extent, std::floor(XPos) + 1.0, YPos + Extent}, Empty, false);
+            }
+            else{
+                double Extent = HalfWidth * Length / std::fabs(DeltaY);
+
+                PaintRegion(SPathRectangle{XPos - Extent, std::floor(YPos), XPos + Extent, std::floor(YPos) + 1.0}, Empty, false);
+            }
+        }
+    }
+}
+
+void CGraphicResourceContextSoftware::Paint(){
+    PaintWithAlpha(1.0);
+}
+
+void CGraphicResourceContextSoftware::PaintWithAlpha(double alpha){
+    uint8_t Alpha = uint8_t(std::max(0.0, std::min(1.0, alpha)) * 255.0 + 0.5);
+    int Left = DState.DClipLeft, Top = DState.DClipTop;
+    int Right = DState.DClipRight, Bottom = DState.DClipBottom;
+
+    if(!Alpha){
+        return;
+    }
+    // Nothing is painted outside of a source surface
+    if(DState.DSourceSurface){
+        Left = std::max(Left, int(std::floor(DState.DSourceX)));
+        Top = std::max(Top, int(std::floor(DState.DSourceY)));
+        Right = std::min(Right, int(std::ceil(DState.DSourceX + DState.DSourceSurface->Width() * DState.DSourceScaleX)));
+        Bottom = std::min(Bottom, int(std::ceil(DState.DSourceY + DState.DSourceSurface->Height() * DState.DSourceScaleY)));
+    }
+    for(int Row = Top; (Row < Bottom) && (Left < Right); Row++){
+        PaintSpan(Left, Row, Right - Left, nullptr, Alpha, false);
+    }
+}
+
+void CGraphicResourceContextSoftware::Fill(){
+    for(auto &Rectangle : DPathRectangles){
+        PaintRegion(Rectangle, SPathRectangle{0.0, 0.0, 0.0, 0.0}, false);
+    }
+    DPathRectangles.clear();
+    DPathLines.clear();
+}
+
+void CGraphicResourceContextSoftware::Stroke(){
+    double HalfWidth = DState.DLineWidth * DState.DScaleX / 2.0;
+    double HalfHeight = DState.DLineWidth * DState.DScaleY / 2.0;
+
+    for(auto &Rectangle : DPathRectangles){
+        SPathRectangle Outer{Rectangle.DLeft - HalfWidth, Rectangle.DTop - HalfHeight, Rectangle.DRight + HalfWidth, Rectangle.DBottom + HalfHeight};
+        SPathRectangle Inner{Rectangle.DLeft + HalfWidth, Rectangle.DTop + HalfHeight, Rectangle.DRight - HalfWidth, Rectangle.DBottom - HalfHeight};
+
+        if((Inner.DLeft >= Inner.DRight)||(Inner.DTop >= Inner.DBottom)){
+            Inner = SPathRectangle{0.0, 0.0, 0.0, 0.0};
+        }
+        PaintRegion(Outer, Inner, false);
+    }
+    for(auto &Line : DPathLines){
+        StrokeLine(Line);
+    }
+    DPathRectangles.clear();
+    DPathLines.clear();
+}
+
+void CGraphicResourceContextSoftware::Rectangle(int xpos, int ypos, int width, int height){
+    double Left = (xpos + 0.5) * DState.DScaleX, Right = (xpos + width + 0.5) * DState.DScaleX;
+    double Top = (ypos + 0.5) * DState.DScaleY, Bottom = (ypos + height + 0.5) * DState.DScaleY;
+
+    DPathRectangles.push_back(SPathRectangle{std::min(Left, Right), std::min(Top, Bottom), std::max(Left, Right), std::max(Top, Bottom)});
+    DPathX = Left;
+    DPathY = Top;
+}
+
+void CGraphicResourceContextSoftware::MoveTo(int xpos, int ypos){
+    DPathX = (xpos + 0.5) * DState.DScaleX;
+    DPathY = (ypos + 0.5) * DState.DScaleY;
+}
+
+void CGraphicResourceContextSoftware::LineTo(int xpos, int ypos){
+    SPathLine Line{DPathX, DPathY, (xpos + 0.5) * DState.DScaleX, (ypos + 0.5) * DState.DScaleY};
+
+    DPathLines.push_back(Line);
+    DPathX = Line.DX2;
+    DPathY = Line.DY2;
+}
+
+// Clips to the bounds of the rectangles of the path
+void CGraphicResourceContextSoftware::Clip(){
+    int Left = DState.DClipRight, Top = DState.DClipBottom, Right = DState.DClipLeft, Bottom = DState.DClipTop;
+
+    for(auto &Rectangle : DPathRectangles){
+        Left = std::min(Left, int(std::floor(Rectangle.DLeft)));
+        Top = std::min(Top, int(std::floor(Rectangle.DTop)));
+        Right = std::max(Right, int(std::ceil(Rectangle.DRight)));
+        Bottom = std::max(Bottom, int(std::ceil(Rectangle.DBottom)));
+    }
+    DState.DClipLeft = std::max(DState.DClipLeft, Left);
+    DState.DClipTop = std::max(DState.DClipTop, Top);
+    DState.DClipRight = std::max(DState.DClipLeft, std::min(DState.DClipRight, Right));
+    DState.DClipBottom = std::max(DState.DClipTop, std::min(DState.DClipBottom, Bottom));
+    DPathRectangles.clear();
+    DPathLines.clear();
+}
+
+void CGraphicResourceContextSoftware::MaskSurface(std::shared_ptr<CGraphicSurface> srcsurface, int xpos, int ypos){
+    int Stride;
+    const uint8_t *MaskPixels;
+
+    if(!srcsurface){
+        return;
+    }
+    MaskPixels = srcsurface->LockPixels(Stride);
+    if(MaskPixels){
+        CGraphicSurface::ESurfaceFormat MaskFormat = srcsurface->Format();
+        int XPos = int(std::floor(xpos * DState.DScaleX + 0.5));
+        int YPos = int(std::floor(ypos * DState.DScaleY + 0.5));
+
+        DCoverage.resize(srcsurface->Width());
+        for(int Row = 0; Row < srcsurface->Height(); Row++){
+            for(int Col = 0; Col < srcsurface->Width(); Col++){
+                DCoverage[Col] = ReadPixel(MaskPixels + Stride * Row, Col, MaskFormat) >> 24;
+            }
+            PaintCoverage(XPos, YPos + Row, srcsurface->Width(), DCoverage.data(), false);
+        }
+    }
+    srcsurface->UnlockPixels();
+}
+
+std::shared_ptr<CGraphicSurface> CGraphicResourceContextSoftware::GetTarget(){
+    return DTarget;
+}
+
+void CGraphicResourceContextSoftware::Save(){
+    DSavedStates.push_back(DState);
+}
+
+void CGraphicResourceContextSoftware::Restore(){
+    if(DSavedStates.size()){
+        DState = DSavedStates.back();
+        DSavedStates.pop_back();
+    }
+}
+
+void CGraphicResourceContextSoftware::DrawSurface(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, int width, int height, int sxpos, int sypos){
+    if(!srcsurface){
+        return;
+    }
+    if((srcsurface->Width() < sxpos + width)||(0 > width)){
+        width = std::max(0, srcsurface->Width() - sxpos);
+    }
+    if((srcsurface->Height() < sypos + height)||(0 > height)){
+        height = std::max(0, srcsurface->Height() - sypos);
+    }
+    SetSourceSurface(srcsurface, dxpos - sxpos, dypos - sypos);
+    PaintRegion(SPathRectangle{dxpos * DState.DScaleX, dypos * DState.DScaleY, (dxpos + width) * DState.DScaleX, (dypos + height) * DState.DScaleY}, SPathRectangle{0.0, 0.0, 0.0, 0.0}, false);
+}
+
+void CGraphicResourceContextSoftware::CopySurface(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, int width, int height, int sxpos, int sypos){
+    if(!srcsurface){
+        return;
+    }
+    if((srcsurface->Width() < sxpos + width)||(0 > width)){
+        width = std::max(0, srcsurface->Width() - sxpos);
+    }
+    if((srcsurface->Height() < sypos + height)||(0 > height)){
+        height = std::max(0, srcsurface->Height() - sypos);
+    }
+    Save();
+    SetSourceSurface(srcsurface, dxpos - sxpos, dypos - sypos);
+    PaintRegion(SPathRectangle{dxpos * DState.DScaleX, dypos * DState.DScaleY, (dxpos + width) * DState.DScaleX, (dypos + height) * DState.DScaleY}, SPathRectangle{0.0, 0.0, 0.0, 0.0}, true);
+    Restore();
+}
+
+CGraphicSurfaceSoftware::CGraphicSurfaceSoftware(int width, int height, ESurfaceFormat format){
+    DWidth = std::max(0, width);
+    DHeight = std::max(0, height);
+    DFormat = format;
+    DStride = FormatStride(DWidth, DFormat);
+    DPixels.assign((DStride / sizeof(uint32_t)) * DHeight, 0x00000000);
+}
+
+// Bytes per row, the same as cairo_format_stride_for_width
+int CGraphicSurfaceSoftware::FormatStride(int width, ESurfaceFormat format){
+    switch(format){
+        case ESurfaceFormat::ARGB32:
+        case ESurfaceFormat::RGB24:     return width * 4;
+        case ESurfaceFormat::A8:        return (width + 3) & ~3;
+        default:                        return ((width + 31) / 32) * 4;
+    }
+}
+
+uint32_t CGraphicSurfaceSoftware::PixelAt(int xpos, int ypos){
+    if((0 > xpos)||(0 > ypos)||(xpos >= Width())||(ypos >= Height())){
+        PrintDebug(DEBUG_HIGH, "Ivalid Pixel (%d, %d) out of range of (%d x %d)\n", xpos, ypos, Width(), Height());
+        return 0;
+    }
+    if(!DirectFormat(DFormat)){
+        return 0;
+    }
+    return ReadPixel((const uint8_t *)DPixels.data() + DStride * ypos, xpos, DFormat);
+}
+
+uint8_t *CGraphicSurfaceSoftware::LockPixels(int &stride){
+    stride = DStride;
+    return (uint8_t *)DPixels.data();
+}
+
+void CGraphicSurfaceSoftware::UnlockPixels(){
+
+}
+
+void CGraphicSurfaceSoftware::Clear(int xpos, int ypos, int width, int height){
+    int SrcX = xpos, SrcY = ypos;
+
+    if(!ClipBlit(xpos, ypos, width, height, SrcX, SrcY, DWidth, DHeight, DWidth, DHeight)){
+        return;
+    }
+    for(int Row = ypos; Row < ypos + height; Row++){
+        uint8_t *Pixels = (uint8_t *)DPixels.data() + DStride * Row;
+
+        if(DirectFormat(DFormat)){
+            std::fill((uint32_t *)Pixels + xpos, (uint32_t *)Pixels + xpos + width, 0x00000000);
+        }
+        else if(ESurfaceFormat::A8 == DFormat){
+            memset(Pixels + xpos, 0, width);
+        }
+        else{
+            for(int Col = xpos; Col < xpos + width; Col++){
+                WritePixel(Pixels, Col, DFormat, 0x00000000);
+            }
+        }
+    }
+}
+
+std::shared_ptr<CGraphicSurface> CGraphicSurfaceSoftware::Duplicate(){
+    return std::make_shared<CGraphicSurfaceSoftware>(*this);
+}
+
+std::shared_ptr<CGraphicResourceContext> CGraphicSurfaceSoftware::CreateResourceContext(){
+    return std::make_shared<CGraphicResourceContextSoftware>(std::static_pointer_cast<CGraphicSurfaceSoftware>(shared_from_this()));
+}
+
+// Alpha blit, blends the source over the surface
+void CGraphicSurfaceSoftware::Draw(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, int width, int height, int sxpos, int sypos){
+    int SrcStride;
+    const uint8_t *SrcPixels;
+
+    if(!srcsurface){
+        return;
+    }
+    if(!ClipBlit(dxpos, dypos, width, height, sxpos, sypos, srcsurface->Width(), srcsurface->Height(), DWidth, DHeight)){
+        return;
+    }
+    SrcPixels = srcsurface->LockPixels(SrcStride);
+    if(SrcPixels){
+        ESurfaceFormat SrcFormat = srcsurface->Format();
+
+        for(int Row = 0; Row < height; Row++){
+            const uint8_t *Source = SrcPixels + SrcStride * (sypos + Row);
+            uint8_t *Dest = (uint8_t *)DPixels.data() + DStride * (dypos + Row);
+
+            if(DirectFormat(DFormat) && (ESurfaceFormat::ARGB32 == SrcFormat)){
+                CPixelBlend::Over((uint32_t *)Dest + dxpos, (const uint32_t *)Source + sxpos, width);
+            }
+            else if(DirectFormat(DFormat) && (ESurfaceFormat::RGB24 == SrcFormat)){
+                for(int Col = 0; Col < width; Col++){
+                    ((uint32_t *)Dest)[dxpos + Col] = ((const uint32_t *)Source)[sxpos + Col] | 0xFF000000;
+                }
+            }
+            else{
+                for(int Col = 0; Col < width; Col++){
+                    WritePixel(Dest, dxpos + Col, DFormat, OverPixel(ReadPixel(Dest, dxpos + Col, DFormat), ReadPixel(Source, sxpos + Col, SrcFormat)));
+                }
+            }
+        }
+    }
+    srcsurface->UnlockPixels();
+}
+
+// Opaque blit, replaces the surface with the source
+void CGraphicSurfaceSoftware::Copy(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, int width, int height, int sxpos, int sypos){
+    int SrcStride;
+    const uint8_t *SrcPixels;
+
+    if(!srcsurface){
+        return;
+    }
+    if(!ClipBlit(dxpos, dypos, width, height, sxpos, sypos, srcsurface->Width(), srcsurface->Height(), DWidth, DHeight)){
+        return;
+    }
+    SrcPixels = srcsurface->LockPixels(SrcStride);
+    if(SrcPixels){
+        ESurfaceFormat SrcFormat = srcsurface->Format();
+
+        for(int Row = 0; Row < height; Row++){
+            const uint8_t *Source = SrcPixels + SrcStride * (sypos + Row);
+            uint8_t *Dest = (uint8_t *)DPixels.data() + DStride * (dypos + Row);
+
+            if((DFormat == SrcFormat) && DirectFormat(DFormat)){
+                memmove((uint32_t *)Dest + dxpos, (const uint32_t *)Source + sxpos, width * sizeof(uint32_t));
+            }
+            else{
+                for(int Col = 0; Col < width; Col++){
+                    WritePixel(Dest, dxpos + Col, DFormat, ReadPixel(Source, sxpos + Col, SrcFormat));
+                }
+            }
+        }
+    }
+    srcsurface->UnlockPixels();
+}
+
+// Mask clipped blit, blends the source over the surface where the mask is
+// set, words of an A1 mask that are all clear are skipped
+void CGraphicSurfaceSoftware::CopyMaskSurface(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, std::shared_ptr<CGraphicSurface> masksurface, int sxpos, int sypos){
+    int SrcStride, MaskStride;
+    int MaskX = 0, MaskY = 0, Width = -1, Height = -1;
+    const uint8_t *SrcPixels, *MaskPixels;
+
+    if(!srcsurface||!masksurface){
+        return;
+    }
+    if(!ClipBlit(dxpos, dypos, Width, Height, MaskX, MaskY, masksurface->Width(), masksurface->Height(), DWidth, DHeight)){
+        return;
+    }
+    SrcPixels = srcsurface->LockPixels(SrcStride);
+    MaskPixels = masksurface->LockPixels(MaskStride);
+    if(SrcPixels && MaskPixels){
+        ESurfaceFormat SrcFormat = srcsurface->Format();
+        ESurfaceFormat MaskFormat = masksurface->Format();
+
+        for(int Row = 0; Row < Height; Row++){
+            int SrcY = sypos + MaskY + Row;
+            const uint8_t *Mask = MaskPixels + MaskStride * (MaskY + Row);
+            uint8_t *Dest = (uint8_t *)DPixels.data() + DStride * (dypos + Row);
+
+            if((0 > SrcY)||(SrcY >= srcsurface->Height())){
+                continue;
+            }
+            for(int Col = 0; Col < Width; Col++){
+                int XPos = MaskX + Col;
+                int SrcX = sxpos + XPos;
+                uint32_t Coverage;
+
+                if(ESurfaceFormat::A1 == MaskFormat){
+                    uint32_t Word = ((const uint32_t *)Mask)[XPos >> 5] >> (XPos & 0x1F);
+
+                    if(!Word){
+                        Col += 0x1F - (XPos & 0x1F);
+                        continue;
+                    }
+                    Coverage = Word & 0x1 ? 0xFF : 0x00;
+                }
+                else{
+                    Coverage = ReadPixel(Mask, XPos, MaskFormat) >> 24;
+                }
+                if(!Coverage||(0 > SrcX)||(SrcX >= srcsurface->Width())){
+                    continue;
+                }
+                uint32_t Pixel = ReadPixel(SrcPixels + SrcStride * SrcY, SrcX, SrcFormat);
+
+                if(0xFF != Coverage){
+                    Pixel = ScalePixel(Pixel, Coverage);
+                }
+                if(0xFF000000 != (Pixel & 0xFF000000)){
+                    Pixel = OverPixel(ReadPixel(Dest, dxpos + Col, DFormat), Pixel);
+                }
+                WritePixel(Dest, dxpos + Col, DFormat, Pixel);
+            }
+        }
+    }
+    srcsurface->UnlockPixels();
+    masksurface->UnlockPixels();
+}
+
+void CGraphicSurfaceSoftware::Transform(std::shared_ptr<CGraphicSurface> srcsurface, int dxpos, int dypos, int width, int height, int sxpos, int sypos, void *calldata, TGraphicSurfaceTransformCallback callback){
+    std::vector< uint32_t > BufferedPixels;
+    int SrcStride;
+    const uint8_t *SrcPixels;
+
+    if(!srcsurface||!DirectFormat(DFormat)||!DirectFormat(srcsurface->Format())){
+        return;
+    }
+    if(!ClipBlit(dxpos, dypos, width, height, sxpos, sypos, srcsurface->Width(), srcsurface->Height(), DWidth, DHeight)){
+        return;
+    }
+    // Buffered as the source may be the surface itself
+    SrcPixels = srcsurface->LockPixels(SrcStride);
+    if(SrcPixels){
+        ESurfaceFormat SrcFormat = srcsurface->Format();
+
+        BufferedPixels.reserve(width * height);
+        for(int Row = 0; Row < height; Row++){
+            for(int Col = 0; Col < width; Col++){
+                BufferedPixels.push_back(callback(calldata, ReadPixel(SrcPixels + SrcStride * (sypos + Row), sxpos + Col, SrcFormat)));
+            }
+        }
+    }
+    srcsurface->UnlockPixels();
+    for(int Row = 0; Row < height && BufferedPixels.size(); Row++){
+        std::copy(BufferedPixels.begin() + Row * width, BufferedPixels.begin() + (Row + 1) * width, DPixels.begin() + (DStride / sizeof(uint32_t)) * (dypos + Row) + dxpos);
+    }
+}
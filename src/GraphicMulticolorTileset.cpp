@@ -15,10 +15,15 @@
     ownership of this material.
 */
 #include "GraphicMulticolorTileset.h"
+#include "GraphicFactory.h"
+#include "MapBundle.h"
+#include "DataSink.h"
+#include <algorithm>
 //#include "Debug.h"
 
 CGraphicMulticolorTileset::CGraphicMulticolorTileset() : CGraphicTileset(){
-    
+    DSourceChecksum = 0;
+    DSourceChecksumValid = false;
 }
 
 CGraphicMulticolorTileset::~CGraphicMulticolorTileset(){
@@ -31,23 +36,159 @@ bool CGraphicMulticolorTileset::LoadTileset(std::shared_ptr< CGraphicRecolorMap
         return false;
     }
     
-    DColoredTilesets.clear();
-    DColoredTilesets.push_back(DSurfaceTileset);
-    for(int ColIndex = 1; ColIndex < colormap->GroupCount(); ColIndex++){
-        DColoredTilesets.push_back(colormap->RecolorSurface(ColIndex, DSurfaceTileset));
+    // The other colors are recolored on first use by ColoredTileset
+    DColoredTilesets.assign(std::max(1, colormap->GroupCount()), nullptr);
+    DColoredTilesets[0] = DSurfaceTileset;
+    DSourceChecksumValid = false;
+    UpdateTileBounds();
+    
+    return true;
+}
+
+// Finds the smallest rectangle of each tile holding all of its non transparent
+// pixels, so the transparent border does not have to be blended
+void CGraphicMulticolorTileset::UpdateTileBounds(){
+    int Stride;
+    uint8_t *Pixels = nullptr;
+    
+    DTileBounds.assign(DTileCount, SRectangle{0, 0, DTileWidth, DTileHeight});
+    if(CGraphicSurface::ESurfaceFormat::ARGB32 == DSurfaceTileset->Format()){
+        Pixels = DSurfaceTileset->LockPixels(Stride);
     }
+    if(!Pixels){
+        return;
+    }
+    for(int Index = 0; Index < DTileCount; Index++){
+        int Left = DTileWidth, Top = DTileHeight, Right = 0, Bottom = 0;
+        
+        for(int YPos = 0; YPos < DTileHeight; YPos++){
+            const uint32_t *Pixel = (const uint32_t *)(Pixels + Stride * (Index * DTileHeight + YPos));
+            
+            for(int XPos = 0; XPos < DTileWidth; XPos++){
+                if(Pixel[XPos] & 0xFF000000){
+                    Left = std::min(Left, XPos);
+                    Right = std::max(Right, XPos + 1);
+                    Top = std::min(Top, YPos);
+                    Bottom = YPos + 1;
+                }
+            }
+        }
+        DTileBounds[Index] = Left < Right ? SRectangle{Left, Top, Right - Left, Bottom - Top} : SRectangle{0, 0, 0, 0};
+    }
+    DSurfaceTileset->UnlockPixels();
+}
+
+std::shared_ptr< CGraphicSurface > CGraphicMulticolorTileset::ColoredTileset(int colorindex){
+    if((0 > colorindex)||(colorindex >= DColoredTilesets.size())){
+        return nullptr;
+    }
+    if(!DColoredTilesets[colorindex]){
+        DColoredTilesets[colorindex] = LoadCachedColor(colorindex);
+        if(!DColoredTilesets[colorindex]){
+            DColoredTilesets[colorindex] = DColorMap->RecolorSurface(colorindex, DSurfaceTileset);
+            StoreCachedColor(colorindex);
+        }
+    }
+    return DColoredTilesets[colorindex];
+}
+
+// Recolored tilesets are cached as a header of magic, version, width, height
+// and key followed by the raw ARGB32 rows, in native byte order. The key is
+// the checksum of the source tileset and of the colors it is recolored with,
+// so the cache is rebuilt whenever either changes.
+static const uint32_t CacheMagic = 0x52434C52;
+static const uint32_t CacheVersion = 1;
+
+uint32_t CGraphicMulticolorTileset::CacheKey(int colorindex){
+    if(!DSourceChecksumValid){
+        int Stride;
+        uint8_t *Pixels = DSurfaceTileset->LockPixels(Stride);
+        
+        DSourceChecksum = Pixels ? CMapBundle::Checksum(Pixels, size_t(Stride) * DSurfaceTileset->Height()) : 0;
+        DSourceChecksumValid = true;
+        DSurfaceTileset->UnlockPixels();
+    }
+    std::vector< uint32_t > KeyData{DSourceChecksum};
     
+    for(int Index = 0; Index < DColorMap->ColorCount(); Index++){
+        KeyData.push_back(DColorMap->ColorValue(0, Index));
+        KeyData.push_back(DColorMap->ColorValue(colorindex, Index));
+    }
+    return CMapBundle::Checksum((const uint8_t *)KeyData.data(), KeyData.size() * sizeof(uint32_t));
+}
+
+// Sources may return less than asked for, reads until all of it is read
+static bool ReadAll(std::shared_ptr< CDataSource > source, uint8_t *data, int length){
+    while(length){
+        int BytesRead = source->Read(data, length);
+        
+        if(0 >= BytesRead){
+            return false;
+        }
+        data += BytesRead;
+        length -= BytesRead;
+    }
     return true;
 }
 
+std::shared_ptr< CGraphicSurface > CGraphicMulticolorTileset::LoadCachedColor(int colorindex){
+    if(!DCacheContainer||(CGraphicSurface::ESurfaceFormat::ARGB32 != DSurfaceTileset->Format())){
+        return nullptr;
+    }
+    auto Source = DCacheContainer->DataSource(DCacheName + "." + std::to_string(colorindex) + ".rcl");
+    uint32_t Header[5];
+    
+    if(!Source||!ReadAll(Source, (uint8_t *)Header, sizeof(Header))){
+        return nullptr;
+    }
+    if((CacheMagic != Header[0])||(CacheVersion != Header[1])||(DSurfaceTileset->Width() != Header[2])||(DSurfaceTileset->Height() != Header[3])||(CacheKey(colorindex) != Header[4])){
+        return nullptr;
+    }
+    auto Surface = CGraphicFactory::CreateSurface(Header[2], Header[3], CGraphicSurface::ESurfaceFormat::ARGB32);
+    int Stride, RowLength = Header[2] * sizeof(uint32_t);
+    uint8_t *Pixels = Surface->LockPixels(Stride);
+    bool Success = nullptr != Pixels;
+    
+    for(int Row = 0; Success && (Row < Header[3]); Row++){
+        Success = ReadAll(Source, Pixels + Stride * Row, RowLength);
+    }
+    Surface->UnlockPixels();
+    return Success ? Surface : nullptr;
+}
+
+void CGraphicMulticolorTileset::StoreCachedColor(int colorindex){
+    auto Surface = DColoredTilesets[colorindex];
+    
+    if(!DCacheContainer||!Surface||(CGraphicSurface::ESurfaceFormat::ARGB32 != Surface->Format())){
+        return;
+    }
+    auto Sink = DCacheContainer->DataSink(DCacheName + "." + std::to_string(colorindex) + ".rcl");
+    uint32_t Header[5] = {CacheMagic, CacheVersion, uint32_t(Surface->Width()), uint32_t(Surface->Height()), CacheKey(colorindex)};
+    int Stride, RowLength = Surface->Width() * sizeof(uint32_t);
+    uint8_t *Pixels = Surface->LockPixels(Stride);
+    
+    if(!Sink||!Pixels||(sizeof(Header) != Sink->Write(Header, sizeof(Header)))){
+        Surface->UnlockPixels();
+        return;
+    }
+    for(int Row = 0; Row < Surface->Height(); Row++){
+        if(RowLength != Sink->Write(Pixels + Stride * Row, RowLength)){
+            break;
+        }
+    }
+    Surface->UnlockPixels();
+}
+
 void CGraphicMulticolorTileset::DrawTile(std::shared_ptr<CGraphicSurface> surface, int xpos, int ypos, int tileindex, int colorindex){
     if((0 > tileindex)||(tileindex >= DTileCount)){
         return;
     }
-    if((0 > colorindex)||(colorindex >= DColoredTilesets.size())){
+    auto Tileset = ColoredTileset(colorindex);
+    
+    if(!Tileset){
         return;    
     }
     
-    surface->Draw(DColoredTilesets[colorindex], xpos, ypos, DTileWidth, DTileHeight, 0, tileindex * DTileHeight);
+    surface->Draw(Tileset, xpos, ypos, DTileWidth, DTileHeight, 0, tileindex * DTileHeight);
 }
 
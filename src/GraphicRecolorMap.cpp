@@ -18,6 +18,9 @@
 #include "GraphicFactory.h"
 #include "CommentSkipLineDataSource.h"
 #include "Debug.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
         
 CGraphicRecolorMap::CGraphicRecolorMap(){
     
@@ -27,14 +30,15 @@ CGraphicRecolorMap::~CGraphicRecolorMap(){
     
 }
 
-uint32_t CGraphicRecolorMap::RecolorPixels(void *data, uint32_t pixel){
-    CGraphicRecolorMap *RecolorMap = static_cast<CGraphicRecolorMap *>(data);
+// Replaces the first color of from that matches the opaque pixel with the
+// color of to, and premultiplies the result by the alpha of the pixel
+static inline uint32_t RecolorPixel(uint32_t pixel, const uint32_t *from, const uint32_t *to, int colorcount){
     uint32_t Alpha = pixel & 0xFF000000;
 
     pixel |= 0xFF000000;
-    for(size_t Index = 0; Index < RecolorMap->DColors[0].size(); Index++){
-        if(pixel == RecolorMap->DColors[0][Index]){
-            pixel = RecolorMap->DColors[RecolorMap->DState][Index];
+    for(int Index = 0; Index < colorcount; Index++){
+        if(pixel == from[Index]){
+            pixel = to[Index];
             break;
         }
     }
@@ -45,6 +49,51 @@ uint32_t CGraphicRecolorMap::RecolorPixels(void *data, uint32_t pixel){
     return 0x00000000;
 }
 
+void CGraphicRecolorMap::RecolorPixels(int index, const uint32_t *src, uint32_t *dest, int count) const{
+    const uint32_t *From = DColors[0].data();
+    const uint32_t *To = DColors[index].data();
+    int ColorCount = DColors[0].size();
+    int Index = 0;
+
+#ifdef __SSE2__
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i AlphaMask = _mm_set1_epi32(0xFF000000);
+    const __m128i One = _mm_set1_epi16(1);
+    
+    for(; Index + 4 <= count; Index += 4){
+        __m128i Src = _mm_loadu_si128((const __m128i *)(src + Index));
+        __m128i Pixel = _mm_or_si128(Src, AlphaMask);
+        __m128i Matched = Zero;
+        
+        // Palette lookup of the four pixels, the first matching color wins
+        for(int ColorIndex = 0; ColorIndex < ColorCount; ColorIndex++){
+            __m128i Match = _mm_andnot_si128(Matched, _mm_cmpeq_epi32(Pixel, _mm_set1_epi32(From[ColorIndex])));
+            
+            Pixel = _mm_or_si128(_mm_andnot_si128(Match, Pixel), _mm_and_si128(Match, _mm_set1_epi32(To[ColorIndex])));
+            Matched = _mm_or_si128(Matched, Match);
+        }
+        __m128i Alpha = _mm_srli_epi32(Src, 24);
+        
+        if(0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(Src, AlphaMask), AlphaMask))){
+            // Spread the alpha of each pixel over the four 16 bit channels of
+            // its pixel, the alpha channel itself becomes 255 * alpha / 255
+            Alpha = _mm_or_si128(Alpha, _mm_slli_epi32(Alpha, 16));
+            __m128i Low = _mm_mullo_epi16(_mm_unpacklo_epi8(Pixel, Zero), _mm_unpacklo_epi32(Alpha, Alpha));
+            __m128i High = _mm_mullo_epi16(_mm_unpackhi_epi8(Pixel, Zero), _mm_unpackhi_epi32(Alpha, Alpha));
+            
+            // Divide by 255 per channel, rounding down
+            Low = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(Low, One), _mm_srli_epi16(Low, 8)), 8);
+            High = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(High, One), _mm_srli_epi16(High, 8)), 8);
+            Pixel = _mm_packus_epi16(Low, High);
+        }
+        _mm_storeu_si128((__m128i *)(dest + Index), Pixel);
+    }
+#endif
+    for(; Index < count; Index++){
+        dest[Index] = RecolorPixel(src[Index], From, To, ColorCount);
+    }
+}
+
 uint32_t CGraphicRecolorMap::ObservePixels(void *data, uint32_t pixel){
     CGraphicRecolorMap *RecolorMap = static_cast<CGraphicRecolorMap *>(data);
     int Row = RecolorMap->DState / RecolorMap->DColors[0].size();
@@ -128,14 +177,38 @@ bool CGraphicRecolorMap::Load(std::shared_ptr< CDataSource > source){
 }
 
 
-std::shared_ptr<CGraphicSurface> CGraphicRecolorMap::RecolorSurface(int index, std::shared_ptr<CGraphicSurface> srcsurface){
+std::shared_ptr<CGraphicSurface> CGraphicRecolorMap::RecolorSurface(int index, std::shared_ptr<CGraphicSurface> srcsurface) const{
     if((0 > index)||(index >= DColors.size())){
         return nullptr;
     }
-    DState = index;
-    auto RecoloredSurface = CGraphicFactory::CreateSurface(srcsurface->Width(), srcsurface->Height(), srcsurface->Format()); 
-    RecoloredSurface->Transform(srcsurface, 0, 0, -1, -1, 0, 0, (void *)this, RecolorPixels);
+    CGraphicSurface::ESurfaceFormat Format = srcsurface->Format();
+    
+    if((CGraphicSurface::ESurfaceFormat::ARGB32 != Format)&&(CGraphicSurface::ESurfaceFormat::RGB24 != Format)){
+        return nullptr;
+    }
+    auto RecoloredSurface = CGraphicFactory::CreateSurface(srcsurface->Width(), srcsurface->Height(), Format); 
+    std::vector< uint32_t > OpaqueRow;
+    int SrcStride, DestStride;
+    const uint8_t *SrcPixels = srcsurface->LockPixels(SrcStride);
+    uint8_t *DestPixels = RecoloredSurface->LockPixels(DestStride);
+    
+    if(SrcPixels && DestPixels){
+        for(int Row = 0; Row < srcsurface->Height(); Row++){
+            const uint32_t *Source = (const uint32_t *)(SrcPixels + SrcStride * Row);
+            
+            // The unused byte of RGB24 pixels is undefined
+            if(CGraphicSurface::ESurfaceFormat::RGB24 == Format){
+                OpaqueRow.assign(Source, Source + srcsurface->Width());
+                for(auto &Pixel : OpaqueRow){
+                    Pixel |= 0xFF000000;
+                }
+                Source = OpaqueRow.data();
+            }
+            RecolorPixels(index, Source, (uint32_t *)(DestPixels + DestStride * Row), srcsurface->Width());
+        }
+    }
+    srcsurface->UnlockPixels();
+    RecoloredSurface->UnlockPixels();
     
     return RecoloredSurface;
 }
-
@@ -291,3 +291,39 @@ void CGraphicTileset::DrawClipped(std::shared_ptr<CGraphicSurface> surface, int
     ResourceContext->MaskSurface(DClippingMasks[tileindex], xpos, ypos);
     ResourceContext->Fill();
 }
+
+bool CGraphicTileset::ClippedPixel(int tileindex, int xpos, int ypos) const{
+    if((0 > tileindex)||(tileindex >= DClippingMasks.size())){
+        return false;
+    }
+    if((0 > xpos)||(0 > ypos)||(xpos >= DTileWidth)||(ypos >= DTileHeight)){
+        return false;
+    }
+    // Clipping masks are A1 copies of the tile, so a pixel is in the mask when the top alpha bit is set
+    return DSurfaceTileset->PixelAt(xpos, tileindex * DTileHeight + ypos) & 0x80000000;
+}
+
+bool CGraphicTileset::TilePixels(int tileindex, uint32_t *pixels) const{
+    int Stride;
+    
+    if((0 > tileindex)||(tileindex >= DTileCount)){
+        return false;
+    }
+    auto Format = DSurfaceTileset->Format();
+    if((CGraphicSurface::ESurfaceFormat::ARGB32 != Format)&&(CGraphicSurface::ESurfaceFormat::RGB24 != Format)){
+        return false;
+    }
+    uint8_t *Pixels = DSurfaceTileset->LockPixels(Stride);
+    if(!Pixels){
+        return false;
+    }
+    for(int Row = 0; Row < DTileHeight; Row++){
+        const uint32_t *Pixel = (const uint32_t *)(Pixels + Stride * (tileindex * DTileHeight + Row));
+        
+        for(int Col = 0; Col < DTileWidth; Col++){
+            *pixels++ = CGraphicSurface::ESurfaceFormat::RGB24 == Format ? Pixel[Col] | 0xFF000000 : Pixel[Col];
+        }
+    }
+    DSurfaceTileset->UnlockPixels();
+    return true;
+}
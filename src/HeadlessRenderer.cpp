@@ -0,0 +1,219 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#include "HeadlessRenderer.h"
+#include "GameModel.h"
+#include "MemoryDataSource.h"
+#include "Debug.h"
+
+/**
+* Loads a tileset from the image directory
+*
+* @param[in] imagedirectory The image directory of the data
+* @param[in] filename Name of the tileset file
+* @param[in] clippingmasks Create the clipping masks of the tileset
+*
+* @return The tileset, nullptr if it failed to load
+*
+*/
+std::shared_ptr< CGraphicTileset > CHeadlessRenderer::LoadTileset(std::shared_ptr< CDataContainer > imagedirectory, const std::string &filename, bool clippingmasks){
+    auto Tileset = std::make_shared< CGraphicTileset >();
+
+    if(!Tileset->LoadTileset(imagedirectory->DataSource(filename))){
+        PrintError("Failed to load %s.\n", filename.c_str());
+        return nullptr;
+    }
+    if(clippingmasks){
+        Tileset->CreateClippingMasks();
+    }
+    return Tileset;
+}
+
+/**
+* Loads the tilesets, recolor maps and map rendering configuration used by
+* the battle renderers, the same files ApplicationData loads for a battle.
+* Also sets the tile dimensions of positions, so it must be called before
+* any game model is created.
+*
+* @param[in] imagedirectory The image directory of the data
+*
+* @return true if all loaded
+*
+*/
+bool CHeadlessRenderer::LoadTilesets(std::shared_ptr< CDataContainer > imagedirectory){
+    const std::vector< std::pair< EAssetType, std::string > > AssetFiles = {
+        {EAssetType::Peasant, "Peasant.dat"},
+        {EAssetType::Footman, "Footman.dat"},
+        {EAssetType::Archer, "Archer.dat"},
+        {EAssetType::Ranger, "Ranger.dat"},
+        {EAssetType::GoldMine, "GoldMine.dat"},
+        {EAssetType::TownHall, "TownHall.dat"},
+        {EAssetType::Keep, "Keep.dat"},
+        {EAssetType::Castle, "Castle.dat"},
+        {EAssetType::Farm, "Farm.dat"},
+        {EAssetType::Wall, "Wall.dat"},
+        {EAssetType::Barracks, "Barracks.dat"},
+        {EAssetType::Blacksmith, "Blacksmith.dat"},
+        {EAssetType::LumberMill, "LumberMill.dat"},
+        {EAssetType::ScoutTower, "ScoutTower.dat"},
+        {EAssetType::GuardTower, "GuardTower.dat"},
+        {EAssetType::CannonTower, "CannonTower.dat"}
+    };
+    std::shared_ptr< CDataSource > TempDataSource;
+    char TempChar;
+
+    TempDataSource = imagedirectory->DataSource("MapRendering.dat");
+    if(!TempDataSource){
+        PrintError("Failed to load map rendering configuration.\n");
+        return false;
+    }
+    DMapRendererConfigurationData.clear();
+    while(1 == TempDataSource->Read(&TempChar, 1)){
+        DMapRendererConfigurationData.push_back(TempChar);
+    }
+
+    DPlayerRecolorMap = std::make_shared< CGraphicRecolorMap >();
+    if(!DPlayerRecolorMap->Load(imagedirectory->DataSource("Colors.dat"))){
+        PrintError("Failed to load recolor map.\n");
+        return false;
+    }
+    DAssetRecolorMap = std::make_shared< CGraphicRecolorMap >();
+    if(!DAssetRecolorMap->Load(imagedirectory->DataSource("AssetColor.dat"))){
+        PrintError("Failed to load asset color map.\n");
+        return false;
+    }
+
+    DTerrainTileset = LoadTileset(imagedirectory, "Terrain.dat", true);
+    DFogTileset = LoadTileset(imagedirectory, "Fog.dat", false);
+    DMarkerTileset = LoadTileset(imagedirectory, "Marker.dat", true);
+    DCorpseTileset = LoadTileset(imagedirectory, "Corpse.dat", true);
+    DBuildingDeathTileset = LoadTileset(imagedirectory, "BuildingDeath.dat", true);
+    DArrowTileset = LoadTileset(imagedirectory, "Arrow.dat", true);
+    DFireTilesets.clear();
+    DFireTilesets.push_back(LoadTileset(imagedirectory, "FireSmall.dat", true));
+    DFireTilesets.push_back(LoadTileset(imagedirectory, "FireLarge.dat", true));
+    if(!DTerrainTileset || !DFogTileset || !DMarkerTileset || !DCorpseTileset || !DBuildingDeathTileset || !DArrowTileset || !DFireTilesets[0] || !DFireTilesets[1]){
+        return false;
+    }
+    CPosition::SetTileDimensions(DTerrainTileset->TileWidth(), DTerrainTileset->TileHeight());
+
+    DAssetTilesets.clear();
+    DAssetTilesets.resize(to_underlying(EAssetType::Max));
+    for(auto &AssetFile : AssetFiles){
+        auto Tileset = std::make_shared< CGraphicMulticolorTileset >();
+
+        if(!Tileset->LoadTileset(DPlayerRecolorMap, imagedirectory->DataSource(AssetFile.second))){
+            PrintError("Failed to load %s.\n", AssetFile.second.c_str());
+            return false;
+        }
+        Tileset->CreateClippingMasks();
+        DAssetTilesets[to_underlying(AssetFile.first)] = Tileset;
+    }
+    return true;
+}
+
+/**
+* Creates the renderers for the view of a player of a game model, with the
+* viewport centered on the first asset of the player
+*
+* @param[in] gamemodel The game model to render
+* @param[in] color The player whose view is rendered
+* @param[in] viewportwidth Width of the viewport surfaces that will be drawn
+* @param[in] viewportheight Height of the viewport surfaces that will be drawn
+*
+* @return Nothing
+*
+*/
+void CHeadlessRenderer::CreateRenderers(std::shared_ptr< CGameModel > gamemodel, EPlayerColor color, int viewportwidth, int viewportheight){
+    auto PlayerData = gamemodel->Player(color);
+
+    // Recolor the tilesets for the colors in play before the first frame
+    for(int Index = 1; Index < to_underlying(EPlayerColor::Max); Index++){
+        if(gamemodel->Player(static_cast<EPlayerColor>(Index))->IsAlive()){
+            for(auto &Tileset : DAssetTilesets){
+                if(Tileset){
+                    Tileset->ColoredTileset(Index - 1);
+                }
+            }
+        }
+    }
+    DMapRenderer = std::make_shared< CMapRenderer >(std::make_shared< CMemoryDataSource >(DMapRendererConfigurationData), DTerrainTileset, PlayerData->PlayerMap());
+    DAssetRenderer = std::make_shared< CAssetRenderer >(DAssetRecolorMap, DAssetTilesets, DMarkerTileset, DCorpseTileset, DFireTilesets, DBuildingDeathTileset, DArrowTileset, PlayerData, PlayerData->PlayerMap());
+    DFogRenderer = std::make_shared< CFogRenderer >(DFogTileset, PlayerData->VisibilityMap());
+    DViewportRenderer = std::make_shared< CViewportRenderer >(DMapRenderer, DAssetRenderer, DFogRenderer);
+    DMiniMapRenderer = std::make_shared< CMiniMapRenderer >(DMapRenderer, DAssetRenderer, DFogRenderer, DViewportRenderer, CGraphicSurface::ESurfaceFormat::ARGB32);
+
+    DViewportRenderer->InitViewportDimensions(viewportwidth, viewportheight);
+    for(auto WeakAsset : PlayerData->Assets()){
+        if(auto Asset = WeakAsset.lock()){
+            DViewportRenderer->CenterViewport(Asset->Position());
+            break;
+        }
+    }
+}
+
+/**
+* Width of the whole map in pixels
+*
+* @return Width of the map, 0 before the renderers are created
+*
+*/
+int CHeadlessRenderer::DetailedMapWidth() const{
+    return DMapRenderer ? DMapRenderer->DetailedMapWidth() : 0;
+}
+
+/**
+* Height of the whole map in pixels
+*
+* @return Height of the map, 0 before the renderers are created
+*
+*/
+int CHeadlessRenderer::DetailedMapHeight() const{
+    return DMapRenderer ? DMapRenderer->DetailedMapHeight() : 0;
+}
+
+/**
+* Draws the viewport without any selection or building placement
+*
+* @param[in] surface The surface to draw into
+*
+* @return Nothing
+*
+*/
+void CHeadlessRenderer::DrawViewport(std::shared_ptr< CGraphicSurface > surface){
+    std::list< std::weak_ptr< CPlayerAsset > > SelectionMarkerList;
+    SRectangle SelectRectangle({0, 0, 0, 0});
+
+    DViewportRenderer->DrawViewport(surface, SelectionMarkerList, SelectRectangle, EAssetCapabilityType::None);
+}
+
+/**
+* Draws the minimap over a black background, as the minimap only covers
+* the part of the surface with the aspect ratio of the map
+*
+* @param[in] surface The surface to draw into
+*
+* @return Nothing
+*
+*/
+void CHeadlessRenderer::DrawMiniMap(std::shared_ptr< CGraphicSurface > surface){
+    auto ResourceContext = surface->CreateResourceContext();
+
+    ResourceContext->SetSourceRGB(0x000000);
+    ResourceContext->Rectangle(0, 0, surface->Width(), surface->Height());
+    ResourceContext->Fill();
+    DMiniMapRenderer->DrawMiniMap(surface);
+}
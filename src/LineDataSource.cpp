@@ -31,6 +31,8 @@
  *
 */
 #include "LineDataSource.h"
+#include <algorithm>
+#include <cstring>
 
 /**
  * Constructor to instantiate CLineDataSource object
@@ -44,16 +46,37 @@ CLineDataSource::CLineDataSource(std::shared_ptr< CDataSource > source){
 }
 
 /**
- * Reads the line of text until reaching a new line character
+ * Reads the line of text until reaching a new line character. Buffered
+ * sources are scanned a block at a time and only the bytes up to and
+ * including the new line are consumed, so later readers of the same source
+ * continue at the next line.
  *
  * @param[in] line std::string reference to text this function will read
  *
  * @return bool True if reached a new line character
 */
 bool CLineDataSource::Read(std::string &line){
+    const void *Block;
+    int BlockLength;
     char TempChar;
     
     line.clear();
+    while(0 < (BlockLength = DDataSource->Peek(Block))){
+        const char *Start = (const char *)Block;
+        const char *NewLine = (const char *)memchr(Start, '\n', BlockLength);
+        int LineLength = NewLine ? NewLine - Start : BlockLength;
+
+        line.append(Start, LineLength);
+        DDataSource->Skip(NewLine ? LineLength + 1 : LineLength);
+        if(NewLine){
+            StripCarriageReturns(line);
+            return true;
+        }
+    }
+    if(0 == BlockLength){
+        StripCarriageReturns(line);
+        return 0 < line.length();
+    }
     while(true){
         if(0 < DDataSource->Read(&TempChar, 1)){
             // Check until reach a new line character
@@ -72,3 +95,15 @@ bool CLineDataSource::Read(std::string &line){
     
 }
 
+/**
+ * Removes the carriage returns of a line read a block at a time
+ *
+ * @param[in] line std::string reference to the line
+ *
+ * @return None
+*/
+void CLineDataSource::StripCarriageReturns(std::string &line){
+    if(std::string::npos != line.find('\r')){
+        line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+    }
+}
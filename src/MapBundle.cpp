@@ -0,0 +1,296 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#include "MapBundle.h"
+#include "Debug.h"
+
+#define MAP_BUNDLE_HEADER_SIZE  20
+
+const std::string CMapBundle::DExtension = ".mapb";
+const uint32_t CMapBundle::DMagic = 0x424D4357; // "WCMB"
+const uint32_t CMapBundle::DVersion = 2;
+
+static void EncodeUInt32(uint8_t *dest, uint32_t value){
+    dest[0] = value;
+    dest[1] = value >> 8;
+    dest[2] = value >> 16;
+    dest[3] = value >> 24;
+}
+
+static uint32_t DecodeUInt32(const uint8_t *src){
+    return uint32_t(src[0]) | (uint32_t(src[1]) << 8) | (uint32_t(src[2]) << 16) | (uint32_t(src[3]) << 24);
+}
+
+CMapBundleWriter::CMapBundleWriter(){
+    DSourceChecksum = 0;
+}
+
+/**
+* Appends an integer to the payload
+*
+* @param[in] value The integer
+*
+* @return Nothing
+*
+*/
+void CMapBundleWriter::WriteInt(int32_t value){
+    uint8_t Bytes[4];
+
+    EncodeUInt32(Bytes, value);
+    DPayload.insert(DPayload.end(), Bytes, Bytes + 4);
+}
+
+/**
+* Appends a length prefixed string to the payload
+*
+* @param[in] str The string
+*
+* @return Nothing
+*
+*/
+void CMapBundleWriter::WriteString(const std::string &str){
+    WriteInt(str.length());
+    DPayload.insert(DPayload.end(), str.begin(), str.end());
+}
+
+/**
+* Appends raw bytes to the payload
+*
+* @param[in] data The bytes
+* @param[in] length Number of bytes
+*
+* @return Nothing
+*
+*/
+void CMapBundleWriter::WriteBytes(const uint8_t *data, int length){
+    DPayload.insert(DPayload.end(), data, data + length);
+}
+
+/**
+* Writes the header and payload of the bundle
+*
+* @param[in] sink Where the bundle is written
+*
+* @return true if all was written
+*
+*/
+bool CMapBundleWriter::Save(std::shared_ptr< CDataSink > sink) const{
+    uint8_t Header[MAP_BUNDLE_HEADER_SIZE];
+
+    if(!sink){
+        return false;
+    }
+    EncodeUInt32(Header, CMapBundle::DMagic);
+    EncodeUInt32(Header + 4, CMapBundle::DVersion);
+    EncodeUInt32(Header + 8, DPayload.size());
+    EncodeUInt32(Header + 12, CMapBundle::Checksum(DPayload.data(), DPayload.size()));
+    EncodeUInt32(Header + 16, DSourceChecksum);
+    if(MAP_BUNDLE_HEADER_SIZE != sink->Write(Header, MAP_BUNDLE_HEADER_SIZE)){
+        return false;
+    }
+    return int(DPayload.size()) == sink->Write(DPayload.data(), DPayload.size());
+}
+
+CMapBundleReader::CMapBundleReader(const uint8_t *data, int length){
+    DData = data;
+    DLength = data ? length : 0;
+    DOffset = 0;
+    DValid = nullptr != data;
+}
+
+/**
+* Reads an integer from the payload
+*
+* @param[out] value The integer read
+*
+* @return true if read
+*
+*/
+bool CMapBundleReader::ReadInt(int &value){
+    const uint8_t *Bytes = ReadBytes(4);
+
+    if(!Bytes){
+        return false;
+    }
+    value = int32_t(DecodeUInt32(Bytes));
+    return true;
+}
+
+/**
+* Reads a length prefixed string from the payload
+*
+* @param[out] str The string read
+*
+* @return true if read
+*
+*/
+bool CMapBundleReader::ReadString(std::string &str){
+    int Length;
+    const uint8_t *Bytes;
+
+    if(!ReadInt(Length)){
+        return false;
+    }
+    Bytes = ReadBytes(Length);
+    if(!Bytes){
+        return false;
+    }
+    str.assign((const char *)Bytes, Length);
+    return true;
+}
+
+/**
+* Reads raw bytes from the payload without copying them
+*
+* @param[in] length Number of bytes
+*
+* @return Pointer to the bytes in the bundle, nullptr if past the end
+*
+*/
+const uint8_t *CMapBundleReader::ReadBytes(int length){
+    const uint8_t *Bytes;
+
+    if(!DValid || (0 > length) || (DLength - DOffset < length)){
+        DValid = false;
+        return nullptr;
+    }
+    Bytes = DData + DOffset;
+    DOffset += length;
+    return Bytes;
+}
+
+CMapBundle::CMapBundle(){
+    DPayload = nullptr;
+    DPayloadLength = 0;
+    DSourceChecksum = 0;
+}
+
+/**
+* Calculates the 32 bit FNV-1a hash of data
+*
+* @param[in] data The data
+* @param[in] length Number of bytes
+*
+* @return The hash
+*
+*/
+uint32_t CMapBundle::Checksum(const uint8_t *data, size_t length){
+    uint32_t Hash = 2166136261U;
+
+    for(size_t Index = 0; Index < length; Index++){
+        Hash ^= data[Index];
+        Hash *= 16777619U;
+    }
+    return Hash;
+}
+
+/**
+* Calculates the 32 bit FNV-1a hash of all the data of a source, such as
+* the .map a bundle was compiled from
+*
+* @param[in] source The source, read to its end
+*
+* @return The hash
+*
+*/
+uint32_t CMapBundle::Checksum(std::shared_ptr< CDataSource > source){
+    uint32_t Hash = 2166136261U;
+    const void *View;
+    uint8_t Buffer[4096];
+    int Length;
+
+    if(!source){
+        return Hash;
+    }
+    if((View = source->View(Length))){
+        return Checksum((const uint8_t *)View, Length);
+    }
+    while(0 < (Length = source->Read(Buffer, sizeof(Buffer)))){
+        for(int Index = 0; Index < Length; Index++){
+            Hash ^= Buffer[Index];
+            Hash *= 16777619U;
+        }
+    }
+    return Hash;
+}
+
+/**
+* Checks the header and checksum of a bundle, setting the payload if valid
+*
+* @param[in] data The whole bundle
+* @param[in] length Length of the bundle
+*
+* @return true if valid
+*
+*/
+bool CMapBundle::Validate(const uint8_t *data, size_t length){
+    if(MAP_BUNDLE_HEADER_SIZE > length){
+        PrintError("Map bundle too short.\n");
+        return false;
+    }
+    if(DMagic != DecodeUInt32(data)){
+        PrintError("Not a map bundle.\n");
+        return false;
+    }
+    if(DVersion != DecodeUInt32(data + 4)){
+        PrintError("Unsupported map bundle version %u.\n", DecodeUInt32(data + 4));
+        return false;
+    }
+    if(length - MAP_BUNDLE_HEADER_SIZE != DecodeUInt32(data + 8)){
+        PrintError("Map bundle length mismatch.\n");
+        return false;
+    }
+    if(Checksum(data + MAP_BUNDLE_HEADER_SIZE, length - MAP_BUNDLE_HEADER_SIZE) != DecodeUInt32(data + 12)){
+        PrintError("Map bundle checksum mismatch.\n");
+        return false;
+    }
+    DPayload = data + MAP_BUNDLE_HEADER_SIZE;
+    DPayloadLength = length - MAP_BUNDLE_HEADER_SIZE;
+    DSourceChecksum = DecodeUInt32(data + 16);
+    return true;
+}
+
+/**
+* Loads and validates a bundle. Sources with a view (such as memory mapped
+* files) are validated and read in place, other sources are read into
+* memory.
+*
+* @param[in] source Source of the bundle
+*
+* @return true if the bundle is valid
+*
+*/
+bool CMapBundle::Load(std::shared_ptr< CDataSource > source){
+    const void *View;
+    int Length;
+
+    if(!source){
+        return false;
+    }
+    if((View = source->View(Length))){
+        // The view is only valid as long as its source
+        DSource = source;
+        return Validate((const uint8_t *)View, Length);
+    }
+
+    uint8_t Buffer[4096];
+
+    DBuffer.clear();
+    while(0 < (Length = source->Read(Buffer, sizeof(Buffer)))){
+        DBuffer.insert(DBuffer.end(), Buffer, Buffer + Length);
+    }
+    return Validate(DBuffer.data(), DBuffer.size());
+}
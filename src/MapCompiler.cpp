@@ -0,0 +1,124 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+
+/**
+ * @brief
+ *      MapCompiler.cpp , compiles .map files into .mapb map bundles
+ *
+ *      mapcompiler [-o outputdir] file.map ...
+ *
+ *      Each bundle is written next to its .map file unless an output
+ *      directory is given, and is loaded back to validate it. Bundles keep
+ *      the checksum of their .map, so an edited .map is loaded instead of
+ *      its stale bundle.
+ *
+*/
+#include "AssetDecoratedMap.h"
+#include "FileDataSource.h"
+#include "FileDataSink.h"
+#include "MapBundle.h"
+#include "Path.h"
+#include "Debug.h"
+#include <cstdlib>
+#include <unistd.h>
+
+#ifndef DEBUG_LEVEL
+#define DEBUG_LEVEL DEBUG_LOW
+#endif
+
+/**
+ * Compiles a single map
+ *
+ * @param[in] mapfile Path of the .map file
+ * @param[in] outputdir Directory of the bundle, the directory of the map if empty
+ *
+ * @return true if the bundle was written and loads back
+*/
+static bool CompileMap(const std::string &mapfile, const std::string &outputdir){
+    CAssetDecoratedMap Map, CheckMap;
+    CMapBundleWriter Writer;
+    CMapBundle Bundle;
+    CPath MapPath(mapfile);
+    std::string BaseName = MapPath.Component(MapPath.ComponentCount() - 1);
+    std::string BundleFile;
+
+    if((BaseName.length() <= 4)||(BaseName.rfind(".map") != (BaseName.length() - 4))){
+        PrintError("\"%s\" is not a .map file.\n", mapfile.c_str());
+        return false;
+    }
+    BaseName = BaseName.substr(0, BaseName.length() - 4) + CMapBundle::DExtension;
+    BundleFile = outputdir.empty() ? MapPath.Containing().Simplify(CPath(BaseName)).ToString() : CPath(outputdir).Simplify(CPath(BaseName)).ToString();
+
+    if(!Map.LoadMap(std::make_shared< CFileDataSource >(mapfile, -1, true))){
+        PrintError("Failed to load map \"%s\".\n", mapfile.c_str());
+        return false;
+    }
+    Map.SaveMap(Writer);
+    Writer.SourceChecksum(CMapBundle::Checksum(std::make_shared< CFileDataSource >(mapfile, -1, true)));
+    // CFileDataSink does not truncate, an older bundle would leave its tail
+    unlink(BundleFile.c_str());
+    if(!Writer.Save(std::make_shared< CFileDataSink >(BundleFile))){
+        PrintError("Failed to write \"%s\".\n", BundleFile.c_str());
+        return false;
+    }
+    if(!Bundle.Load(std::make_shared< CFileDataSource >(BundleFile, -1, true))){
+        PrintError("Written bundle \"%s\" is invalid.\n", BundleFile.c_str());
+        return false;
+    }
+    CMapBundleReader Reader = Bundle.Reader();
+    if(!CheckMap.LoadMap(Reader)||!Reader.AtEnd()){
+        PrintError("Written bundle \"%s\" does not load.\n", BundleFile.c_str());
+        return false;
+    }
+    printf("%s -> %s\n", mapfile.c_str(), BundleFile.c_str());
+    return true;
+}
+
+/**
+ * Main function of the map compiler
+ *
+ * @param[in] argc Integer containing the number of command line arguments, indexed from 0
+ * @param[in] argv Character pointer containing the command line arguments, indexed by argc
+ *
+ * @return Exit code, 0 if all maps were compiled
+*/
+int main(int argc, char *argv[]){
+    std::string OutputDir;
+    int Failures = 0, MapCount = 0;
+
+    OpenDebug("MapCompiler.out", DEBUG_LEVEL);
+    for(int Index = 1; Index < argc; Index++){
+        std::string Argument = argv[Index];
+
+        if(Argument == "-o"){
+            if(Index + 1 >= argc){
+                break;
+            }
+            OutputDir = argv[++Index];
+            continue;
+        }
+        MapCount++;
+        if(!CompileMap(Argument, OutputDir)){
+            Failures++;
+        }
+    }
+    if(!MapCount){
+        fprintf(stderr, "Usage: %s [-o outputdir] file.map ...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    return Failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -31,12 +31,17 @@
 */
 
 #include "MapRenderer.h"
+#include "GraphicFactory.h"
 #include "PixelType.h"
 #include "CommentSkipLineDataSource.h"
 #include "Tokenizer.h"
 #include "Debug.h"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cstring>
+
+const int CMapRenderer::DChunkTiles = 16;
 
 /**
  * Constructor 
@@ -54,6 +59,8 @@ CMapRenderer::CMapRenderer(std::shared_ptr< CDataSource > config, std::shared_pt
     int ItemCount;
     DTileset = tileset;
     DMap = map;
+    DChunkColumns = 0;
+    DChunkRows = 0;
     
     // Change max size of the map
     DPixelIndices.resize(to_underlying(CTerrainMap::ETileType::Max));
@@ -256,79 +263,221 @@ int CMapRenderer::DetailedMapHeight() const{
 }
 
 /**
- * Draws the map based on dimensions of the surface given
+ * Finds the tileset index used to display a tile of the map
+ * 
+ * @param[in] xindex X index of the tile
+ * @param[in] yindex Y index of the tile
+ *
+ * @return Index into the tileset, -1 if the tile is not displayed
+*/
+int CMapRenderer::DisplayIndex(int xindex, int yindex) const{
+    CTerrainMap::ETileType ThisTileType = DMap->TileType(xindex, yindex);
+    int TileIndex = DMap->TileTypeIndex(xindex, yindex);
+    
+    if((0 <= TileIndex)&&(16 > TileIndex)){
+        int AltTileCount = DTileIndices[to_underlying(ThisTileType)][TileIndex].size();
+        if(AltTileCount){
+            int AltIndex = (xindex + yindex) % AltTileCount;
+            
+            return DTileIndices[to_underlying(ThisTileType)][TileIndex][AltIndex];
+        }
+    }
+    return -1;
+}
+
+/**
+ * Draws a single tile of the map
+ * 
+ * @param[in] surface Shared pointer of CGraphicSurface to draw the tile on
+ * @param[in] xindex X index of the tile
+ * @param[in] yindex Y index of the tile
+ * @param[in] xpos X position to draw the tile at
+ * @param[in] ypos Y position to draw the tile at
+ *
+ * @return None
+*/
+void CMapRenderer::DrawTile(std::shared_ptr<CGraphicSurface> surface, int xindex, int yindex, int xpos, int ypos){
+    int Index = DisplayIndex(xindex, yindex);
+    
+    if(-1 != Index){
+        DTileset->DrawTile(surface, xpos, ypos, Index);
+    }
+}
+
+/**
+ * Renders all tiles of a chunk into newly created chunk surfaces
+ * 
+ * @param[in] chunkindex Index of the chunk, row major
+ *
+ * @return None
+*/
+void CMapRenderer::RenderChunk(int chunkindex){
+    int TileWidth = DTileset->TileWidth();
+    int TileHeight = DTileset->TileHeight();
+    int XIndex = (chunkindex % DChunkColumns) * DChunkTiles;
+    int YIndex = (chunkindex / DChunkColumns) * DChunkTiles;
+    int ChunkWidth = std::min(DChunkTiles, DMap->Width() - XIndex);
+    int ChunkHeight = std::min(DChunkTiles, DMap->Height() - YIndex);
+    auto Surface = CGraphicFactory::CreateSurface(ChunkWidth * TileWidth, ChunkHeight * TileHeight, CGraphicSurface::ESurfaceFormat::ARGB32);
+    
+    Surface->Clear();
+    for(int YOff = 0; YOff < ChunkHeight; YOff++){
+        for(int XOff = 0; XOff < ChunkWidth; XOff++){
+            DrawTile(Surface, XIndex + XOff, YIndex + YOff, XOff * TileWidth, YOff * TileHeight);
+        }
+    }
+    DChunkSurfaces[chunkindex] = Surface;
+}
+
+/**
+ * Finds the color of a tile on the minimap
+ * 
+ * @param[in] xindex X index of the tile
+ * @param[in] yindex Y index of the tile
+ *
+ * @return Opaque ARGB color of the tile
+*/
+uint32_t CMapRenderer::MiniMapPixel(int xindex, int yindex) const{
+    auto TileType = DMap->TileType(xindex, yindex);
+    
+    if(CTerrainMap::ETileType::None == TileType){
+        return 0xFF000000;
+    }
+    return 0xFF000000 | DPixelIndices[to_underlying(TileType)];
+}
+
+/**
+ * Brings the rendered chunks and the minimap pixels up to date with the
+ * map. Tiles that changed are redrawn in their chunk and minimap pixel, if
+ * the whole map changed all chunks are dropped and rendered again when next
+ * drawn.
+ *
+ * @return None
+*/
+void CMapRenderer::UpdateTiles(){
+    int TileWidth = DTileset->TileWidth();
+    int TileHeight = DTileset->TileHeight();
+    int ChunkColumns = (DMap->Width() + DChunkTiles - 1) / DChunkTiles;
+    int ChunkRows = (DMap->Height() + DChunkTiles - 1) / DChunkTiles;
+    
+    if(DMap->TakeChangedTiles(DChangedTiles)||(ChunkColumns != DChunkColumns)||(ChunkRows != DChunkRows)){
+        DChunkColumns = ChunkColumns;
+        DChunkRows = ChunkRows;
+        DChunkSurfaces.assign(DChunkColumns * DChunkRows, nullptr);
+        DMiniMapPixels.resize(DMap->Width() * DMap->Height());
+        for(int YIndex = 0; YIndex < DMap->Height(); YIndex++){
+            for(int XIndex = 0; XIndex < DMap->Width(); XIndex++){
+                DMiniMapPixels[YIndex * DMap->Width() + XIndex] = MiniMapPixel(XIndex, YIndex);
+            }
+        }
+        return;
+    }
+    for(auto &Tile : DChangedTiles){
+        if((0 > Tile.X())||(0 > Tile.Y())||(DMap->Width() <= Tile.X())||(DMap->Height() <= Tile.Y())){
+            continue;
+        }
+        int ChunkIndex = (Tile.Y() / DChunkTiles) * DChunkColumns + Tile.X() / DChunkTiles;
+        
+        DMiniMapPixels[Tile.Y() * DMap->Width() + Tile.X()] = MiniMapPixel(Tile.X(), Tile.Y());
+        if(DChunkSurfaces[ChunkIndex]){
+            int XPos = (Tile.X() % DChunkTiles) * TileWidth;
+            int YPos = (Tile.Y() % DChunkTiles) * TileHeight;
+            
+            DChunkSurfaces[ChunkIndex]->Clear(XPos, YPos, TileWidth, TileHeight);
+            DrawTile(DChunkSurfaces[ChunkIndex], Tile.X(), Tile.Y(), XPos, YPos);
+        }
+    }
+}
+
+/**
+ * Draws the map based on dimensions of the surface given. The map is 
+ * pre-rendered in chunks of DChunkTiles square tiles, so drawing only blits
+ * the chunks under the rectangle.
  * 
  * @param[in] surface Shared pointer of CGraphicSurface 
- * @param[in] typesurface Shared pointer of CGraphic surface
  * @param[in] rect Constant reference to SRectangle object
  *
  * @return None
 */
-void CMapRenderer::DrawMap(std::shared_ptr<CGraphicSurface> surface, std::shared_ptr<CGraphicSurface> typesurface, const SRectangle &rect){
-    // Initialize local variables and set TileWidth and TileHeight
-    int TileWidth, TileHeight;
+void CMapRenderer::DrawMap(std::shared_ptr<CGraphicSurface> surface, const SRectangle &rect){
+    // Initialize local variables and set the chunk dimensions
+    int ChunkWidth = DChunkTiles * DTileset->TileWidth();
+    int ChunkHeight = DChunkTiles * DTileset->TileHeight();
+    int Left = std::max(0, rect.DXPosition);
+    int Top = std::max(0, rect.DYPosition);
+    int Right = std::min(DetailedMapWidth(), rect.DXPosition + rect.DWidth);
+    int Bottom = std::min(DetailedMapHeight(), rect.DYPosition + rect.DHeight);
     
-    TileWidth = DTileset->TileWidth();
-    TileHeight = DTileset->TileHeight();
-    
-    // Draw map based on TileWidth and TileHeight
-    typesurface->Clear();
-    for(int YIndex = rect.DYPosition / TileHeight, YPos = -(rect.DYPosition % TileHeight); YPos < rect.DHeight; YIndex++, YPos += TileHeight){
-        for(int XIndex = rect.DXPosition / TileWidth, XPos = -(rect.DXPosition % TileWidth); XPos < rect.DWidth; XIndex++, XPos += TileWidth){
-            CPixelType PixelType(DMap->TileType(XIndex, YIndex)); 
-            CTerrainMap::ETileType ThisTileType = DMap->TileType(XIndex, YIndex);
-            int TileIndex = DMap->TileTypeIndex(XIndex, YIndex);
+    UpdateTiles();
+    if((Left >= Right)||(Top >= Bottom)){
+        return;
+    }
+    // Blit the part of every chunk that lies within the rectangle
+    for(int ChunkY = Top / ChunkHeight; ChunkY * ChunkHeight < Bottom; ChunkY++){
+        for(int ChunkX = Left / ChunkWidth; ChunkX * ChunkWidth < Right; ChunkX++){
+            int ChunkIndex = ChunkY * DChunkColumns + ChunkX;
             
-            if((0 <= TileIndex)&&(16 > TileIndex)){
-                int DisplayIndex = -1;
-                int AltTileCount = DTileIndices[to_underlying(ThisTileType)][TileIndex].size();
-                if(AltTileCount){
-                    int AltIndex = (XIndex + YIndex) % AltTileCount;
-                    
-                    DisplayIndex = DTileIndices[to_underlying(ThisTileType)][TileIndex][AltIndex];
-                }
-                if(-1 != DisplayIndex){
-                    DTileset->DrawTile(surface, XPos, YPos, DisplayIndex);
-                    DTileset->DrawClipped(typesurface, XPos, YPos, DisplayIndex, PixelType.ToPixelColor());
-                }
-            }
-            else{
-                
-                return;
+            if(!DChunkSurfaces[ChunkIndex]){
+                RenderChunk(ChunkIndex);
             }
+            int XPos = std::max(Left, ChunkX * ChunkWidth);
+            int YPos = std::max(Top, ChunkY * ChunkHeight);
+            int Width = std::min(Right, ChunkX * ChunkWidth + DChunkSurfaces[ChunkIndex]->Width()) - XPos;
+            int Height = std::min(Bottom, ChunkY * ChunkHeight + DChunkSurfaces[ChunkIndex]->Height()) - YPos;
+            
+            surface->Draw(DChunkSurfaces[ChunkIndex], XPos - rect.DXPosition, YPos - rect.DYPosition, Width, Height, XPos - ChunkX * ChunkWidth, YPos - ChunkY * ChunkHeight);
         }
     }
+}
 
+/**
+ * Finds the pixel type of the map at a position, from the tile under it
+ * and the clipping mask of the tile displayed there
+ * 
+ * @param[in] xpos X position on the detailed map
+ * @param[in] ypos Y position on the detailed map
+ *
+ * @return The pixel type at the position
+*/
+CPixelType CMapRenderer::PixelType(int xpos, int ypos) const{
+    int TileWidth = DTileset->TileWidth();
+    int TileHeight = DTileset->TileHeight();
+    
+    if((0 <= xpos)&&(0 <= ypos)&&(DetailedMapWidth() > xpos)&&(DetailedMapHeight() > ypos)){
+        int XIndex = xpos / TileWidth;
+        int YIndex = ypos / TileHeight;
+        
+        if(DTileset->ClippedPixel(DisplayIndex(XIndex, YIndex), xpos % TileWidth, ypos % TileHeight)){
+            return CPixelType(DMap->TileType(XIndex, YIndex));
+        }
+    }
+    return CPixelType(CTerrainMap::ETileType::None);
 }
 
 /**
- * Similar to DrawMap, draws the minimap based on dimensions of the surface given
+ * Similar to DrawMap, draws the minimap based on dimensions of the surface
+ * given, one pixel per tile. The minimap pixels are kept up to date with the
+ * changed tiles, so drawing is a copy into the surface.
  * 
  * @param[in] surface Shared pointer of CGraphicSurface 
  *
  * @return None
 */
 void CMapRenderer::DrawMiniMap(std::shared_ptr<CGraphicSurface> surface){
-    auto ResourceContext = surface->CreateResourceContext();
+    int Stride;
+    int Width = std::min(surface->Width(), DMap->Width());
+    int Height = std::min(surface->Height(), DMap->Height());
     
-    // Generate the rectangle based on the surface parameter
-    ResourceContext->SetLineWidth(1);
-    ResourceContext->SetLineCap(CGraphicResourceContext::ELineCap::Square);
-    for(int YPos = 0; YPos < DMap->Height(); YPos++){
-        int XPos = 0;
-        
-        while(XPos < DMap->Width()){
-            auto TileType = DMap->TileType(XPos, YPos);
-            int XAnchor = XPos;
-            while((XPos < DMap->Width())&&(DMap->TileType(XPos, YPos) == TileType)){
-                XPos++;   
-            }
-            if(CTerrainMap::ETileType::None != TileType){
-                ResourceContext->SetSourceRGB(DPixelIndices[to_underlying(TileType)]);
-                ResourceContext->MoveTo(XAnchor,YPos);
-                ResourceContext->LineTo(XPos,YPos);
-                ResourceContext->Stroke();   
-            }
-        }
+    if((CGraphicSurface::ESurfaceFormat::ARGB32 != surface->Format())&&(CGraphicSurface::ESurfaceFormat::RGB24 != surface->Format())){
+        return;
+    }
+    UpdateTiles();
+    uint8_t *Pixels = surface->LockPixels(Stride);
+    if(!Pixels){
+        return;
+    }
+    for(int YPos = 0; YPos < Height; YPos++){
+        std::memcpy(Pixels + YPos * Stride, DMiniMapPixels.data() + YPos * DMap->Width(), Width * sizeof(uint32_t));
     }
+    surface->UnlockPixels();
 }
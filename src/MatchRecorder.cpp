@@ -0,0 +1,296 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#include "MatchRecorder.h"
+#include "GameModel.h"
+#include "GraphicFactory.h"
+#include "Debug.h"
+#include <climits>
+#include <cstdio>
+
+#define MAX_FRAME_BYTES     (256 << 20)
+
+/**
+* Bytes of the pixels of a frame surface
+*
+* @param[in] width Width of the surface
+* @param[in] height Height of the surface
+*
+* @return Number of bytes
+*
+*/
+static size_t FrameBytes(int width, int height){
+    return size_t(width) * height * 4;
+}
+
+/**
+* Creates a match recorder
+*
+* @param[in] output Container the frames are written to
+* @param[in] format Format of the written frames
+* @param[in] interval Number of cycles between recorded frames
+* @param[in] encodercount Number of encoder threads, hardware concurrency if less than 1
+*
+*/
+CMatchRecorder::CMatchRecorder(std::shared_ptr< CDataContainer > output, EFrameFormat format, int interval, int encodercount){
+    DOutputContainer = output;
+    DFormat = format;
+    DPlayerColor = EPlayerColor::Red;
+    DInterval = std::max(1, interval);
+    DViewportWidth = 0;
+    DViewportHeight = 0;
+    DMiniMapSize = 0;
+    DFrameWidth = 0;
+    DFrameHeight = 0;
+    DFrameCount = 0;
+    DEncoderCount = encodercount;
+    if(1 > DEncoderCount){
+        DEncoderCount = std::max< int >(1, std::thread::hardware_concurrency());
+    }
+    DMaxFrameBytes = MAX_FRAME_BYTES;
+    DAllocatedFrameBytes = 0;
+    DFramesWritten = 0;
+    DFramesFailed = 0;
+    DStopEncoders = false;
+}
+
+/**
+* Destructor writes any queued frames and stops the encoders
+*
+*/
+CMatchRecorder::~CMatchRecorder(){
+    StopEncoders();
+}
+
+/**
+* Takes a surface of the size from those the encoders are done with, or
+* creates one if the surfaces are within DMaxFrameBytes. Free surfaces of
+* other sizes are released to make room, otherwise it waits for the
+* encoders to finish a frame. A single surface larger than the limit is
+* still created when no other surface exists.
+*
+* @param[in] width Width of the surface
+* @param[in] height Height of the surface
+*
+* @return The surface
+*
+*/
+std::shared_ptr< CGraphicSurface > CMatchRecorder::AcquireSurface(int width, int height){
+    std::unique_lock< std::mutex > Lock(DFrameMutex);
+    size_t Bytes = FrameBytes(width, height);
+
+    while(true){
+        for(auto Iterator = DFreeSurfaces.begin(); Iterator != DFreeSurfaces.end(); Iterator++){
+            if(((*Iterator)->Width() == width)&&((*Iterator)->Height() == height)){
+                auto Surface = *Iterator;
+
+                DFreeSurfaces.erase(Iterator);
+                return Surface;
+            }
+        }
+        while(!DFreeSurfaces.empty()&&(DAllocatedFrameBytes + Bytes > DMaxFrameBytes)){
+            DAllocatedFrameBytes -= FrameBytes(DFreeSurfaces.back()->Width(), DFreeSurfaces.back()->Height());
+            DFreeSurfaces.pop_back();
+        }
+        if(!DAllocatedFrameBytes||(DAllocatedFrameBytes + Bytes <= DMaxFrameBytes)){
+            DAllocatedFrameBytes += Bytes;
+            break;
+        }
+        DFrameEncoded.wait(Lock);
+    }
+    Lock.unlock();
+    return CGraphicFactory::CreateSurface(width, height, CGraphicSurface::ESurfaceFormat::ARGB32);
+}
+
+/**
+* Queues a drawn frame for the encoders
+*
+* @param[in] name Name of the file of the frame
+* @param[in] surface The drawn frame
+*
+* @return Nothing
+*
+*/
+void CMatchRecorder::QueueFrame(const std::string &name, std::shared_ptr< CGraphicSurface > surface){
+    {
+        std::lock_guard< std::mutex > Lock(DFrameMutex);
+
+        DFrames.push_back(SFrame{name, surface});
+    }
+    DFrameQueued.notify_one();
+}
+
+/**
+* Writes a frame to the output container
+*
+* @param[in] frame The frame to write
+*
+* @return true if the frame was written
+*
+*/
+bool CMatchRecorder::EncodeFrame(const SFrame &frame){
+    auto Sink = DOutputContainer->DataSink(frame.DName);
+
+    if(!Sink){
+        return false;
+    }
+    if(EFrameFormat::PNG == DFormat){
+        return CGraphicFactory::StoreSurface(Sink, frame.DSurface);
+    }
+    int Stride;
+    int RowLength = frame.DSurface->Width() * 4;
+    uint8_t *Pixels = frame.DSurface->LockPixels(Stride);
+    bool Success = nullptr != Pixels;
+
+    for(int Row = 0; Success && (Row < frame.DSurface->Height()); Row++){
+        Success = RowLength == Sink->Write(Pixels + Stride * Row, RowLength);
+    }
+    frame.DSurface->UnlockPixels();
+    return Success;
+}
+
+/**
+* Encoder loop, writes queued frames until stopped and the queue is empty
+*
+* @return Nothing
+*
+*/
+void CMatchRecorder::EncodeFrames(){
+    std::unique_lock< std::mutex > Lock(DFrameMutex);
+
+    while(true){
+        DFrameQueued.wait(Lock, [this](){
+            return DStopEncoders || !DFrames.empty();
+        });
+        if(DFrames.empty()){
+            return;
+        }
+        SFrame Frame = DFrames.front();
+
+        DFrames.pop_front();
+        Lock.unlock();
+        bool Success = EncodeFrame(Frame);
+        Lock.lock();
+        if(Success){
+            DFramesWritten++;
+        }
+        else{
+            DFramesFailed++;
+            PrintError("Failed to write frame %s\n", Frame.DName.c_str());
+        }
+        DFreeSurfaces.push_back(Frame.DSurface);
+        DFrameEncoded.notify_all();
+    }
+}
+
+/**
+* Starts the encoder threads
+*
+* @return Nothing
+*
+*/
+void CMatchRecorder::StartEncoders(){
+    DStopEncoders = false;
+    for(int Index = 0; Index < DEncoderCount; Index++){
+        DEncoders.push_back(std::thread(&CMatchRecorder::EncodeFrames, this));
+    }
+}
+
+/**
+* Stops the encoder threads once all queued frames are written
+*
+* @return Nothing
+*
+*/
+void CMatchRecorder::StopEncoders(){
+    {
+        std::lock_guard< std::mutex > Lock(DFrameMutex);
+
+        DStopEncoders = true;
+    }
+    DFrameQueued.notify_all();
+    for(auto &Encoder : DEncoders){
+        Encoder.join();
+    }
+    DEncoders.clear();
+}
+
+/**
+* Called after every cycle of the match, creates the renderers on the first
+* cycle and draws a frame every interval cycles
+*
+* @param[in] gamemodel The game model of the match
+* @param[in] cycle Number of cycles played
+*
+* @return Nothing
+*
+*/
+void CMatchRecorder::RecordCycle(std::shared_ptr< CGameModel > gamemodel, int cycle){
+    char FrameNumber[16];
+
+    if(DGameModel != gamemodel){
+        DGameModel = gamemodel;
+        DFrameWidth = DViewportWidth;
+        DFrameHeight = DViewportHeight;
+        // A viewport without a size shows the whole map, and is never larger than it
+        if((0 >= DFrameWidth)||(0 >= DFrameHeight)){
+            DFrameWidth = DFrameHeight = INT_MAX;
+        }
+        DFrameWidth = std::min(DFrameWidth, gamemodel->Map()->Width() * CPosition::TileWidth());
+        DFrameHeight = std::min(DFrameHeight, gamemodel->Map()->Height() * CPosition::TileHeight());
+        DRenderer.CreateRenderers(gamemodel, DPlayerColor, DFrameWidth, DFrameHeight);
+    }
+    if((cycle - 1) % DInterval){
+        return;
+    }
+    snprintf(FrameNumber, sizeof(FrameNumber), "%06d", DFrameCount++);
+    std::string Extension = EFrameFormat::PNG == DFormat ? ".png" : ".raw";
+
+    auto ViewportSurface = AcquireSurface(DFrameWidth, DFrameHeight);
+    DRenderer.DrawViewport(ViewportSurface);
+    QueueFrame(std::string("viewport_") + FrameNumber + Extension, ViewportSurface);
+    if(0 < DMiniMapSize){
+        auto MiniMapSurface = AcquireSurface(DMiniMapSize, DMiniMapSize);
+
+        DRenderer.DrawMiniMap(MiniMapSurface);
+        QueueFrame(std::string("minimap_") + FrameNumber + Extension, MiniMapSurface);
+    }
+}
+
+/**
+* Plays a match to the end in the calling thread while recording it, and
+* waits for all of its frames to be written
+*
+* @param[in] settings The match to play
+*
+* @return The result of the match
+*
+*/
+CTournament::SMatchResult CMatchRecorder::Record(const CTournament::SMatchSettings &settings){
+    CTournament::SMatchResult Result;
+
+    DGameModel = nullptr;
+    DFrameCount = 0;
+    DFramesWritten = 0;
+    DFramesFailed = 0;
+    StartEncoders();
+    Result = CTournament::RunMatch(settings, [this](std::shared_ptr< CGameModel > gamemodel, int cycle){
+        RecordCycle(gamemodel, cycle);
+    });
+    StopEncoders();
+    DGameModel = nullptr;
+    return Result;
+}
@@ -67,3 +67,43 @@ int CMemoryDataSource::Read(void *data, int length){
     
     return length;
 }
+
+/**
+ * Returns the unread data without consuming it
+ *
+ * @param[out] data set to the first unread byte
+ *
+ * @return integer number of unread bytes
+*/
+int CMemoryDataSource::Peek(const void *&data){
+    data = DData.data() + DOffset;
+    return DData.size() - DOffset;
+}
+
+/**
+ * Consumes data previously returned by Peek
+ *
+ * @param[in] length integer number of bytes to consume
+ *
+ * @return None
+*/
+void CMemoryDataSource::Skip(int length){
+    if(length + DOffset > DData.size()){
+        length = DData.size() - DOffset;
+    }
+    if(0 < length){
+        DOffset += length;
+    }
+}
+
+/**
+ * Returns the unread data without copying it
+ *
+ * @param[out] length integer number of unread bytes
+ *
+ * @return pointer to the first unread byte
+*/
+const void *CMemoryDataSource::View(int &length){
+    length = DData.size() - DOffset;
+    return DData.data() + DOffset;
+}
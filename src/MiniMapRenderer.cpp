@@ -114,7 +114,9 @@ int CMiniMapRenderer::VisibleHeight() const{
 
 /**
 *
-* This function draws the minimap
+* This function draws the minimap. The terrain, asset and fog layers are
+* composited into the working surface pixels, one pixel per tile, and the
+* result is scaled onto the surface.
 *
 * @param surface The shared pointer to a GraphicSurface object
 *
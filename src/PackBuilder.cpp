@@ -0,0 +1,86 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+/**
+ * @brief
+ *      PackBuilder.cpp , packs a data directory into a single .pak file
+ *
+ *      packbuilder [-o file.pak] datadir
+ *
+ *      The pack is written next to the data directory (bin/data.pak for
+ *      bin/data) unless an output file is given, where the game and
+ *      tournament pick it up in place of the directory. It must be rebuilt
+ *      whenever a file of the directory changes.
+ *
+*/
+#include "PackDataContainer.h"
+#include "FileDataContainer.h"
+#include "FileDataSource.h"
+#include "FileDataSink.h"
+#include "Path.h"
+#include "Debug.h"
+#include <cstdlib>
+#include <unistd.h>
+
+#ifndef DEBUG_LEVEL
+#define DEBUG_LEVEL DEBUG_LOW
+#endif
+
+/**
+ * Main function of the pack builder
+ *
+ * @param[in] argc Integer containing the number of command line arguments, indexed from 0
+ * @param[in] argv Character pointer containing the command line arguments, indexed by argc
+ *
+ * @return Exit code, 0 if the pack was written and loads back
+*/
+int main(int argc, char *argv[]){
+    std::string OutputFile, DataPath;
+    auto Pack = std::make_shared< CPackFile >();
+
+    OpenDebug("PackBuilder.out", DEBUG_LEVEL);
+    for(int Index = 1; Index < argc; Index++){
+        std::string Argument = argv[Index];
+
+        if(Argument == "-o"){
+            if(Index + 1 >= argc){
+                break;
+            }
+            OutputFile = argv[++Index];
+            continue;
+        }
+        DataPath = Argument;
+    }
+    if(DataPath.empty()){
+        fprintf(stderr, "Usage: %s [-o file.pak] datadir\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if(OutputFile.empty()){
+        OutputFile = CPath::CurrentPath().Simplify(CPath(DataPath)).ToString() + CPackFile::DExtension;
+    }
+    // CFileDataSink does not truncate, an older pack would leave its tail
+    unlink(OutputFile.c_str());
+    if(!CPackFile::Build(std::make_shared< CDirectoryDataContainer >(DataPath), std::make_shared< CFileDataSink >(OutputFile))){
+        PrintError("Failed to write \"%s\".\n", OutputFile.c_str());
+        return EXIT_FAILURE;
+    }
+    if(!Pack->Load(std::make_shared< CFileDataSource >(OutputFile, -1, true))){
+        PrintError("Written pack \"%s\" is invalid.\n", OutputFile.c_str());
+        return EXIT_FAILURE;
+    }
+    printf("%s -> %s (%d files)\n", DataPath.c_str(), OutputFile.c_str(), Pack->EntryCount());
+    return EXIT_SUCCESS;
+}
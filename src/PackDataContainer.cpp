@@ -0,0 +1,598 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#include "PackDataContainer.h"
+#include "FileDataContainer.h"
+#include "FileDataSource.h"
+#include "MapBundle.h"
+#include "Path.h"
+#include "Debug.h"
+#include <algorithm>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define PACK_FILE_HEADER_SIZE   16
+
+const std::string CPackFile::DExtension = ".pak";
+const uint32_t CPackFile::DMagic = 0x4B504357; // "WCPK"
+const uint32_t CPackFile::DVersion = 1;
+
+static void EncodeUInt32(uint8_t *dest, uint32_t value){
+    dest[0] = value;
+    dest[1] = value >> 8;
+    dest[2] = value >> 16;
+    dest[3] = value >> 24;
+}
+
+/**
+* Removes the leading delimiter of an absolute path, giving the name of an
+* entry relative to the root of the pack
+*
+* @param[in] path The absolute path
+*
+* @return The relative path
+*
+*/
+static std::string StripRoot(const std::string &path){
+    return path.length() && ('/' == path[0]) ? path.substr(1) : path;
+}
+
+CPackFile::CPackFile(){
+    DData = nullptr;
+    DLength = 0;
+}
+
+/**
+* Loads and validates the index of a pack, and the checksum of each of its
+* entries. The contents are viewed in place when the source has a view
+* (memory mapped files) and read into memory otherwise.
+*
+* @param[in] source Source of the pack
+*
+* @return true if the pack is valid
+*
+*/
+bool CPackFile::Load(std::shared_ptr< CDataSource > source){
+    const void *View;
+    int Length;
+
+    DEntries.clear();
+    DValidEntries.clear();
+    if(!source){
+        return false;
+    }
+    if((View = source->View(Length))){
+        // The view is only valid as long as its source
+        DSource = source;
+        DData = (const uint8_t *)View;
+        DLength = Length;
+    }
+    else{
+        uint8_t Buffer[4096];
+
+        DBuffer.clear();
+        while(0 < (Length = source->Read(Buffer, sizeof(Buffer)))){
+            DBuffer.insert(DBuffer.end(), Buffer, Buffer + Length);
+        }
+        DData = DBuffer.data();
+        DLength = DBuffer.size();
+    }
+
+    CMapBundleReader Reader(DData, DLength);
+    int Magic, Version, EntryCount, IndexLength;
+
+    if(!Reader.ReadInt(Magic)||(DMagic != uint32_t(Magic))){
+        PrintError("Not a pack file.\n");
+        return false;
+    }
+    if(!Reader.ReadInt(Version)||(DVersion != uint32_t(Version))){
+        PrintError("Unsupported pack file version %u.\n", uint32_t(Version));
+        return false;
+    }
+    if(!Reader.ReadInt(EntryCount)||!Reader.ReadInt(IndexLength)||(0 > EntryCount)||(0 > IndexLength)||(DLength - PACK_FILE_HEADER_SIZE < uint32_t(IndexLength))){
+        PrintError("Pack file header is corrupt.\n");
+        return false;
+    }
+    Reader = CMapBundleReader(DData + PACK_FILE_HEADER_SIZE, IndexLength);
+    DEntries.resize(EntryCount);
+    for(auto &Entry : DEntries){
+        int Offset, EntryLength, Checksum;
+
+        if(!Reader.ReadString(Entry.DName)||!Reader.ReadInt(Offset)||!Reader.ReadInt(EntryLength)||!Reader.ReadInt(Checksum)){
+            break;
+        }
+        Entry.DOffset = Offset;
+        Entry.DLength = EntryLength;
+        Entry.DChecksum = Checksum;
+        if((Entry.DOffset > DLength)||(Entry.DLength > DLength - Entry.DOffset)){
+            PrintError("Pack file entry \"%s\" is out of bounds.\n", Entry.DName.c_str());
+            DEntries.clear();
+            return false;
+        }
+    }
+    if(!Reader.Valid()||!Reader.AtEnd()){
+        PrintError("Pack file index is corrupt.\n");
+        DEntries.clear();
+        return false;
+    }
+    for(int Index = 1; Index < DEntries.size(); Index++){
+        if(!(DEntries[Index - 1].DName < DEntries[Index].DName)){
+            PrintError("Pack file index is not sorted.\n");
+            DEntries.clear();
+            return false;
+        }
+    }
+    // Entries that fail are read from the fallback directory instead
+    DValidEntries.resize(DEntries.size());
+    for(int Index = 0; Index < DEntries.size(); Index++){
+        DValidEntries[Index] = CMapBundle::Checksum(EntryData(DEntries[Index]), DEntries[Index].DLength) == DEntries[Index].DChecksum;
+        if(!DValidEntries[Index]){
+            PrintError("Pack file entry \"%s\" checksum mismatch.\n", DEntries[Index].DName.c_str());
+        }
+    }
+    return true;
+}
+
+/**
+* Binary searches the index for an entry
+*
+* @param[in] name Path of the file relative to the root of the pack
+*
+* @return Index of the entry, -1 if not found
+*
+*/
+int CPackFile::FindEntry(const std::string &name) const{
+    int Index = FirstEntryWithPrefix(name);
+
+    if((Index < DEntries.size())&&(DEntries[Index].DName == name)){
+        return Index;
+    }
+    return -1;
+}
+
+/**
+* Binary searches the index for the first entry not less than a prefix, all
+* entries starting with the prefix follow it
+*
+* @param[in] prefix The prefix
+*
+* @return Index of the entry, the entry count if there is none
+*
+*/
+int CPackFile::FirstEntryWithPrefix(const std::string &prefix) const{
+    auto Search = std::lower_bound(DEntries.begin(), DEntries.end(), prefix, [](const SEntry &entry, const std::string &name){
+        return entry.DName < name;
+    });
+
+    return Search - DEntries.begin();
+}
+
+/**
+* Collects all files below a container with their content
+*
+* @param[in] container The container
+* @param[in] prefix Path of the container relative to the root of the pack
+* @param[out] entries Collected entries, offsets are not set
+* @param[out] contents Content of each entry
+*
+* @return true if all files were read
+*
+*/
+static bool CollectFiles(std::shared_ptr< CDataContainer > container, const std::string &prefix, std::vector< CPackFile::SEntry > &entries, std::vector< std::vector< uint8_t > > &contents){
+    auto FileIterator = container->First();
+
+    if(!FileIterator){
+        return false;
+    }
+    while(FileIterator->IsValid()){
+        std::string Name = FileIterator->Name();
+        bool IsContainer = FileIterator->IsContainer();
+
+        FileIterator->Next();
+        if(Name.empty()||('.' == Name[0])){
+            continue;
+        }
+        if(IsContainer){
+            if(!CollectFiles(container->DataContainer(Name), prefix + Name + "/", entries, contents)){
+                return false;
+            }
+            continue;
+        }
+        auto Source = container->DataSource(Name);
+        uint8_t Buffer[4096];
+        int Length;
+
+        if(!Source){
+            PrintError("Failed to open \"%s%s\".\n", prefix.c_str(), Name.c_str());
+            return false;
+        }
+        contents.push_back(std::vector< uint8_t >());
+        while(0 < (Length = Source->Read(Buffer, sizeof(Buffer)))){
+            contents.back().insert(contents.back().end(), Buffer, Buffer + Length);
+        }
+        entries.push_back(CPackFile::SEntry{prefix + Name, 0, uint32_t(contents.back().size()), CMapBundle::Checksum(contents.back().data(), contents.back().size())});
+    }
+    return true;
+}
+
+/**
+* Writes all of a buffer to a sink
+*
+* @param[in] sink The sink
+* @param[in] data The buffer
+* @param[in] length Length of the buffer
+*
+* @return true if all was written
+*
+*/
+static bool WriteAll(std::shared_ptr< CDataSink > sink, const uint8_t *data, size_t length){
+    while(length){
+        int Written = sink->Write(data, std::min< size_t >(length, 1 << 20));
+
+        if(0 >= Written){
+            return false;
+        }
+        data += Written;
+        length -= Written;
+    }
+    return true;
+}
+
+/**
+* Builds a pack of all files below a container, hidden files and
+* directories (starting with '.') are skipped
+*
+* @param[in] container Root of the files to pack
+* @param[in] sink Where the pack is written
+*
+* @return true if the pack was written
+*
+*/
+bool CPackFile::Build(std::shared_ptr< CDataContainer > container, std::shared_ptr< CDataSink > sink){
+    std::vector< SEntry > Entries;
+    std::vector< std::vector< uint8_t > > Contents;
+    std::vector< int > Order;
+    std::vector< uint8_t > Index;
+    uint8_t Bytes[PACK_FILE_HEADER_SIZE];
+    uint64_t Offset;
+
+    if(!container||!sink||!CollectFiles(container, "", Entries, Contents)){
+        return false;
+    }
+    for(int EntryIndex = 0; EntryIndex < Entries.size(); EntryIndex++){
+        Order.push_back(EntryIndex);
+    }
+    std::sort(Order.begin(), Order.end(), [&Entries](int first, int second){
+        return Entries[first].DName < Entries[second].DName;
+    });
+
+    Offset = PACK_FILE_HEADER_SIZE;
+    for(auto &Entry : Entries){
+        Offset += 16 + Entry.DName.length();
+    }
+    for(int EntryIndex : Order){
+        SEntry &Entry = Entries[EntryIndex];
+
+        if(UINT32_MAX < Offset + Entry.DLength){
+            PrintError("Pack file would exceed 4GB.\n");
+            return false;
+        }
+        Entry.DOffset = Offset;
+        Offset += Entry.DLength;
+
+        EncodeUInt32(Bytes, Entry.DName.length());
+        Index.insert(Index.end(), Bytes, Bytes + 4);
+        Index.insert(Index.end(), Entry.DName.begin(), Entry.DName.end());
+        EncodeUInt32(Bytes, Entry.DOffset);
+        EncodeUInt32(Bytes + 4, Entry.DLength);
+        EncodeUInt32(Bytes + 8, Entry.DChecksum);
+        Index.insert(Index.end(), Bytes, Bytes + 12);
+    }
+
+    EncodeUInt32(Bytes, DMagic);
+    EncodeUInt32(Bytes + 4, DVersion);
+    EncodeUInt32(Bytes + 8, Entries.size());
+    EncodeUInt32(Bytes + 12, Index.size());
+    if(!WriteAll(sink, Bytes, PACK_FILE_HEADER_SIZE)||!WriteAll(sink, Index.data(), Index.size())){
+        return false;
+    }
+    for(int EntryIndex : Order){
+        if(!WriteAll(sink, Contents[EntryIndex].data(), Contents[EntryIndex].size())){
+            return false;
+        }
+    }
+    return true;
+}
+
+CPackDataSource::CPackDataSource(std::shared_ptr< CPackFile > pack, const CPackFile::SEntry &entry, std::shared_ptr< CDataContainer > fallbackroot){
+    DPack = pack;
+    DFallbackRoot = fallbackroot;
+    DPath = entry.DName;
+    DData = pack->EntryData(entry);
+    DLength = entry.DLength;
+    DOffset = 0;
+}
+
+int CPackDataSource::Read(void *data, int length){
+    int BytesCopied = std::min(length, DLength - DOffset);
+
+    if(0 >= BytesCopied){
+        return -1;
+    }
+    memcpy(data, DData + DOffset, BytesCopied);
+    DOffset += BytesCopied;
+    return BytesCopied;
+}
+
+int CPackDataSource::Peek(const void *&data){
+    data = DData + DOffset;
+    return DLength - DOffset;
+}
+
+void CPackDataSource::Skip(int length){
+    DOffset = std::min(DOffset + std::max(length, 0), DLength);
+}
+
+const void *CPackDataSource::View(int &length){
+    length = DLength - DOffset;
+    return DData + DOffset;
+}
+
+/**
+* Creates a container for the pack directory holding the file, so files
+* named relative to this one are found in the pack
+*
+* @return The pack container
+*
+*/
+std::shared_ptr< CDataContainer > CPackDataSource::Container(){
+    return std::make_shared< CPackDataContainer >(DPack, StripRoot(CPath("/" + DPath).Containing().ToString()), DFallbackRoot);
+}
+
+CPackDataContainerIterator::CPackDataContainerIterator(const std::vector< std::pair< std::string, bool > > &entries){
+    DEntries = entries;
+    DIndex = 0;
+}
+
+std::string CPackDataContainerIterator::Name(){
+    return IsValid() ? DEntries[DIndex].first : "";
+}
+
+bool CPackDataContainerIterator::IsContainer(){
+    return IsValid() && DEntries[DIndex].second;
+}
+
+bool CPackDataContainerIterator::IsValid(){
+    return DIndex < DEntries.size();
+}
+
+void CPackDataContainerIterator::Next(){
+    if(IsValid()){
+        DIndex++;
+    }
+}
+
+/**
+* Creates a container for a directory of a pack
+*
+* @param[in] pack The loaded pack
+* @param[in] path Path of the directory relative to the root of the pack, empty for the root
+* @param[in] fallbackroot Directory the pack was built from, may be nullptr
+*
+*/
+CPackDataContainer::CPackDataContainer(std::shared_ptr< CPackFile > pack, const std::string &path, std::shared_ptr< CDataContainer > fallbackroot){
+    DPack = pack;
+    DPath = path;
+    DFallbackRoot = fallbackroot;
+}
+
+/**
+* Checks if a directory, or any file or directory below it, was changed
+* after a time. Hidden files are skipped as they are never packed.
+*
+* @param[in] container The directory container
+* @param[in] path Path of the directory
+* @param[in] modified The time
+*
+* @return true if anything is newer
+*
+*/
+static bool DirectoryIsNewer(std::shared_ptr< CDataContainer > container, const std::string &path, time_t modified){
+    struct stat FileStat;
+
+    if((0 == stat(path.c_str(), &FileStat))&&(FileStat.st_mtime > modified)){
+        return true;
+    }
+    auto FileIterator = container ? container->First() : nullptr;
+
+    while(FileIterator && FileIterator->IsValid()){
+        std::string Name = FileIterator->Name();
+        bool IsContainer = FileIterator->IsContainer();
+
+        FileIterator->Next();
+        if(Name.empty()||('.' == Name[0])){
+            continue;
+        }
+        if(IsContainer){
+            if(DirectoryIsNewer(container->DataContainer(Name), path + "/" + Name, modified)){
+                return true;
+            }
+        }
+        else if((0 == stat((path + "/" + Name).c_str(), &FileStat))&&(FileStat.st_mtime > modified)){
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+* Opens a data directory, through its pack (the directory name with the
+* pack extension) if there is a valid one. The directory is checked once
+* here, a pack older than anything in it is stale and the directory is used
+* instead.
+*
+* @param[in] datapath Path of the data directory
+* @param[in] mapfiles Memory map the pack or the files of the directory
+*
+* @return Pack container falling back to the directory, or the directory container if there is no current pack
+*
+*/
+std::shared_ptr< CDataContainer > CPackDataContainer::OpenDataContainer(const std::string &datapath, bool mapfiles){
+    auto DirectoryContainer = std::make_shared< CDirectoryDataContainer >(datapath, mapfiles);
+    std::string DataPath = CPath::CurrentPath().Simplify(CPath(datapath)).ToString();
+    std::string PackName = DataPath + CPackFile::DExtension;
+    auto Pack = std::make_shared< CPackFile >();
+    struct stat PackStat;
+
+    if((0 != access(PackName.c_str(), R_OK))||(0 != stat(PackName.c_str(), &PackStat))){
+        return DirectoryContainer;
+    }
+    if(DirectoryIsNewer(DirectoryContainer, DataPath, PackStat.st_mtime)){
+        PrintError("Ignoring pack file \"%s\" older than its data directory.\n", PackName.c_str());
+        return DirectoryContainer;
+    }
+    if(!Pack->Load(std::make_shared< CFileDataSource >(PackName, -1, mapfiles))){
+        PrintError("Ignoring invalid pack file \"%s\".\n", PackName.c_str());
+        return DirectoryContainer;
+    }
+    PrintDebug(DEBUG_LOW, "Loaded pack file \"%s\" with %d entries.\n", PackName.c_str(), Pack->EntryCount());
+    return std::make_shared< CPackDataContainer >(Pack, "", DirectoryContainer);
+}
+
+/**
+* Converts a name relative to this directory into a path relative to the
+* root of the pack
+*
+* @param[in] name The name
+*
+* @return The path
+*
+*/
+std::string CPackDataContainer::EntryName(const std::string &name) const{
+    return StripRoot(CPath("/" + DPath).Simplify(CPath(name)).ToString());
+}
+
+/**
+* Returns the fallback directory matching this directory of the pack
+*
+* @return The directory container, nullptr if there is no fallback
+*
+*/
+std::shared_ptr< CDataContainer > CPackDataContainer::Fallback(){
+    if(!DFallbackRoot||DPath.empty()){
+        return DFallbackRoot;
+    }
+    return DFallbackRoot->DataContainer(DPath);
+}
+
+/**
+* Lists the files and directories directly below this directory of the
+* pack, or of the fallback directory if the pack has none there
+*
+* @return The iterator
+*
+*/
+std::shared_ptr< CDataContainerIterator > CPackDataContainer::First(){
+    std::vector< std::pair< std::string, bool > > Entries;
+    std::string Prefix = DPath.empty() ? "" : DPath + "/";
+
+    for(int Index = DPack->FirstEntryWithPrefix(Prefix); Index < DPack->EntryCount(); Index++){
+        const std::string &Name = DPack->Entry(Index).DName;
+
+        if(Name.compare(0, Prefix.length(), Prefix)){
+            break;
+        }
+        size_t Delimiter = Name.find('/', Prefix.length());
+
+        if(std::string::npos == Delimiter){
+            Entries.push_back(std::make_pair(Name.substr(Prefix.length()), false));
+        }
+        else{
+            std::string ContainerName = Name.substr(Prefix.length(), Delimiter - Prefix.length());
+
+            // Entries of a sub directory are contiguous as the index is sorted
+            if(Entries.empty()||!Entries.back().second||(Entries.back().first != ContainerName)){
+                Entries.push_back(std::make_pair(ContainerName, true));
+            }
+        }
+    }
+    if(Entries.empty()&&DFallbackRoot){
+        auto FallbackContainer = Fallback();
+
+        return FallbackContainer ? FallbackContainer->First() : nullptr;
+    }
+    return std::make_shared< CPackDataContainerIterator >(Entries);
+}
+
+/**
+* Opens a file of the pack
+*
+* @param[in] name Name of the file relative to this directory
+*
+* @return The data source, the fallback file if not in the pack or invalid
+*
+*/
+std::shared_ptr< CDataSource > CPackDataContainer::DataSource(const std::string &name){
+    int Index = DPack->FindEntry(EntryName(name));
+
+    if((0 <= Index)&&DPack->EntryValid(Index)){
+        return std::make_shared< CPackDataSource >(DPack, DPack->Entry(Index), DFallbackRoot);
+    }
+    auto FallbackContainer = Fallback();
+
+    return FallbackContainer ? FallbackContainer->DataSource(name) : nullptr;
+}
+
+/**
+* Packs are read only, sinks are created in the fallback directory
+*
+* @param[in] name Name of the file relative to this directory
+*
+* @return The data sink, nullptr if there is no fallback
+*
+*/
+std::shared_ptr< CDataSink > CPackDataContainer::DataSink(const std::string &name){
+    auto FallbackContainer = Fallback();
+
+    return FallbackContainer ? FallbackContainer->DataSink(name) : nullptr;
+}
+
+/**
+* Creates a container for the directory holding this one, the root of the
+* pack is held by the directory holding the fallback
+*
+* @return The container
+*
+*/
+std::shared_ptr< CDataContainer > CPackDataContainer::Container(){
+    if(DPath.empty()){
+        return DFallbackRoot ? DFallbackRoot->Container() : nullptr;
+    }
+    return std::make_shared< CPackDataContainer >(DPack, StripRoot(CPath("/" + DPath).Containing().ToString()), DFallbackRoot);
+}
+
+/**
+* Creates a container for a sub directory of the pack
+*
+* @param[in] name Name of the directory relative to this directory
+*
+* @return The container
+*
+*/
+std::shared_ptr< CDataContainer > CPackDataContainer::DataContainer(const std::string &name){
+    return std::make_shared< CPackDataContainer >(DPack, EntryName(name), DFallbackRoot);
+}
@@ -0,0 +1,90 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#include "PixelBlend.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+* Blends one premultiplied pixel over another
+*
+* @param[in] dest The pixel drawn on
+* @param[in] src The pixel drawn
+*
+* @return The blended pixel
+*
+*/
+static inline uint32_t BlendPixelOver(uint32_t dest, uint32_t src){
+    uint32_t Scale = 0xFF - (src >> 24);
+    uint32_t RB = (dest & 0x00FF00FF) * Scale + 0x00800080;
+    uint32_t AG = ((dest >> 8) & 0x00FF00FF) * Scale + 0x00800080;
+    
+    // Divide by 255 per channel
+    RB = ((RB + ((RB >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    AG = (AG + ((AG >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+    return src + (RB | AG);
+}
+
+/**
+* Blends a row of premultiplied pixels over another (Porter-Duff over),
+* dest = src + dest * (1 - src alpha). Fully transparent source pixels leave
+* the destination as is.
+*
+* @param[in] dest The pixels drawn on
+* @param[in] src The pixels drawn
+* @param[in] count Number of pixels
+*
+* @return Nothing
+*
+*/
+void CPixelBlend::Over(uint32_t *dest, const uint32_t *src, int count){
+    int Index = 0;
+    
+#ifdef __SSE2__
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i AlphaMax = _mm_set1_epi16(0xFF);
+    const __m128i Round = _mm_set1_epi16(0x80);
+    
+    for(; Index + 4 <= count; Index += 4){
+        __m128i Src = _mm_loadu_si128((const __m128i *)(src + Index));
+        __m128i Alpha = _mm_srli_epi32(Src, 24);
+        
+        if(0xFFFF == _mm_movemask_epi8(_mm_cmpeq_epi32(Alpha, Zero))){
+            continue;
+        }
+        __m128i Dest = _mm_loadu_si128((const __m128i *)(dest + Index));
+        
+        // Spread the alpha of each pixel over the four 16 bit channels of its pixel
+        Alpha = _mm_or_si128(Alpha, _mm_slli_epi32(Alpha, 16));
+        __m128i AlphaLow = _mm_sub_epi16(AlphaMax, _mm_unpacklo_epi32(Alpha, Alpha));
+        __m128i AlphaHigh = _mm_sub_epi16(AlphaMax, _mm_unpackhi_epi32(Alpha, Alpha));
+        __m128i DestLow = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(Dest, Zero), AlphaLow), Round);
+        __m128i DestHigh = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(Dest, Zero), AlphaHigh), Round);
+        
+        // Divide by 255 per channel
+        DestLow = _mm_srli_epi16(_mm_add_epi16(DestLow, _mm_srli_epi16(DestLow, 8)), 8);
+        DestHigh = _mm_srli_epi16(_mm_add_epi16(DestHigh, _mm_srli_epi16(DestHigh, 8)), 8);
+        Dest = _mm_packus_epi16(DestLow, DestHigh);
+        _mm_storeu_si128((__m128i *)(dest + Index), _mm_adds_epu8(Src, Dest));
+    }
+#endif
+    for(; Index < count; Index++){
+        if(src[Index] >> 24){
+            dest[Index] = BlendPixelOver(dest[Index], src[Index]);
+        }
+    }
+}
@@ -1107,7 +1107,6 @@ std::shared_ptr< CPlayerAsset > CPlayerAssetType::Construct(){
 
 int CPlayerAsset::DUpdateFrequency = 1;
 int CPlayerAsset::DUpdateDivisor = 32;
-CRandomNumberGenerator CPlayerAsset::DGenerateRandomNum;
 
 /**
 * Determine the frequency that player asset should be updated
@@ -1152,7 +1151,7 @@ int CPlayerAsset::UpdateFrequency(int freq){
 * @return None
 */
 CPlayerAsset::CPlayerAsset(std::shared_ptr< CPlayerAssetType > type) : DPosition(0,0){
-    DAssetID = GetAssetIDCount();
+    DAssetID = -1;
     DCreationCycle = 0;
     DType = type;
     DHitPoints = type->HitPoints();
@@ -1164,6 +1163,7 @@ CPlayerAsset::CPlayerAsset(std::shared_ptr< CPlayerAssetType > type) : DPosition
     DMoveRemainderY = 0;
     DDirection = EDirection::South;
     TilePosition(CTilePosition());
+    DPreviousPosition = DPosition;
 }
 
 CPlayerAsset::~CPlayerAsset(){
@@ -0,0 +1,182 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+
+/**
+ * @brief
+ *      RecorderMain.cpp , headless AI versus AI match recorder
+ *
+ *      recorder -m map -b brain1.lua,brain2.lua -o outputdir [-s seed]
+ *               [-c maxcycles] [-i interval] [-f png|raw] [-w width -h height]
+ *               [-n minimapsize] [-p player] [-j encoders] [-r software|cairo]
+ *               [-d datadir]
+ *
+*/
+#include "MatchRecorder.h"
+#include "ApplicationPath.h"
+#include "AssetDecoratedMap.h"
+#include "FileDataContainer.h"
+#include "GraphicFactory.h"
+#include "PackDataContainer.h"
+#include "PlayerAsset.h"
+#include "Tokenizer.h"
+#include "Debug.h"
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+
+#ifndef DEBUG_LEVEL
+#define DEBUG_LEVEL DEBUG_LOW
+#endif
+
+#define DEFAULT_MAX_CYCLES      (20 * 60 * 20)
+#define DEFAULT_INTERVAL        20
+#define DEFAULT_MINIMAP_SIZE    128
+#define DEFAULT_WIDTH           1920
+#define DEFAULT_HEIGHT          1080
+
+/**
+ * Prints the command line usage
+ *
+ * @param[in] progname Name the program was run as
+ *
+ * @return Nothing
+*/
+static void PrintUsage(const char *progname){
+    fprintf(stderr, "Usage: %s -m map -b brains -o outputdir [-s seed] [-c maxcycles] [-i interval] [-f png|raw]\n", progname);
+    fprintf(stderr, "       [-w width -h height] [-n minimapsize] [-p player] [-j encoders] [-r software|cairo] [-d datadir]\n");
+    fprintf(stderr, "    brains is a comma separated list, a frame is recorded every interval cycles\n");
+    fprintf(stderr, "    the viewport is 1920x1080 by default and shows the whole map with a width and height of 0,\n");
+    fprintf(stderr, "    a minimap size of 0 skips it\n");
+}
+
+/**
+ * Main function of the match recorder
+ *
+ * @param[in] argc Integer containing the number of command line arguments, indexed from 0
+ * @param[in] argv Character pointer containing the command line arguments, indexed by argc
+ *
+ * @return Exit code, 0 if the match was played and all frames written
+*/
+int main(int argc, char *argv[]){
+    CTournament::SMatchSettings Settings;
+    std::vector< std::string > Brains;
+    std::string DataPath = GetApplicationPath().Containing().ToString() + "/data";
+    std::string OutputPath;
+    CMatchRecorder::EFrameFormat Format = CMatchRecorder::EFrameFormat::PNG;
+    int Interval = DEFAULT_INTERVAL;
+    int Width = DEFAULT_WIDTH, Height = DEFAULT_HEIGHT;
+    int MiniMapSize = DEFAULT_MINIMAP_SIZE;
+    int Player = 1;
+    int EncoderCount = 0;
+
+    OpenDebug("Recorder.out", DEBUG_LEVEL);
+
+    Settings.DSeed = 0x123456789ABCDEFULL;
+    Settings.DMaxCycles = DEFAULT_MAX_CYCLES;
+    for(int Index = 1; Index < argc; Index++){
+        if(Index + 1 >= argc){
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        std::string Option = argv[Index];
+        std::string Value = argv[++Index];
+
+        if(Option == "-m"){
+            Settings.DMapName = Value;
+        }
+        else if(Option == "-b"){
+            CTokenizer::Tokenize(Brains, Value, ",");
+        }
+        else if(Option == "-o"){
+            OutputPath = Value;
+        }
+        else if(Option == "-s"){
+            Settings.DSeed = std::strtoull(Value.c_str(), nullptr, 0);
+        }
+        else if(Option == "-c"){
+            Settings.DMaxCycles = std::atoi(Value.c_str());
+        }
+        else if(Option == "-i"){
+            Interval = std::atoi(Value.c_str());
+        }
+        else if((Option == "-f")&&((Value == "png")||(Value == "raw"))){
+            Format = Value == "png" ? CMatchRecorder::EFrameFormat::PNG : CMatchRecorder::EFrameFormat::Raw;
+        }
+        else if(Option == "-w"){
+            Width = std::atoi(Value.c_str());
+        }
+        else if(Option == "-h"){
+            Height = std::atoi(Value.c_str());
+        }
+        else if(Option == "-n"){
+            MiniMapSize = std::atoi(Value.c_str());
+        }
+        else if(Option == "-p"){
+            Player = std::atoi(Value.c_str());
+        }
+        else if(Option == "-j"){
+            EncoderCount = std::atoi(Value.c_str());
+        }
+        else if((Option == "-r")&&((Value == "software")||(Value == "cairo"))){
+            CGraphicFactory::Backend(Value == "software" ? CGraphicFactory::EBackend::Software : CGraphicFactory::EBackend::Cairo);
+        }
+        else if(Option == "-d"){
+            DataPath = Value;
+        }
+        else{
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if(Settings.DMapName.empty() || Brains.empty() || OutputPath.empty() || (1 > Player) || (to_underlying(EPlayerColor::Max) <= Player)){
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The tilesets set the tile dimensions, so they load before the maps
+    auto DataContainer = CPackDataContainer::OpenDataContainer(DataPath, true);
+    mkdir(OutputPath.c_str(), S_IRWXU);
+    CMatchRecorder Recorder(std::make_shared< CDirectoryDataContainer >(OutputPath), Format, Interval, EncoderCount);
+
+    if(!Recorder.LoadTilesets(DataContainer->DataContainer("img"))){
+        return EXIT_FAILURE;
+    }
+    if(!CTournament::LoadGameData(DataPath)){
+        return EXIT_FAILURE;
+    }
+    int MapIndex = CAssetDecoratedMap::FindMapIndex(Settings.DMapName);
+
+    if(0 > MapIndex){
+        PrintError("Failed to find map \"%s\"\n", Settings.DMapName.c_str());
+        return EXIT_FAILURE;
+    }
+    for(int Seat = 1; Seat <= CAssetDecoratedMap::GetMap(MapIndex)->PlayerCount(); Seat++){
+        Settings.DBrains[Seat] = Brains[(Seat - 1) % Brains.size()];
+    }
+    Recorder.PlayerColor(static_cast<EPlayerColor>(Player));
+    Recorder.ViewportSize(Width, Height);
+    Recorder.MiniMapSize(MiniMapSize);
+
+    auto Result = Recorder.Record(Settings);
+
+    if(!Result.DValid){
+        return EXIT_FAILURE;
+    }
+    printf("%s seed %llu: %d cycles, winner %s\n", Settings.DMapName.c_str(), (unsigned long long)Settings.DSeed, Result.DCycles, EPlayerColor::None == Result.DWinner ? "draw" : Result.DPlayers[to_underlying(Result.DWinner)].DBrain.c_str());
+    printf("%d frames written, %d failed\n", Recorder.FramesWritten(), Recorder.FramesFailed());
+    return Recorder.FramesFailed() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
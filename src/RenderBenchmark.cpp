@@ -0,0 +1,215 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#include "RenderBenchmark.h"
+#include "AssetDecoratedMap.h"
+#include "GameModel.h"
+#include "GraphicFactory.h"
+#include "Debug.h"
+#include <chrono>
+#include <cstdlib>
+#include <set>
+
+#define BENCHMARK_SEED  0x123456789ABCDEFULL
+
+/**
+* Creates a renderer benchmark
+*
+* @param[in] goldens Container of the golden images
+* @param[in] framecount Number of frames timed at each resolution
+* @param[in] minimapsize Width and height of the minimap
+* @param[in] tolerance Largest difference of a channel from the golden that still matches
+* @param[in] updategoldens Store the first frames as the golden images instead of comparing
+*
+*/
+CRenderBenchmark::CRenderBenchmark(std::shared_ptr< CDataContainer > goldens, int framecount, int minimapsize, int tolerance, bool updategoldens){
+    DGoldenContainer = goldens;
+    DFrameCount = std::max(1, framecount);
+    DMiniMapSize = minimapsize;
+    DTolerance = tolerance;
+    DUpdateGoldens = updategoldens;
+}
+
+/**
+* Name of a golden image, characters of the map name other than letters and
+* digits are replaced so it is a valid file name
+*
+* @param[in] mapname Name of the map
+* @param[in] width Width of the viewport
+* @param[in] height Height of the viewport
+* @param[in] suffix Name of the renderer the image is of
+*
+* @return Name of the golden image file
+*
+*/
+std::string CRenderBenchmark::GoldenName(const std::string &mapname, int width, int height, const std::string &suffix){
+    std::string Name;
+
+    for(auto Char : mapname){
+        Name += isalnum(Char) ? Char : '_';
+    }
+    return Name + "_" + std::to_string(width) + "x" + std::to_string(height) + "_" + suffix + ".png";
+}
+
+/**
+* Compares a surface against its golden image, or stores it as the golden
+*
+* @param[in] name Name of the golden image
+* @param[in] surface The drawn surface
+*
+* @return Number of pixels that differ, -1 if the golden is missing or is of another size
+*
+*/
+int CRenderBenchmark::CheckGolden(const std::string &name, std::shared_ptr< CGraphicSurface > surface){
+    if(DUpdateGoldens){
+        auto Sink = DGoldenContainer->DataSink(name);
+
+        if(!Sink || !CGraphicFactory::StoreSurface(Sink, surface)){
+            PrintError("Failed to store golden %s\n", name.c_str());
+            return -1;
+        }
+        return 0;
+    }
+    auto Source = DGoldenContainer->DataSource(name);
+    std::shared_ptr< CGraphicSurface > Golden = Source ? CGraphicFactory::LoadSurface(Source) : nullptr;
+
+    if(!Golden || (Golden->Width() != surface->Width()) || (Golden->Height() != surface->Height())){
+        PrintError("Missing golden %s\n", name.c_str());
+        return -1;
+    }
+    int Stride, GoldenStride;
+    int Mismatches = 0;
+    const uint8_t *Pixels = surface->LockPixels(Stride);
+    const uint8_t *GoldenPixels = Golden->LockPixels(GoldenStride);
+
+    for(int Row = 0; Pixels && GoldenPixels && (Row < surface->Height()); Row++){
+        const uint32_t *Pixel = (const uint32_t *)(Pixels + Stride * Row);
+        const uint32_t *GoldenPixel = (const uint32_t *)(GoldenPixels + GoldenStride * Row);
+
+        for(int Col = 0; Col < surface->Width(); Col++){
+            for(int Shift = 0; Shift < 32; Shift += 8){
+                if(DTolerance < std::abs(int((Pixel[Col] >> Shift) & 0xFF) - int((GoldenPixel[Col] >> Shift) & 0xFF))){
+                    Mismatches++;
+                    break;
+                }
+            }
+        }
+    }
+    surface->UnlockPixels();
+    Golden->UnlockPixels();
+    return Mismatches;
+}
+
+/**
+* Benchmarks a map at each of the resolutions. Viewports larger than the
+* map are reduced to the size of the map, resolutions reduced to one that
+* was already drawn are skipped.
+*
+* @param[in] mapname Name of the map
+* @param[in] resolutions Width and height of each viewport drawn
+* @param[out] results Result of each resolution is appended
+*
+* @return true if the map was found
+*
+*/
+bool CRenderBenchmark::Run(const std::string &mapname, const std::vector< std::pair< int, int > > &resolutions, std::vector< SResult > &results){
+    std::array< EPlayerColor, to_underlying(EPlayerColor::Max) > Colors;
+    std::list< std::weak_ptr< CPlayerAsset > > SelectionMarkerList;
+    SRectangle SelectRectangle({0, 0, 0, 0});
+    std::set< std::pair< int, int > > DrawnSizes;
+    int MapIndex = CAssetDecoratedMap::FindMapIndex(mapname);
+
+    if(0 > MapIndex){
+        PrintError("Failed to find map \"%s\"\n", mapname.c_str());
+        return false;
+    }
+    for(int Index = 0; Index < to_underlying(EPlayerColor::Max); Index++){
+        Colors[Index] = static_cast<EPlayerColor>(Index);
+    }
+    // One timestep updates the visibility of the starting assets
+    auto GameModel = std::make_shared< CGameModel >(MapIndex, BENCHMARK_SEED, Colors);
+
+    GameModel->Timestep();
+    GameModel->ClearGameEvents();
+
+    for(auto &Resolution : resolutions){
+        SResult Result;
+        int MapWidth = GameModel->Map()->Width() * CPosition::TileWidth();
+        int MapHeight = GameModel->Map()->Height() * CPosition::TileHeight();
+
+        Result.DMapName = mapname;
+        Result.DWidth = std::min(Resolution.first, MapWidth);
+        Result.DHeight = std::min(Resolution.second, MapHeight);
+        if(!DrawnSizes.insert(std::make_pair(Result.DWidth, Result.DHeight)).second){
+            continue;
+        }
+        Result.DFrames = DFrameCount;
+        Result.DMapTime = Result.DAssetTime = Result.DFogTime = Result.DMiniMapTime = 0.0;
+        Result.DMiniMapMismatches = 0;
+
+        DRenderer.CreateRenderers(GameModel, EPlayerColor::Red, Result.DWidth, Result.DHeight);
+
+        auto ViewportSurface = CGraphicFactory::CreateSurface(Result.DWidth, Result.DHeight, CGraphicSurface::ESurfaceFormat::ARGB32);
+        auto MiniMapSurface = 0 < DMiniMapSize ? CGraphicFactory::CreateSurface(DMiniMapSize, DMiniMapSize, CGraphicSurface::ESurfaceFormat::ARGB32) : nullptr;
+        auto ViewportRenderer = DRenderer.ViewportRenderer();
+        SRectangle ViewportRectangle;
+
+        // Clamps the viewport to the map the same way DrawViewport does
+        ViewportRenderer->ViewportX(ViewportRenderer->ViewportX());
+        ViewportRenderer->ViewportY(ViewportRenderer->ViewportY());
+        ViewportRectangle.DXPosition = ViewportRenderer->ViewportX();
+        ViewportRectangle.DYPosition = ViewportRenderer->ViewportY();
+        ViewportRectangle.DWidth = Result.DWidth;
+        ViewportRectangle.DHeight = Result.DHeight;
+
+        for(int Frame = 0; Frame < DFrameCount; Frame++){
+            auto StartTime = std::chrono::steady_clock::now();
+
+            DRenderer.MapRenderer()->DrawMap(ViewportSurface, ViewportRectangle);
+            auto MapTime = std::chrono::steady_clock::now();
+
+            DRenderer.AssetRenderer()->DrawSelections(ViewportSurface, ViewportRectangle, SelectionMarkerList, SelectRectangle, false);
+            DRenderer.AssetRenderer()->DrawAssets(ViewportSurface, ViewportRectangle);
+            DRenderer.AssetRenderer()->DrawOverlays(ViewportSurface, ViewportRectangle);
+            auto AssetTime = std::chrono::steady_clock::now();
+
+            DRenderer.FogRenderer()->DrawMap(ViewportSurface, ViewportRectangle);
+            auto FogTime = std::chrono::steady_clock::now();
+
+            if(MiniMapSurface){
+                DRenderer.DrawMiniMap(MiniMapSurface);
+            }
+            auto MiniMapTime = std::chrono::steady_clock::now();
+
+            Result.DMapTime += std::chrono::duration< double, std::milli >(MapTime - StartTime).count();
+            Result.DAssetTime += std::chrono::duration< double, std::milli >(AssetTime - MapTime).count();
+            Result.DFogTime += std::chrono::duration< double, std::milli >(FogTime - AssetTime).count();
+            Result.DMiniMapTime += std::chrono::duration< double, std::milli >(MiniMapTime - FogTime).count();
+            if(!Frame){
+                Result.DViewportMismatches = CheckGolden(GoldenName(mapname, Result.DWidth, Result.DHeight, "viewport"), ViewportSurface);
+                if(MiniMapSurface){
+                    Result.DMiniMapMismatches = CheckGolden(GoldenName(mapname, Result.DWidth, Result.DHeight, "minimap"), MiniMapSurface);
+                }
+            }
+        }
+        Result.DMapTime /= DFrameCount;
+        Result.DAssetTime /= DFrameCount;
+        Result.DFogTime /= DFrameCount;
+        Result.DMiniMapTime /= DFrameCount;
+        results.push_back(Result);
+    }
+    return true;
+}
@@ -0,0 +1,198 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+
+/**
+ * @brief
+ *      RenderBenchmarkMain.cpp , renderer timing and golden image regression
+ *
+ *      renderbench [-m map1,map2] [-x 1920x1080,3840x2160] [-f frames]
+ *                  [-n minimapsize] [-g goldendir] [-t tolerance] [-u]
+ *                  [-r software|cairo] [-d datadir]
+ *
+ *      Goldens are kept in goldendir/software and goldendir/cairo, the
+ *      reviewed software goldens are part of the tree.
+ *
+*/
+#include "RenderBenchmark.h"
+#include "ApplicationPath.h"
+#include "AssetDecoratedMap.h"
+#include "FileDataContainer.h"
+#include "GraphicFactory.h"
+#include "PackDataContainer.h"
+#include "Tokenizer.h"
+#include "Tournament.h"
+#include "Debug.h"
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+
+#ifndef DEBUG_LEVEL
+#define DEBUG_LEVEL DEBUG_LOW
+#endif
+
+#define DEFAULT_FRAMES          60
+#define DEFAULT_MINIMAP_SIZE    128
+#define DEFAULT_TOLERANCE       2
+
+/**
+ * Prints the command line usage
+ *
+ * @param[in] progname Name the program was run as
+ *
+ * @return Nothing
+*/
+static void PrintUsage(const char *progname){
+    fprintf(stderr, "Usage: %s [-m maps] [-x resolutions] [-f frames] [-n minimapsize] [-g goldendir] [-t tolerance] [-u]\n", progname);
+    fprintf(stderr, "       [-r software|cairo] [-d datadir]\n");
+    fprintf(stderr, "    maps and resolutions (WIDTHxHEIGHT) are comma separated lists, all maps at 1080p and 4K by default\n");
+    fprintf(stderr, "    -u stores the first frames as the golden images instead of comparing against them\n");
+    fprintf(stderr, "    goldens are kept in a directory per backend below goldendir, as the backends draw differently\n");
+}
+
+/**
+ * Formats the golden comparison of a result
+ *
+ * @param[in] mismatches Number of pixels that differ from the golden
+ * @param[in] update The goldens were stored
+ *
+ * @return Text of the comparison
+*/
+static std::string GoldenStatus(int mismatches, bool update){
+    if(0 > mismatches){
+        return update ? "failed" : "missing";
+    }
+    if(update){
+        return "stored";
+    }
+    return mismatches ? std::to_string(mismatches) + " px" : "match";
+}
+
+/**
+ * Main function of the renderer benchmark
+ *
+ * @param[in] argc Integer containing the number of command line arguments, indexed from 0
+ * @param[in] argv Character pointer containing the command line arguments, indexed by argc
+ *
+ * @return Exit code, 0 if all output matched the goldens
+*/
+int main(int argc, char *argv[]){
+    std::vector< std::string > Maps;
+    std::vector< std::pair< int, int > > Resolutions;
+    std::vector< CRenderBenchmark::SResult > Results;
+    std::string DataPath = GetApplicationPath().Containing().ToString() + "/data";
+    std::string GoldenPath = GetApplicationPath().Containing().ToString() + "/goldens";
+    int FrameCount = DEFAULT_FRAMES;
+    int MiniMapSize = DEFAULT_MINIMAP_SIZE;
+    int Tolerance = DEFAULT_TOLERANCE;
+    bool UpdateGoldens = false;
+    bool Passed = true;
+
+    OpenDebug("RenderBenchmark.out", DEBUG_LEVEL);
+
+    for(int Index = 1; Index < argc; Index++){
+        std::string Option = argv[Index];
+
+        if(Option == "-u"){
+            UpdateGoldens = true;
+            continue;
+        }
+        if(Index + 1 >= argc){
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        std::string Value = argv[++Index];
+        std::vector< std::string > Tokens;
+
+        CTokenizer::Tokenize(Tokens, Value, ",");
+        if(Option == "-m"){
+            Maps.insert(Maps.end(), Tokens.begin(), Tokens.end());
+        }
+        else if(Option == "-x"){
+            for(auto &Token : Tokens){
+                int Width, Height;
+
+                if((2 != sscanf(Token.c_str(), "%dx%d", &Width, &Height))||(0 >= Width)||(0 >= Height)){
+                    PrintUsage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                Resolutions.push_back(std::make_pair(Width, Height));
+            }
+        }
+        else if(Option == "-f"){
+            FrameCount = std::atoi(Value.c_str());
+        }
+        else if(Option == "-n"){
+            MiniMapSize = std::atoi(Value.c_str());
+        }
+        else if(Option == "-g"){
+            GoldenPath = Value;
+        }
+        else if(Option == "-t"){
+            Tolerance = std::atoi(Value.c_str());
+        }
+        else if((Option == "-r")&&((Value == "software")||(Value == "cairo"))){
+            CGraphicFactory::Backend(Value == "software" ? CGraphicFactory::EBackend::Software : CGraphicFactory::EBackend::Cairo);
+        }
+        else if(Option == "-d"){
+            DataPath = Value;
+        }
+        else{
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if(Resolutions.empty()){
+        Resolutions.push_back(std::make_pair(1920, 1080));
+        Resolutions.push_back(std::make_pair(3840, 2160));
+    }
+
+    // The tilesets set the tile dimensions, so they load before the maps
+    auto DataContainer = CPackDataContainer::OpenDataContainer(DataPath, true);
+    std::string BackendGoldenPath = GoldenPath + (CGraphicFactory::EBackend::Software == CGraphicFactory::Backend() ? "/software" : "/cairo");
+    if(UpdateGoldens){
+        mkdir(GoldenPath.c_str(), S_IRWXU);
+        mkdir(BackendGoldenPath.c_str(), S_IRWXU);
+    }
+    CRenderBenchmark Benchmark(std::make_shared< CDirectoryDataContainer >(BackendGoldenPath), FrameCount, MiniMapSize, Tolerance, UpdateGoldens);
+
+    if(!Benchmark.LoadTilesets(DataContainer->DataContainer("img"))){
+        return EXIT_FAILURE;
+    }
+    if(!CTournament::LoadGameData(DataPath)){
+        return EXIT_FAILURE;
+    }
+    if(Maps.empty()){
+        for(int Index = 0; CAssetDecoratedMap::GetMap(Index); Index++){
+            Maps.push_back(CAssetDecoratedMap::GetMap(Index)->MapName());
+        }
+    }
+    for(auto &MapName : Maps){
+        if(!Benchmark.Run(MapName, Resolutions, Results)){
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%-32s %11s %6s %9s %9s %9s %9s %9s %9s %9s\n", "Map", "Resolution", "Frames", "Map", "Assets", "Fog", "Viewport", "MiniMap", "Viewport", "MiniMap");
+    printf("%-32s %11s %6s %9s %9s %9s %9s %9s %9s %9s\n", "", "", "", "ms/frame", "ms/frame", "ms/frame", "ms/frame", "ms/frame", "golden", "golden");
+    for(auto &Result : Results){
+        std::string Resolution = std::to_string(Result.DWidth) + "x" + std::to_string(Result.DHeight);
+
+        printf("%-32s %11s %6d %9.3f %9.3f %9.3f %9.3f %9.3f %9s %9s\n", Result.DMapName.c_str(), Resolution.c_str(), Result.DFrames, Result.DMapTime, Result.DAssetTime, Result.DFogTime, Result.DMapTime + Result.DAssetTime + Result.DFogTime, Result.DMiniMapTime, GoldenStatus(Result.DViewportMismatches, UpdateGoldens).c_str(), 0 < MiniMapSize ? GoldenStatus(Result.DMiniMapMismatches, UpdateGoldens).c_str() : "-");
+        Passed &= (0 == Result.DViewportMismatches) && (0 == Result.DMiniMapMismatches);
+    }
+    return Passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -38,9 +38,6 @@
 *
 */
 
-EDirection CRouterMap::DIdealSearchDirection = EDirection::North;
-int CRouterMap::DMapWidth = 1;
-
 /**
 * Determine if two directions are away from each other
 *
@@ -21,9 +21,39 @@
 #include <mpg123.h>
 #include <cstring>
                 
+/**
+* Returns the whole content of a source, viewed in place when the source
+* has a view and read into buffer in blocks otherwise.
+*
+* @param[in] source Source to read
+* @param[out] buffer Holds the content of sources without a view
+* @param[out] length Length of the content
+*
+* @return The content
+*/
+static const uint8_t *SourceContent(std::shared_ptr< CDataSource > source, std::vector< uint8_t > &buffer, sf_count_t &length){
+    const void *View;
+    int ViewLength;
+    uint8_t Block[4096];
+    int BlockLength;
+
+    if((View = source->View(ViewLength))){
+        length = ViewLength;
+        return (const uint8_t *)View;
+    }
+    while(0 < (BlockLength = source->Read(Block, sizeof(Block)))){
+        buffer.insert(buffer.end(), Block, Block + BlockLength);
+    }
+    length = buffer.size();
+    return buffer.data();
+}
+
 class CSFVirtualIODataSource{
     protected:
-      std::vector< uint8_t > DData;
+      std::shared_ptr< CDataSource > DSource;
+      std::vector< uint8_t > DBuffer;
+      const uint8_t *DData;
+      sf_count_t DLength;
       sf_count_t DOffset;
       
       static sf_count_t GetFileLength(CSFVirtualIODataSource *iosource);
@@ -39,11 +69,9 @@ class CSFVirtualIODataSource{
 };                                     
 
 CSFVirtualIODataSource::CSFVirtualIODataSource(std::shared_ptr< CDataSource > source){
-    uint8_t TempByte;
-    
-    while(0 < source->Read(&TempByte, 1)){
-        DData.push_back(TempByte);   
-    }
+    // Keep the source as its view is only valid as long as it is
+    DSource = source;
+    DData = SourceContent(source, DBuffer, DLength);
     DOffset = 0;
 }
 
@@ -59,7 +87,7 @@ SF_VIRTUAL_IO CSFVirtualIODataSource::SFVirtualIO() const{
 }
 
 sf_count_t CSFVirtualIODataSource::GetFileLength(CSFVirtualIODataSource *iosource){
-    return iosource->DData.size();
+    return iosource->DLength;
 }
 
 sf_count_t CSFVirtualIODataSource::Seek(sf_count_t offset, int whence, CSFVirtualIODataSource *iosource){
@@ -70,22 +98,22 @@ sf_count_t CSFVirtualIODataSource::Seek(sf_count_t offset, int whence, CSFVirtua
         iosource->DOffset += offset;
     }
     else if(SEEK_END == whence){
-        iosource->DOffset = iosource->DData.size() + offset;        
+        iosource->DOffset = iosource->DLength + offset;        
     }
     if(0 > iosource->DOffset){
         iosource->DOffset = 0;    
     }
-    else if(iosource->DData.size() < iosource->DOffset){
-        iosource->DOffset = iosource->DData.size();
+    else if(iosource->DLength < iosource->DOffset){
+        iosource->DOffset = iosource->DLength;
     }
     return iosource->DOffset;
 }
 
 sf_count_t CSFVirtualIODataSource::Read(void *ptr, sf_count_t count, CSFVirtualIODataSource *iosource){
-    if(iosource->DOffset + count > iosource->DData.size()){
-        count = iosource->DData.size() - iosource->DOffset;
+    if(iosource->DOffset + count > iosource->DLength){
+        count = iosource->DLength - iosource->DOffset;
     }
-    memcpy(ptr, iosource->DData.data() + iosource->DOffset, count);
+    memcpy(ptr, iosource->DData + iosource->DOffset, count);
     iosource->DOffset += count;
     return count;
 }
@@ -143,17 +171,16 @@ CSoundClip &CSoundClip::operator=(const CSoundClip &clip){
 
 bool CSoundClip::Load(std::shared_ptr< CDataSource > source, bool ismp3){
     if(ismp3){
-        std::vector< unsigned char > DataBuffer;
-        uint8_t TempByte;
+        std::vector< uint8_t > DataBuffer;
+        const uint8_t *Data;
+        sf_count_t DataLength;
         mpg123_handle *MPG123Handle;
         int ReturnValue;
         bool ReturnStatus = false;
         
         LibraryReference();
         
-        while(0 < source->Read(&TempByte, 1)){
-            DataBuffer.push_back(TempByte);   
-        }
+        Data = SourceContent(source, DataBuffer, DataLength);
         
         MPG123Handle = mpg123_new(NULL, &ReturnValue);
         if(NULL == MPG123Handle){
@@ -170,7 +197,7 @@ bool CSoundClip::Load(std::shared_ptr< CDataSource > source, bool ismp3){
                     int Channels, Encoding;
                     size_t BytesRead;
                     
-                    ReturnValue = mpg123_feed(MPG123Handle, DataBuffer.data(), DataBuffer.size());
+                    ReturnValue = mpg123_feed(MPG123Handle, Data, DataLength);
                     if(MPG123_OK == ReturnValue){
                         ReturnValue = mpg123_getformat(MPG123Handle, &Rate, &Channels, &Encoding);
                         
@@ -340,15 +340,19 @@ bool CSoundEventRenderer::OnScreen(const SRectangle &viewportrect, const CPositi
 */
 void CSoundEventRenderer::RenderEvents(const SRectangle &viewportrect){
     int MainRandomNumber = DRandomNumberGenerator.Random();
-    std::vector< SGameEvent > AllEvents = DDelayedEvents;
+    std::vector< SGameEvent > DelayedEvents;
     std::vector< int > Selections, Acknowledges;
+    int EventCount;
 
-    DDelayedEvents.clear();
+    DelayedEvents.swap(DDelayedEvents);
     Selections.resize(to_underlying(EAssetType::Max));
     Acknowledges.resize(to_underlying(EAssetType::Max));
 
-    AllEvents.insert(AllEvents.end(), DPlayer->GameEvents().begin(), DPlayer->GameEvents().end());
-    for(auto Event : AllEvents){
+    // Delayed events followed by the events of the player, read in place
+    EventCount = DelayedEvents.size() + DPlayer->GameEventCount();
+    for(int Index = 0; Index < EventCount; Index++){
+        const SGameEvent &Event = Index < DelayedEvents.size() ? DelayedEvents[Index] : DPlayer->GameEvent(Index - DelayedEvents.size());
+
         if(EEventType::Selection == Event.DType){
             if(Event.DAsset){
                 if((EPlayerColor::None == Event.DAsset->Color())||(DPlayer->Color() == Event.DAsset->Color())){
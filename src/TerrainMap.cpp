@@ -20,6 +20,8 @@
 #include "Debug.h"
 #include <cstdio>
 #include <cstdlib>
+
+#define MAX_MAP_DIMENSION   4096
                              
 /**
 *
@@ -71,6 +73,7 @@ bool CTerrainMap::DAllowedAdjacent[to_underlying(ETerrainTileType::Max)][to_unde
 
 CTerrainMap::CTerrainMap(){
     DRendered = false;
+    DAllTilesChanged = true;
 }
 
 /**
@@ -89,6 +92,7 @@ CTerrainMap::CTerrainMap(const CTerrainMap &map){
     DMap = map.DMap;
     DMapIndices = map.DMapIndices;
     DRendered = map.DRendered;
+    DAllTilesChanged = true;
 }
 
 /**
@@ -121,6 +125,7 @@ CTerrainMap &CTerrainMap::operator=(const CTerrainMap &map){
         DMap = map.DMap;
         DMapIndices = map.DMapIndices;
         DRendered = map.DRendered;        
+        AllTilesChanged();
     }
     return *this;
 }
@@ -207,6 +212,7 @@ void CTerrainMap::ChangeTerrainTilePartial(int xindex, int yindex, uint8_t val){
                         CalculateTileTypeAndIndex(XPos-1, YPos-1, Type, Index);
                         DMap[YPos][XPos] = Type;
                         DMapIndices[YPos][XPos] = Index;
+                        TileChanged(XPos, YPos);
                     }
                 }
             }
@@ -392,6 +398,73 @@ void CTerrainMap::RenderTerrain(){
         }
     }
     DRendered = true;
+    AllTilesChanged();
+}
+
+/**
+* Records that the tile at a DMap position changed since the changed tiles
+* were last taken. Each tile is only recorded once.
+*
+* @param[in] xpos The x index into DMap
+* @param[in] ypos The y index into DMap
+*
+* @return Nothing
+*
+*/
+
+void CTerrainMap::TileChanged(int xpos, int ypos){
+    if(DAllTilesChanged){
+        return;
+    }
+    if((DChangedFlags.size() != DMap.size())||(DChangedFlags[0].size() != DMap[0].size())){
+        DChangedFlags.resize(DMap.size());
+        for(auto &Row : DChangedFlags){
+            Row.assign(DMap[0].size(), false);
+        }
+    }
+    if(!DChangedFlags[ypos][xpos]){
+        DChangedFlags[ypos][xpos] = true;
+        DChangedTiles.push_back(CTilePosition(xpos - 1, ypos - 1));
+    }
+}
+
+/**
+* Records that the whole map changed, dropping any individually changed tiles
+*
+* @param[in] Nothing
+*
+* @return Nothing
+*
+*/
+
+void CTerrainMap::AllTilesChanged(){
+    DAllTilesChanged = true;
+    DChangedTiles.clear();
+    DChangedFlags.clear();
+}
+
+/**
+* Hands the tiles changed since the last call to the caller (the map
+* renderer), so it only has to redraw those tiles.
+*
+* @param[out] tiles Positions of the changed tiles
+*
+* @return true if the whole map changed and tiles should be ignored
+*
+*/
+
+bool CTerrainMap::TakeChangedTiles(std::vector< CTilePosition > &tiles){
+    bool AllChanged = DAllTilesChanged;
+    
+    tiles.clear();
+    if(!AllChanged){
+        tiles.swap(DChangedTiles);
+        for(auto &Tile : tiles){
+            DChangedFlags[Tile.Y() + 1][Tile.X() + 1] = false;
+        }
+    }
+    DAllTilesChanged = false;
+    return AllChanged;
 }
 
 /**
@@ -521,3 +594,83 @@ LoadMapExit:
     return ReturnStatus;
 }
 
+/**
+* Builds the DTerrainMap from a compiled map bundle, validated the same way
+* as the text map
+*
+* @param[in] reader Reader positioned at the terrain of the bundle
+*
+* @return true or false if map successfully loaded or not
+*
+*/
+
+bool CTerrainMap::LoadMap(CMapBundleReader &reader){
+    int MapWidth, MapHeight;
+    const uint8_t *Terrain, *Partials;
+
+    DTerrainMap.clear();
+    if(!reader.ReadString(DMapName)||!reader.ReadInt(MapWidth)||!reader.ReadInt(MapHeight)){
+        return false;
+    }
+    // Bounded so the terrain size of a bad header cannot overflow
+    if((8 > MapWidth)||(8 > MapHeight)||(MAX_MAP_DIMENSION < MapWidth)||(MAX_MAP_DIMENSION < MapHeight)){
+        return false;
+    }
+    Terrain = reader.ReadBytes((MapWidth + 1) * (MapHeight + 1));
+    Partials = reader.ReadBytes((MapWidth + 1) * (MapHeight + 1));
+    if(!Terrain || !Partials){
+        return false;
+    }
+    DTerrainMap.resize(MapHeight+1);
+    DPartials.resize(MapHeight+1);
+    for(int Index = 0; Index < DTerrainMap.size(); Index++){
+        DTerrainMap[Index].resize(MapWidth+1);
+        DPartials[Index].resize(MapWidth+1);
+        for(int Inner = 0; Inner < MapWidth+1; Inner++){
+            int Offset = Index * (MapWidth + 1) + Inner;
+
+            if((to_underlying(ETerrainTileType::None) == Terrain[Offset])||(to_underlying(ETerrainTileType::Max) <= Terrain[Offset])||(0x0F < Partials[Offset])){
+                DTerrainMap.clear();
+                return false;
+            }
+            DTerrainMap[Index][Inner] = static_cast<ETerrainTileType>(Terrain[Offset]);
+            DPartials[Index][Inner] = Partials[Offset];
+            if(Inner && !DAllowedAdjacent[to_underlying(DTerrainMap[Index][Inner])][to_underlying(DTerrainMap[Index][Inner-1])]){
+                DTerrainMap.clear();
+                return false;
+            }
+            if(Index && !DAllowedAdjacent[to_underlying(DTerrainMap[Index][Inner])][to_underlying(DTerrainMap[Index-1][Inner])]){
+                DTerrainMap.clear();
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+* Writes the terrain and partials of the map to a map bundle
+*
+* @param[in] writer The bundle being built
+*
+* @return Nothing
+*
+*/
+
+void CTerrainMap::SaveMap(CMapBundleWriter &writer) const{
+    std::vector< uint8_t > Bytes;
+
+    writer.WriteString(DMapName);
+    writer.WriteInt(Width());
+    writer.WriteInt(Height());
+    for(auto &Row : DTerrainMap){
+        for(auto &Tile : Row){
+            Bytes.push_back(to_underlying(Tile));
+        }
+    }
+    for(auto &Row : DPartials){
+        Bytes.insert(Bytes.end(), Row.begin(), Row.end());
+    }
+    writer.WriteBytes(Bytes.data(), Bytes.size());
+}
+
@@ -0,0 +1,310 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+#include "Tournament.h"
+#include "AIPlayer.h"
+#include "AssetDecoratedMap.h"
+#include "EventHandler.h"
+#include "GameModel.h"
+#include "PackDataContainer.h"
+#include "PlayerAsset.h"
+#include "Debug.h"
+#include <atomic>
+#include <thread>
+
+#define TOURNAMENT_TIMEOUT_INTERVAL     50
+#define TOURNAMENT_TIMEOUT_FREQUENCY    (1000 / TOURNAMENT_TIMEOUT_INTERVAL)
+
+/**
+* Creates a tournament
+*
+* @param[in] threadcount Number of matches run at once, hardware concurrency if less than 1
+*
+*/
+CTournament::CTournament(int threadcount){
+    DThreadCount = threadcount;
+    if(1 > DThreadCount){
+        DThreadCount = std::thread::hardware_concurrency();
+        if(1 > DThreadCount){
+            DThreadCount = 1;
+        }
+    }
+}
+
+/**
+* Loads the asset types, upgrades and maps shared (read only) by all matches.
+* Must be called before any match is run.
+*
+* @param[in] datapath Path of the data directory
+*
+* @return true if all data loaded
+*
+*/
+bool CTournament::LoadGameData(const std::string &datapath){
+    auto DataContainer = CPackDataContainer::OpenDataContainer(datapath, true);
+
+    if(!CPlayerAssetType::LoadTypes(DataContainer->DataContainer("res"))){
+        PrintError("Failed to load resources\n");
+        return false;
+    }
+    if(!CPlayerUpgrade::LoadUpgrades(DataContainer->DataContainer("upg"))){
+        PrintError("Failed to load upgrades\n");
+        return false;
+    }
+    if(!CAssetDecoratedMap::LoadMaps(DataContainer->DataContainer("map"))){
+        PrintError("Failed to load maps\n");
+        return false;
+    }
+    CPlayerAsset::UpdateFrequency(TOURNAMENT_TIMEOUT_FREQUENCY);
+    return true;
+}
+
+/**
+* Schedules a match for every map and seed, once for each rotation of the
+* brains over the seats of the map so no brain is favored by its start.
+*
+* @param[in] maps Names of the maps to play
+* @param[in] seeds Random seeds to play each map with
+* @param[in] brains Lua files of the AI brains competing
+* @param[in] maxcycles Number of game cycles after which a match is a draw
+*
+* @return true if all maps were found
+*
+*/
+bool CTournament::AddMatches(const std::vector< std::string > &maps, const std::vector< uint64_t > &seeds, const std::vector< std::string > &brains, int maxcycles){
+    if(brains.empty()){
+        return false;
+    }
+    for(auto &MapName : maps){
+        int MapIndex = CAssetDecoratedMap::FindMapIndex(MapName);
+
+        if(0 > MapIndex){
+            PrintError("Failed to find map \"%s\"\n", MapName.c_str());
+            return false;
+        }
+        int Seats = CAssetDecoratedMap::GetMap(MapIndex)->PlayerCount();
+
+        for(auto Seed : seeds){
+            for(int Rotation = 0; Rotation < brains.size(); Rotation++){
+                SMatchSettings Settings;
+
+                Settings.DMapName = MapName;
+                Settings.DSeed = Seed;
+                Settings.DMaxCycles = maxcycles;
+                for(int Seat = 1; Seat <= Seats; Seat++){
+                    Settings.DBrains[Seat] = brains[(Seat - 1 + Rotation) % brains.size()];
+                }
+                DMatches.push_back(Settings);
+            }
+        }
+    }
+    return true;
+}
+
+/**
+* Plays a single match to the end in the calling thread. The game loop
+* mirrors CBattleMode::Calculate without any of its rendering.
+*
+* @param[in] settings The match to play
+* @param[in] callback Called after every cycle, may be nullptr
+*
+* @return The result of the match
+*
+*/
+CTournament::SMatchResult CTournament::RunMatch(const SMatchSettings &settings, TCycleCallback callback){
+    SMatchResult Result;
+    std::array< EPlayerColor, to_underlying(EPlayerColor::Max) > Colors;
+    std::array< std::shared_ptr< CAIPlayer >, to_underlying(EPlayerColor::Max) > AIPlayers;
+    std::array< SPlayerCommandRequest, to_underlying(EPlayerColor::Max) > PlayerCommands;
+    int MapIndex = CAssetDecoratedMap::FindMapIndex(settings.DMapName);
+    bool TriggeredEnd = false;
+    bool TriggeredWon = false;
+
+    Result.DSettings = settings;
+    Result.DValid = false;
+    Result.DCycles = 0;
+    Result.DWinner = EPlayerColor::None;
+    Result.DLoser = EPlayerColor::None;
+    if(0 > MapIndex){
+        return Result;
+    }
+    for(int Index = 0; Index < to_underlying(EPlayerColor::Max); Index++){
+        Colors[Index] = static_cast<EPlayerColor>(Index);
+        PlayerCommands[Index].DAction = EAssetCapabilityType::None;
+    }
+
+    auto GameModel = std::make_shared< CGameModel >(MapIndex, settings.DSeed, Colors);
+    auto EventHandler = std::make_shared< CEventHandler >(GameModel);
+
+    EventHandler->RegisterAction();
+    EventHandler->SetEndGameCall([&TriggeredEnd, &TriggeredWon](bool won){
+        TriggeredEnd = true;
+        TriggeredWon = won;
+    });
+
+    for(int Index = 1; Index < to_underlying(EPlayerColor::Max); Index++){
+        auto PlayerData = GameModel->Player(static_cast<EPlayerColor>(Index));
+
+        if(!settings.DBrains[Index].empty() && PlayerData->IsAlive()){
+            PlayerData->IsAI(true);
+            AIPlayers[Index] = std::make_shared< CAIPlayer >(PlayerData, CPlayerAsset::UpdateFrequency(), settings.DBrains[Index]);
+        }
+    }
+
+    while(!TriggeredEnd && (Result.DCycles < settings.DMaxCycles)){
+        int PlayersLeft = 0;
+
+        GameModel->GetTriggerHandler()->Resolve(ETriggerType::Time, false, EPlayerColor::None, -1, STriggerArgs::Time(Result.DCycles * TOURNAMENT_TIMEOUT_INTERVAL));
+        for(int Index = 1; Index < to_underlying(EPlayerColor::Max); Index++){
+            if(AIPlayers[Index] && GameModel->Player(static_cast<EPlayerColor>(Index))->IsAlive()){
+                PlayersLeft++;
+                AIPlayers[Index]->CalculateCommand(PlayerCommands[Index]);
+            }
+        }
+        if(1 >= PlayersLeft){
+            break;
+        }
+        for(int Index = 1; Index < to_underlying(EPlayerColor::Max); Index++){
+            GameModel->ApplyPlayerCommand(static_cast<EPlayerColor>(Index), PlayerCommands[Index]);
+        }
+        GameModel->Timestep();
+        Result.DCycles++;
+        if(callback){
+            callback(GameModel, Result.DCycles);
+        }
+        GameModel->ClearGameEvents();
+    }
+
+    // A trigger that ended the game decides it for the player that tripped it
+    EPlayerColor TriggeredColor = TriggeredEnd ? EventHandler->EndGameColor() : EPlayerColor::None;
+    if((0 > to_underlying(TriggeredColor))||(to_underlying(EPlayerColor::Max) <= to_underlying(TriggeredColor))){
+        TriggeredColor = EPlayerColor::None;
+    }
+    int PlayersLeft = 0;
+    for(int Index = 1; Index < to_underlying(EPlayerColor::Max); Index++){
+        SPlayerResult &PlayerResult = Result.DPlayers[Index];
+
+        PlayerResult.DBrain = settings.DBrains[Index];
+        PlayerResult.DAlive = false;
+        PlayerResult.DGoldGathered = PlayerResult.DLumberGathered = PlayerResult.DStoneGathered = 0;
+        PlayerResult.DAssetsCreated = PlayerResult.DAssetsLost = PlayerResult.DAssetsDestroyed = 0;
+        if(!AIPlayers[Index]){
+            continue;
+        }
+        auto PlayerData = GameModel->Player(static_cast<EPlayerColor>(Index));
+
+        PlayerResult.DAlive = PlayerData->IsAlive();
+        PlayerResult.DGoldGathered = PlayerData->GoldGathered();
+        PlayerResult.DLumberGathered = PlayerData->LumberGathered();
+        PlayerResult.DStoneGathered = PlayerData->StoneGathered();
+        for(int TypeIndex = 0; TypeIndex < to_underlying(EAssetType::Max); TypeIndex++){
+            PlayerResult.DAssetsCreated += PlayerData->AssetsCreated()[TypeIndex];
+            PlayerResult.DAssetsLost += PlayerData->AssetsLost()[TypeIndex];
+            PlayerResult.DAssetsDestroyed += PlayerData->AssetsDestroyed()[TypeIndex];
+        }
+        if(PlayerResult.DAlive && (TriggeredWon || (TriggeredColor != static_cast<EPlayerColor>(Index)))){
+            PlayersLeft++;
+            Result.DWinner = static_cast<EPlayerColor>(Index);
+        }
+    }
+    if(1 != PlayersLeft){
+        Result.DWinner = EPlayerColor::None;
+    }
+    if((EPlayerColor::None != TriggeredColor)&&AIPlayers[to_underlying(TriggeredColor)]){
+        if(TriggeredWon){
+            Result.DWinner = TriggeredColor;
+        }
+        else{
+            Result.DLoser = TriggeredColor;
+        }
+    }
+    Result.DValid = true;
+    return Result;
+}
+
+/**
+* Runs all scheduled matches on the thread pool, each thread takes the next
+* unplayed match until none are left.
+*
+* @return Nothing
+*
+*/
+void CTournament::Run(){
+    std::atomic< int > NextMatch(0);
+    std::vector< std::thread > Threads;
+    int ThreadCount = std::min< int >(DThreadCount, DMatches.size());
+
+    DResults.clear();
+    DResults.resize(DMatches.size());
+    for(int Index = 0; Index < ThreadCount; Index++){
+        Threads.push_back(std::thread([this, &NextMatch](){
+            int MatchIndex;
+
+            while((MatchIndex = NextMatch++) < DMatches.size()){
+                DResults[MatchIndex] = RunMatch(DMatches[MatchIndex]);
+            }
+        }));
+    }
+    for(auto &Thread : Threads){
+        Thread.join();
+    }
+}
+
+/**
+* Aggregates the results of the played matches per brain
+*
+* @return Map of brain file to its statistics
+*
+*/
+std::map< std::string, CTournament::SBrainStatistics > CTournament::BrainStatistics() const{
+    std::map< std::string, SBrainStatistics > Statistics;
+
+    for(auto &Result : DResults){
+        if(!Result.DValid){
+            continue;
+        }
+        for(int Index = 1; Index < to_underlying(EPlayerColor::Max); Index++){
+            const SPlayerResult &PlayerResult = Result.DPlayers[Index];
+
+            if(PlayerResult.DBrain.empty()){
+                continue;
+            }
+            auto Search = Statistics.find(PlayerResult.DBrain);
+            if(Statistics.end() == Search){
+                Search = Statistics.insert(std::make_pair(PlayerResult.DBrain, SBrainStatistics{0, 0, 0, 0, 0, 0, 0, 0, 0, 0})).first;
+            }
+            SBrainStatistics &BrainStats = Search->second;
+
+            BrainStats.DMatches++;
+            if(static_cast<EPlayerColor>(Index) == Result.DWinner){
+                BrainStats.DWins++;
+            }
+            else if((EPlayerColor::None != Result.DWinner)||(static_cast<EPlayerColor>(Index) == Result.DLoser)){
+                BrainStats.DLosses++;
+            }
+            else{
+                BrainStats.DDraws++;
+            }
+            BrainStats.DGoldGathered += PlayerResult.DGoldGathered;
+            BrainStats.DLumberGathered += PlayerResult.DLumberGathered;
+            BrainStats.DStoneGathered += PlayerResult.DStoneGathered;
+            BrainStats.DAssetsCreated += PlayerResult.DAssetsCreated;
+            BrainStats.DAssetsLost += PlayerResult.DAssetsLost;
+            BrainStats.DAssetsDestroyed += PlayerResult.DAssetsDestroyed;
+        }
+    }
+    return Statistics;
+}
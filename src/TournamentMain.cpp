@@ -0,0 +1,132 @@
+/*
+    Copyright (c) 2015, Christopher Nitta
+    All rights reserved.
+
+    All source material (source code, images, sounds, etc.) have been provided to
+    University of California, Davis students of course ECS 160 for educational
+    purposes. It may not be distributed beyond those enrolled in the course without
+    prior permission from the copyright holder.
+
+    All sound files, sound fonts, midi files, and images that have been included
+    that were extracted from original Warcraft II by Blizzard Entertainment
+    were found freely available via internet sources and have been labeld as
+    abandonware. They have been included in this distribution for educational
+    purposes only and this copyright notice does not attempt to claim any
+    ownership of this material.
+*/
+
+/**
+ * @brief
+ *      TournamentMain.cpp , headless AI versus AI match runner
+ *
+ *      tournament -m map1,map2 -s seed1,seed2 -b brain1.lua,brain2.lua
+ *                 [-c maxcycles] [-j threads] [-d datadir]
+ *
+*/
+#include "Tournament.h"
+#include "ApplicationPath.h"
+#include "Tokenizer.h"
+#include "Debug.h"
+#include <cstdlib>
+#include <cstring>
+
+#ifndef DEBUG_LEVEL
+#define DEBUG_LEVEL DEBUG_LOW
+#endif
+
+#define DEFAULT_MAX_CYCLES      (20 * 60 * 20)
+
+/**
+ * Prints the command line usage
+ *
+ * @param[in] progname Name the program was run as
+ *
+ * @return Nothing
+*/
+static void PrintUsage(const char *progname){
+    fprintf(stderr, "Usage: %s -m maps -s seeds -b brains [-c maxcycles] [-j threads] [-d datadir]\n", progname);
+    fprintf(stderr, "    maps, seeds and brains are comma separated lists\n");
+}
+
+/**
+ * Main function of the tournament runner
+ *
+ * @param[in] argc Integer containing the number of command line arguments, indexed from 0
+ * @param[in] argv Character pointer containing the command line arguments, indexed by argc
+ *
+ * @return Exit code, 0 if all matches were played
+*/
+int main(int argc, char *argv[]){
+    std::vector< std::string > Maps, Brains;
+    std::vector< uint64_t > Seeds;
+    std::string DataPath = GetApplicationPath().Containing().ToString() + "/data";
+    int MaxCycles = DEFAULT_MAX_CYCLES;
+    int ThreadCount = 0;
+
+    OpenDebug("Tournament.out", DEBUG_LEVEL);
+
+    for(int Index = 1; Index < argc; Index++){
+        if(Index + 1 >= argc){
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        std::string Option = argv[Index];
+        std::string Value = argv[++Index];
+        std::vector< std::string > Tokens;
+
+        CTokenizer::Tokenize(Tokens, Value, ",");
+        if(Option == "-m"){
+            Maps.insert(Maps.end(), Tokens.begin(), Tokens.end());
+        }
+        else if(Option == "-s"){
+            for(auto &Token : Tokens){
+                Seeds.push_back(std::strtoull(Token.c_str(), nullptr, 0));
+            }
+        }
+        else if(Option == "-b"){
+            Brains.insert(Brains.end(), Tokens.begin(), Tokens.end());
+        }
+        else if(Option == "-c"){
+            MaxCycles = std::atoi(Value.c_str());
+        }
+        else if(Option == "-j"){
+            ThreadCount = std::atoi(Value.c_str());
+        }
+        else if(Option == "-d"){
+            DataPath = Value;
+        }
+        else{
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if(Maps.empty() || Brains.empty()){
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if(Seeds.empty()){
+        Seeds.push_back(0x123456789ABCDEFULL);
+    }
+
+    if(!CTournament::LoadGameData(DataPath)){
+        return EXIT_FAILURE;
+    }
+
+    CTournament Tournament(ThreadCount);
+
+    if(!Tournament.AddMatches(Maps, Seeds, Brains, MaxCycles)){
+        return EXIT_FAILURE;
+    }
+    Tournament.Run();
+
+    for(auto &Result : Tournament.Results()){
+        printf("%s seed %llu: %d cycles, winner %s\n", Result.DSettings.DMapName.c_str(), (unsigned long long)Result.DSettings.DSeed, Result.DCycles, EPlayerColor::None == Result.DWinner ? "draw" : Result.DPlayers[to_underlying(Result.DWinner)].DBrain.c_str());
+    }
+    printf("\n%-24s %7s %5s %6s %5s %8s %8s %8s %8s %8s %9s\n", "Brain", "Matches", "Wins", "Losses", "Draws", "Gold", "Lumber", "Stone", "Created", "Lost", "Destroyed");
+    for(auto &Entry : Tournament.BrainStatistics()){
+        auto &Stats = Entry.second;
+
+        printf("%-24s %7d %5d %6d %5d %8d %8d %8d %8d %8d %9d\n", Entry.first.c_str(), Stats.DMatches, Stats.DWins, Stats.DLosses, Stats.DDraws, Stats.DGoldGathered, Stats.DLumberGathered, Stats.DStoneGathered, Stats.DAssetsCreated, Stats.DAssetsLost, Stats.DAssetsDestroyed);
+    }
+    return EXIT_SUCCESS;
+}
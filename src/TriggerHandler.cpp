@@ -3,6 +3,7 @@
 #include "Debug.h"
 #include "Tokenizer.h"
 #include "GameDataTypes.h"
+#include <algorithm>
 
 extern "C" {
     #include "lua.h"
@@ -11,7 +12,6 @@ extern "C" {
 }
 
 std::vector< std::shared_ptr< CTriggerHandler > > CTriggerHandler::DAllTriggerHandlers;
-std::function< void(int, std::string, std::vector< std::string >, EPlayerColor color) > CTriggerHandler::DEventCall;
 
 #pragma region CTrigger Construct
 
@@ -30,6 +30,58 @@ void CTrigger::Construct (ETriggerType triggerType, int triggerablePlayers, bool
     DRepeatable = repeatable;
 }
 
+/**
+ * Resolves an asset type name of a trigger (a type, or a group such as All,
+ * Unit, Fighter, Building, TownCenter or Tower) into a mask of asset types
+ *
+ * @param[in] assetName The asset type name
+ *
+ * @return Mask with bit n set if EAssetType n matches the name
+ */
+uint32_t CTrigger::AssetTypeMask (const std::string &assetName){
+    uint32_t Mask = 0;
+
+    for (int i = 0; i < (int)EAssetType::Max; i++)
+        if (CTriggerHandler::AssetTypeMatchesName(assetName, static_cast<EAssetType>(i)))
+            Mask |= 1U << i;
+    return Mask;
+}
+
+/**
+ * Resolves the comparison token of a trigger
+ *
+ * @param[in] comparison The token, one of >, < or =
+ *
+ * @return The comparison, None if invalid
+ */
+EComparison CTrigger::ComparisonFromName (const std::string &comparison){
+    if (comparison == ">")
+        return EComparison::GreaterThan;
+    if (comparison == "<")
+        return EComparison::LessThan;
+    if (comparison == "=")
+        return EComparison::Equal;
+    PrintDebug(DEBUG_HIGH, "Invalid trigger comparison: %s\n", comparison.c_str());
+    return EComparison::None;
+}
+
+/**
+ * Sums the counts of the asset types in a mask
+ *
+ * @param[in] assettypemask Mask of asset types from AssetTypeMask
+ * @param[in] counts EAssetType::Max counts indexed by asset type
+ *
+ * @return The total count
+ */
+int CTrigger::CountAssets (uint32_t assettypemask, const int *counts){
+    int Count = 0;
+
+    for (int i = 0; assettypemask; i++, assettypemask >>= 1)
+        if (assettypemask & 1)
+            Count += counts[i];
+    return Count;
+}
+
 #pragma endregion
 
 #pragma region CTriggerResource Construct and Check
@@ -69,23 +121,14 @@ void CTriggerResource::Construct (ETriggerType triggerType, int triggerablePlaye
 /**
  * Checks a resource trigger to see if it has been tripped
  *
- * @param[in] size Number of arguments to check
- * @param[in] args Args passed. Should be {resourceType, amount}
+ * @param[in] args Args passed. Uses the resource type and amount
  *
  * @return True if trigger tripped, false elsewise
  */
-bool CTriggerResource::Check (int size, int* args){
+bool CTriggerResource::Check (const STriggerArgs &args){
     //printf("Resource Check\n");
-    if (size != 2){
-        printf("CTriggerResource::Check - %d is not the correct number of arguments. Should be 2.\n", size);
-        return false;
-    }
-    int resourceTypeInt = args[0];
-    int amount = args[1];
-
-    EResourceType resourceType = static_cast<EResourceType>(resourceTypeInt);
-    if (resourceType == DResourceType)
-        if ((DGreaterThan && amount > DAmount) || (!DGreaterThan && amount < DAmount))
+    if (args.DResourceType == DResourceType)
+        if ((DGreaterThan && args.DAmount > DAmount) || (!DGreaterThan && args.DAmount < DAmount))
             return true;
     return false;
 }
@@ -105,8 +148,8 @@ bool CTriggerResource::Check (int size, int* args){
  void CTriggerAssetCount::Construct (ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params){
     CTrigger::Construct(triggerType, triggerablePlayers, repeatable, params);
 
-    DAssetTypeName = params.at(0);
-    DComparison = params.at(1);
+    DAssetTypeMask = AssetTypeMask(params.at(0));
+    DComparison = ComparisonFromName(params.at(1));
     DAmount = stoi(params.at(2));
     DEvent = params.at(3);
 
@@ -117,20 +160,16 @@ bool CTriggerResource::Check (int size, int* args){
 /**
  * Checks an asset count trigger to see if it has been tripped
  *
- * @param[in] size Number of arguments to check
- * @param[in] args Args passed. Should be {assetType, amount}
+ * @param[in] args Args passed. Uses the counts by asset type
  *
  * @return True if trigger tripped, false elsewise
  */
-bool CTriggerAssetCount::Check (int size, int* args){
+bool CTriggerAssetCount::Check (const STriggerArgs &args){
     //printf("AssetCount Check\n");
 
-    int count = 0;
-    for (int i = 0; i < size; i++)
-        if (CTriggerHandler::AssetTypeMatchesName(DAssetTypeName, static_cast<EAssetType>(i)))
-            count += args[i];
+    int count = CountAssets(DAssetTypeMask, args.DAssetCounts);
     //printf("    count = %d\n", count);
-    if ((count > DAmount && DComparison == ">") || (count < DAmount && DComparison == "<") || (count == DAmount && DComparison == "="))
+    if (Compare(DComparison, count, DAmount))
         return true;
     return false;
 }
@@ -150,7 +189,7 @@ bool CTriggerAssetCount::Check (int size, int* args){
  void CTriggerAssetLocation::Construct (ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params){
     CTrigger::Construct(triggerType, triggerablePlayers, repeatable, params);
 
-    DAssetTypeName = params.at(0);
+    DAssetTypeMask = AssetTypeMask(params.at(0));
     DXMin = stoi(params.at(1));
     DXMax = stoi(params.at(2));
     DYMin = stoi(params.at(3));
@@ -164,18 +203,15 @@ bool CTriggerAssetCount::Check (int size, int* args){
 /**
  * Checks an asset location trigger to see if it has been tripped
  *
- * @param[in] size Number of arguments to check
- * @param[in] args Args passed. Should be {assetType, tileX, tileY}
+ * @param[in] args Args passed. Uses the asset type and tile position
  *
  * @return True if trigger tripped, false elsewise
  */
-bool CTriggerAssetLocation::Check (int size, int* args){
+bool CTriggerAssetLocation::Check (const STriggerArgs &args){
     //printf("AssetCount Check\n");
-    if (size != 3)
-        return false;
-    if (!CTriggerHandler::AssetTypeMatchesName(DAssetTypeName, static_cast<EAssetType>(args[0])))
+    if (!(DAssetTypeMask & (1U << (int)args.DAssetType)))
         return false;
-    if (args[1] < DXMin || args[1] > DXMax || args[2] < DYMin || args[2] > DYMax)
+    if (args.DTileX < DXMin || args.DTileX > DXMax || args.DTileY < DYMin || args.DTileY > DYMax)
         return false;
     return true;
 }
@@ -208,17 +244,14 @@ bool CTriggerAssetLocation::Check (int size, int* args){
 /**
  * Checks a time trigger to see if it has been tripped
  *
- * @param[in] size Number of arguments to check
- * @param[in] args Args passed. Should be {time}
+ * @param[in] args Args passed. Uses the time in milliseconds
  *
  * @return True if trigger tripped, false elsewise
  */
-bool CTriggerTime::Check (int size, int* args){
+bool CTriggerTime::Check (const STriggerArgs &args){
     //printf("AssetCount Check\n");
 
-    if (size != 1)
-        return false;
-    float time = (float)args[0] / 1000.0;
+    float time = (float)args.DTime / 1000.0;
     if ((DGreaterThan && time > DTime) || (!DGreaterThan && time < DTime))
         return true;
     return false;
@@ -243,8 +276,8 @@ void CTriggerTime::IncrementTime (){
  void CTriggerAssetsCreated::Construct (ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params){
     CTrigger::Construct(triggerType, triggerablePlayers, repeatable, params);
 
-    DAssetTypeName = params.at(0);
-    DComparison = params.at(1);
+    DAssetTypeMask = AssetTypeMask(params.at(0));
+    DComparison = ComparisonFromName(params.at(1));
     DAmount = stoi(params.at(2));
     DEvent = params.at(3);
 
@@ -255,20 +288,16 @@ void CTriggerTime::IncrementTime (){
 /**
  * Checks an assets created trigger to see if it has been tripped
  *
- * @param[in] size Number of arguments to check
- * @param[in] args Args passed. Should be {assetType, amount}
+ * @param[in] args Args passed. Uses the counts by asset type
  *
  * @return True if trigger tripped, false elsewise
  */
-bool CTriggerAssetsCreated::Check (int size, int* args){
+bool CTriggerAssetsCreated::Check (const STriggerArgs &args){
     //printf("AssetCount Check\n");
 
-    int count = 0;
-    for (int i = 0; i < size; i++)
-        if (CTriggerHandler::AssetTypeMatchesName(DAssetTypeName, static_cast<EAssetType>(i)))
-            count += args[i];
+    int count = CountAssets(DAssetTypeMask, args.DAssetCounts);
     //printf("    count = %d\n", count);
-    if ((count > DAmount && DComparison == ">") || (count < DAmount && DComparison == "<") || (count == DAmount && DComparison == "="))
+    if (Compare(DComparison, count, DAmount))
         return true;
     return false;
 }
@@ -288,8 +317,8 @@ bool CTriggerAssetsCreated::Check (int size, int* args){
  void CTriggerAssetsLost::Construct (ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params){
     CTrigger::Construct(triggerType, triggerablePlayers, repeatable, params);
 
-    DAssetTypeName = params.at(0);
-    DComparison = params.at(1);
+    DAssetTypeMask = AssetTypeMask(params.at(0));
+    DComparison = ComparisonFromName(params.at(1));
     DAmount = stoi(params.at(2));
     DEvent = params.at(3);
 
@@ -300,20 +329,16 @@ bool CTriggerAssetsCreated::Check (int size, int* args){
 /**
  * Checks an assets lost trigger to see if it has been tripped
  *
- * @param[in] size Number of arguments to check
- * @param[in] args Args passed. Should be {assetType, amount}
+ * @param[in] args Args passed. Uses the counts by asset type
  *
  * @return True if trigger tripped, false elsewise
  */
-bool CTriggerAssetsLost::Check (int size, int* args){
+bool CTriggerAssetsLost::Check (const STriggerArgs &args){
     //printf("AssetCount Check\n");
 
-    int count = 0;
-    for (int i = 0; i < size; i++)
-        if (CTriggerHandler::AssetTypeMatchesName(DAssetTypeName, static_cast<EAssetType>(i)))
-            count += args[i];
+    int count = CountAssets(DAssetTypeMask, args.DAssetCounts);
     //printf("    count = %d\n", count);
-    if ((count > DAmount && DComparison == ">") || (count < DAmount && DComparison == "<") || (count == DAmount && DComparison == "="))
+    if (Compare(DComparison, count, DAmount))
         return true;
     return false;
 }
@@ -333,8 +358,8 @@ bool CTriggerAssetsLost::Check (int size, int* args){
  void CTriggerAssetsDestroyed::Construct (ETriggerType triggerType, int triggerablePlayers, bool repeatable, std::vector< std::string > params){
     CTrigger::Construct(triggerType, triggerablePlayers, repeatable, params);
 
-    DAssetTypeName = params.at(0);
-    DComparison = params.at(1);
+    DAssetTypeMask = AssetTypeMask(params.at(0));
+    DComparison = ComparisonFromName(params.at(1));
     DAmount = stoi(params.at(2));
     DEvent = params.at(3);
 
@@ -345,20 +370,16 @@ bool CTriggerAssetsLost::Check (int size, int* args){
 /**
  * Checks an assets destroyed trigger to see if it has been tripped
  *
- * @param[in] size Number of arguments to check
- * @param[in] args Args passed. Should be {assetType, amount}
+ * @param[in] args Args passed. Uses the counts by asset type
  *
  * @return True if trigger tripped, false elsewise
  */
-bool CTriggerAssetsDestroyed::Check (int size, int* args){
+bool CTriggerAssetsDestroyed::Check (const STriggerArgs &args){
     //printf("AssetCount Check\n");
 
-    int count = 0;
-    for (int i = 0; i < size; i++)
-        if (CTriggerHandler::AssetTypeMatchesName(DAssetTypeName, static_cast<EAssetType>(i)))
-            count += args[i];
+    int count = CountAssets(DAssetTypeMask, args.DAssetCounts);
     //printf("    count = %d\n", count);
-    if ((count > DAmount && DComparison == ">") || (count < DAmount && DComparison == "<") || (count == DAmount && DComparison == "=")){
+    if (Compare(DComparison, count, DAmount)){
         return true;
     }
     return false;
@@ -368,74 +389,178 @@ bool CTriggerAssetsDestroyed::Check (int size, int* args){
 
 #pragma region CTriggerHandler Constructors/Deconstructor
 
-CTriggerHandler::CTriggerHandler () {}
+CTriggerHandler::CTriggerHandler () : DResolveDepth(0), DTriggerIndexDirty(false) {}
 
-CTriggerHandler::CTriggerHandler(const CTriggerHandler &handler){
+/**
+ * Copies a handler. The triggers are cloned so that each game has its own
+ * trigger state, the event call is left for the new owner to set.
+ *
+ * @param[in] handler The handler to copy
+ */
+CTriggerHandler::CTriggerHandler(const CTriggerHandler &handler) : DResolveDepth(0), DTriggerIndexDirty(false){
     DAIDifficultyScripts = handler.DAIDifficultyScripts;
     DEventScript = handler.DEventScript;
-    DTriggers = handler.DTriggers;
-    DTimeTriggers = handler.DTimeTriggers;
+    for (auto &Trigger : handler.DTriggers)
+        DTriggers.push_back(Trigger->Clone());
+    for (auto &TimeTrigger : handler.DTimeTriggers)
+        DTimeTriggers.push_back(std::make_shared< CTriggerTime >(*TimeTrigger));
     DHandlerIndex = handler.DHandlerIndex;
+    IndexTriggers();
+    ScheduleTimeTriggers();
 }
 
 CTriggerHandler::~CTriggerHandler () {}
 
 #pragma endregion
 
+#pragma region CTriggerHandler Trigger Index
+
+/**
+ * Rebuilds the index of active triggers by type and by who activates them
+ */
+void CTriggerHandler::IndexTriggers (){
+    for (auto &TypeBuckets : DTriggerIndex){
+        TypeBuckets[0].clear();
+        TypeBuckets[1].clear();
+    }
+    for (auto &Trigger : DTriggers){
+        if (!Trigger->DActive || (to_underlying(Trigger->DType) >= to_underlying(ETriggerType::Max)))
+            continue;
+        if (Trigger->DPlayerActivated)
+            DTriggerIndex[to_underlying(Trigger->DType)][0].push_back(Trigger);
+        if (Trigger->DAIActivated)
+            DTriggerIndex[to_underlying(Trigger->DType)][1].push_back(Trigger);
+    }
+    DTriggerIndexDirty = false;
+}
+
+/**
+ * Drops triggers that are no longer active from the index. Only done once
+ * the outermost Resolve returns, as events may resolve triggers in turn.
+ */
+void CTriggerHandler::CompactTriggerIndex (){
+    for (auto &TypeBuckets : DTriggerIndex){
+        for (auto &Bucket : TypeBuckets){
+            Bucket.erase(std::remove_if(Bucket.begin(), Bucket.end(), [](const std::shared_ptr< CTrigger > &trigger){ return !trigger->DActive; }), Bucket.end());
+        }
+    }
+    DTriggerIndexDirty = false;
+}
+
+/**
+ * Orders time triggers by when they fire next
+ */
+static bool TimeTriggerFiresLater (const std::shared_ptr< CTriggerTime > &first, const std::shared_ptr< CTriggerTime > &second){
+    return first->GetTime() > second->GetTime();
+}
+
+/**
+ * Rebuilds the schedule of the active time triggers
+ */
+void CTriggerHandler::ScheduleTimeTriggers (){
+    DTimeTriggerHeap.clear();
+    DEarlyTimeTriggers.clear();
+    for (auto &TimeTrigger : DTimeTriggers){
+        if (!TimeTrigger->DActive)
+            continue;
+        if (TimeTrigger->GreaterThan())
+            DTimeTriggerHeap.push_back(TimeTrigger);
+        else
+            DEarlyTimeTriggers.push_back(TimeTrigger);
+    }
+    std::make_heap(DTimeTriggerHeap.begin(), DTimeTriggerHeap.end(), TimeTriggerFiresLater);
+}
+
+/**
+ * Resolves the time triggers that are due. A > trigger is due once the time
+ * passes its next fire time, so only the top of the heap is looked at when
+ * none are due. Each trigger fires at most once per call, repeatable ones
+ * are rescheduled by their interval.
+ *
+ * @param[in] color The color passed to the events
+ * @param[in] offenderID The offender passed to the events
+ * @param[in] args Arguments holding the current time
+ */
+void CTriggerHandler::ResolveTime (EPlayerColor color, int offenderID, const STriggerArgs &args){
+    DDueTimeTriggers.clear();
+    while (!DTimeTriggerHeap.empty() && DTimeTriggerHeap.front()->Check(args)){
+        std::pop_heap(DTimeTriggerHeap.begin(), DTimeTriggerHeap.end(), TimeTriggerFiresLater);
+        DDueTimeTriggers.push_back(DTimeTriggerHeap.back());
+        DTimeTriggerHeap.pop_back();
+    }
+    for (auto &TimeTrigger : DEarlyTimeTriggers){
+        if (TimeTrigger->DActive && TimeTrigger->Check(args))
+            DDueTimeTriggers.push_back(TimeTrigger);
+    }
+    if (DDueTimeTriggers.empty())
+        return;
+
+    // Swapped out as events may resolve time triggers in turn
+    std::vector< std::shared_ptr< CTriggerTime > > DueTimeTriggers;
+    DueTimeTriggers.swap(DDueTimeTriggers);
+    bool EarlyTriggerDone = false;
+    for (auto &TimeTrigger : DueTimeTriggers){
+        if (DEventCall)
+            DEventCall(offenderID, TimeTrigger->DEvent, TimeTrigger->DEventParameters, color);
+
+        if (!TimeTrigger->DRepeatable){
+            TimeTrigger->DActive = false;
+            EarlyTriggerDone |= !TimeTrigger->GreaterThan();
+        }
+        else{
+            TimeTrigger->IncrementTime();
+            if (TimeTrigger->GreaterThan()){
+                DTimeTriggerHeap.push_back(TimeTrigger);
+                std::push_heap(DTimeTriggerHeap.begin(), DTimeTriggerHeap.end(), TimeTriggerFiresLater);
+            }
+        }
+    }
+    if (EarlyTriggerDone)
+        DEarlyTimeTriggers.erase(std::remove_if(DEarlyTimeTriggers.begin(), DEarlyTimeTriggers.end(), [](const std::shared_ptr< CTriggerTime > &trigger){ return !trigger->DActive; }), DEarlyTimeTriggers.end());
+    DueTimeTriggers.clear();
+    DDueTimeTriggers.swap(DueTimeTriggers);
+}
+
+#pragma endregion
+
 #pragma region CTriggerHandler Resolve
 
 /**
- * Iterates over trigger vectors and resolves any events of tripped triggers
+ * Resolves the events of tripped triggers. Only the active triggers of the
+ * given type that can be activated by the caller are checked.
  *
  * @param[in] triggerType The type of trigger to check
  * @param[in] isAI Whether the caller is an AI or not
- * @param[in] size Number of arguments given
- * @param[in] args Arguments passed
+ * @param[in] args Arguments the triggers are checked against
  */
-void CTriggerHandler::Resolve (ETriggerType triggerType, bool isAI, EPlayerColor color, int offenderID, int size, int* args){
+void CTriggerHandler::Resolve (ETriggerType triggerType, bool isAI, EPlayerColor color, int offenderID, const STriggerArgs &args){
     if (triggerType == ETriggerType::Time){
-        for (int i = 0; i < DTimeTriggers.size(); i++){
-            if (DTimeTriggers[i]->Check(size, args) && DTimeTriggers[i]->DActive){
-                DEventCall(offenderID, DTimeTriggers[i]->DEvent, DTimeTriggers[i]->DEventParameters, color);
-
-                if (!DTimeTriggers[i]->DRepeatable){
-                    DTimeTriggers[i]->DActive = false;
-                }
-                else{
-                    DTimeTriggers[i]->IncrementTime();
-                }
-            }
-        }
+        ResolveTime(color, offenderID, args);
         return;
     }
 
-    for (int i = 0; i < DTriggers.size(); i++){
-        //printf("Triggers[%d] type: %d\n", i, (int)DTriggers[i]->DType);
-        if (DTriggers[i]->DType == triggerType && DTriggers[i]->DActive){
-            //printf("At AI Check %d\n", isAI);
-            if ((isAI && DTriggers[i]->DAIActivated) || (!isAI && DTriggers[i]->DPlayerActivated)){
-                //printf("Triggers[%d] Type = %d, compared to %d\n", i, (int)DTriggers[i]->DType, (int)triggerType);
-                if (DTriggers[i]->Check(size, args)){
-                    
-                    /*
-                    printf("Trigger[%d] matched - type = %d - isAI = %d - size = %d\n", i, (int)triggerType, (int)isAI, size);
-                    for (int j = 0; j < size; j++)
-                        printf("%d ", args[j]);
-                    printf("\n");
-                    printf("    %s\n    ", DEventScript.c_str());
-                    for (int j = 0; j < DTriggers[i]->DEventParameters.size(); j++)
-                        printf("(%s)", DTriggers[i]->DEventParameters[j].c_str());
-                    printf("\n");
-                    */
-
-                    DEventCall(offenderID, DTriggers[i]->DEvent, DTriggers[i]->DEventParameters, color);
-                    if (!DTriggers[i]->DRepeatable){
-                        DTriggers[i]->DActive = false;
-                    }
-                }
+    if (to_underlying(triggerType) >= to_underlying(ETriggerType::Max))
+        return;
+
+    std::vector< std::shared_ptr< CTrigger > > &Candidates = DTriggerIndex[to_underlying(triggerType)][isAI ? 1 : 0];
+
+    DResolveDepth++;
+    // Inactive triggers are only dropped once the outermost Resolve returns
+    for (int i = 0; i < Candidates.size(); i++){
+        std::shared_ptr< CTrigger > Trigger = Candidates[i];
+
+        if (Trigger->DActive && Trigger->Check(args)){
+            if (DEventCall)
+                DEventCall(offenderID, Trigger->DEvent, Trigger->DEventParameters, color);
+            if (!Trigger->DRepeatable){
+                Trigger->DActive = false;
+                DTriggerIndexDirty = true;
             }
         }
     }
+    DResolveDepth--;
+    if (!DResolveDepth && DTriggerIndexDirty)
+        CompactTriggerIndex();
 }
 
 #pragma endregion
@@ -484,6 +609,53 @@ bool CTriggerHandler::AssetTypeMatchesName(std::string assetName, EAssetType ass
 
 #pragma region CTriggerHandler Load and Duplicate
 
+/**
+ * Constructs a trigger from its definition and adds it to the handler
+ *
+ * @param[in] definition The trigger as written in the map
+ *
+ * @return true if the trigger type is valid
+ */
+bool CTriggerHandler::AddTrigger (const STriggerDefinition &definition){
+    std::shared_ptr< CTrigger > tempTrigger;
+
+    switch (definition.DType){
+        case ETriggerType::Resource:
+            tempTrigger = std::make_shared< CTriggerResource >();
+            break;
+        case ETriggerType::AssetCount:
+            tempTrigger = std::make_shared< CTriggerAssetCount >();
+            break;
+        case ETriggerType::AssetLocation:
+            tempTrigger = std::make_shared< CTriggerAssetLocation >();
+            break;
+        case ETriggerType::Time:
+            {
+                std::shared_ptr< CTriggerTime > tempTimeTrigger = std::make_shared< CTriggerTime >();
+                tempTimeTrigger->Construct(definition.DType, definition.DTriggerablePlayers, definition.DRepeatable, definition.DParameters);
+                DTimeTriggers.push_back(tempTimeTrigger);
+                DDefinitions.push_back(definition);
+            }
+            return true;
+        case ETriggerType::AssetsCreated:
+            tempTrigger = std::make_shared< CTriggerAssetsCreated >();
+            break;
+        case ETriggerType::AssetsLost:
+            tempTrigger = std::make_shared< CTriggerAssetsLost >();
+            break;
+        case ETriggerType::AssetsDestroyed:
+            tempTrigger = std::make_shared< CTriggerAssetsDestroyed >();
+            break;
+        default:
+            PrintDebug(DEBUG_HIGH, "Trigger type invalid\n");
+            return false;
+    }
+    tempTrigger->Construct(definition.DType, definition.DTriggerablePlayers, definition.DRepeatable, definition.DParameters);
+    DTriggers.push_back(tempTrigger);
+    DDefinitions.push_back(definition);
+    return true;
+}
+
 /**
  * Loads in all the triggers for a .map file
  *
@@ -497,7 +669,6 @@ bool CTriggerHandler::LoadTriggers (std::shared_ptr< CDataSource > source){
     std::vector< std::string > tokens;
     int triggerCount;
     std::shared_ptr< CTriggerHandler > tempHandler = std::make_shared< CTriggerHandler >();
-    std::shared_ptr< CTrigger > tempTrigger;
 
     // read in AI difficulties
     for(int i = 0; i < 3; i++) {
@@ -525,75 +696,99 @@ bool CTriggerHandler::LoadTriggers (std::shared_ptr< CDataSource > source){
             return false;
         }
         CTokenizer::Tokenize(tokens, tempString);
-        ETriggerType triggerType = static_cast< ETriggerType > (stoi(tokens.at(0)));
-        int triggerablePlayers = stoi(tokens.at(1));
-        int repeatable = stoi(tokens.at(2));
+        STriggerDefinition definition;
+        definition.DType = static_cast< ETriggerType > (stoi(tokens.at(0)));
+        definition.DTriggerablePlayers = stoi(tokens.at(1));
+        definition.DRepeatable = stoi(tokens.at(2));
         tokens.erase(tokens.begin(), tokens.begin() + 3);
+        definition.DParameters = tokens;
 
-        //printf("Loading trigger type %d\n", (int)triggerType);
-
-        switch (triggerType){
-            case ETriggerType::Resource:
-                {
-                    tempTrigger = std::make_shared< CTriggerResource >();
-                    tempTrigger->Construct(triggerType, triggerablePlayers, repeatable, tokens);
-                    tempHandler->DTriggers.push_back(tempTrigger);
-                }
-                break;
-            case ETriggerType::AssetCount:
-                {
-                    tempTrigger = std::make_shared< CTriggerAssetCount >();
-                    tempTrigger->Construct(triggerType, triggerablePlayers, repeatable, tokens);
-                    tempHandler->DTriggers.push_back(tempTrigger);
-                }
-                break;
-            case ETriggerType::AssetLocation:
-                {
-                    tempTrigger = std::make_shared< CTriggerAssetLocation >();
-                    tempTrigger->Construct(triggerType, triggerablePlayers, repeatable, tokens);
-                    tempHandler->DTriggers.push_back(tempTrigger);
-                }
-                break;
-            case ETriggerType::Time:
-                {
-                    std::shared_ptr< CTriggerTime > tempTimeTrigger = std::make_shared< CTriggerTime >();
-                    tempTimeTrigger->Construct(triggerType, triggerablePlayers, repeatable, tokens);
-                    tempHandler->DTimeTriggers.push_back(tempTimeTrigger);
-                }
-                break;
-            case ETriggerType::AssetsCreated:
-                {
-                    tempTrigger = std::make_shared< CTriggerAssetsCreated >();
-                    tempTrigger->Construct(triggerType, triggerablePlayers, repeatable, tokens);
-                    tempHandler->DTriggers.push_back(tempTrigger);
-                }
-                break;
-            case ETriggerType::AssetsLost:
-                {
-                    tempTrigger = std::make_shared< CTriggerAssetsLost >();
-                    tempTrigger->Construct(triggerType, triggerablePlayers, repeatable, tokens);
-                    tempHandler->DTriggers.push_back(tempTrigger);
-                }
-                break;
-            case ETriggerType::AssetsDestroyed:
-                {
-                    tempTrigger = std::make_shared< CTriggerAssetsDestroyed >();
-                    tempTrigger->Construct(triggerType, triggerablePlayers, repeatable, tokens);
-                    tempHandler->DTriggers.push_back(tempTrigger);
-                }
-                break;
-            default:
-                PrintDebug(DEBUG_HIGH, "Trigger type invalid\n");
-                break;
-        }
+        //printf("Loading trigger type %d\n", (int)definition.DType);
+
+        tempHandler->AddTrigger(definition);
     }
     //printf("\n");
 
+    tempHandler->IndexTriggers();
+    tempHandler->ScheduleTimeTriggers();
     tempHandler->DHandlerIndex = DAllTriggerHandlers.size();
     DAllTriggerHandlers.push_back(tempHandler);
     return true;
 }
 
+/**
+ * Loads in all the triggers of a compiled map bundle
+ *
+ * @param[in] reader Reader positioned at the triggers of the bundle
+ *
+ * @return true if all triggers were read and are valid
+ */
+bool CTriggerHandler::LoadTriggers (CMapBundleReader &reader){
+    std::shared_ptr< CTriggerHandler > tempHandler = std::make_shared< CTriggerHandler >();
+    std::string tempString;
+    int triggerCount;
+
+    for (int i = 0; i < 3; i++){
+        if (!reader.ReadString(tempString))
+            return false;
+        tempHandler->DAIDifficultyScripts.push_back(tempString);
+    }
+    if (!reader.ReadString(tempHandler->DEventScript) || !reader.ReadInt(triggerCount) || (0 > triggerCount))
+        return false;
+
+    for (int i = 0; i < triggerCount; i++){
+        STriggerDefinition definition;
+        int type, repeatable, parameterCount;
+
+        if (!reader.ReadInt(type) || !reader.ReadInt(definition.DTriggerablePlayers) || !reader.ReadInt(repeatable) || !reader.ReadInt(parameterCount))
+            return false;
+        definition.DType = static_cast< ETriggerType >(type);
+        definition.DRepeatable = repeatable;
+        for (int j = 0; j < parameterCount; j++){
+            if (!reader.ReadString(tempString))
+                return false;
+            definition.DParameters.push_back(tempString);
+        }
+        if (!tempHandler->AddTrigger(definition))
+            return false;
+    }
+
+    tempHandler->IndexTriggers();
+    tempHandler->ScheduleTimeTriggers();
+    tempHandler->DHandlerIndex = DAllTriggerHandlers.size();
+    DAllTriggerHandlers.push_back(tempHandler);
+    return true;
+}
+
+/**
+ * Writes the triggers of a loaded map to a map bundle
+ *
+ * @param[in] index The index of the trigger handler of the map
+ * @param[in] writer The bundle being built
+ *
+ * @return true if the handler exists
+ */
+bool CTriggerHandler::SaveTriggers (int index, CMapBundleWriter &writer){
+    if (index < 0 || index >= DAllTriggerHandlers.size())
+        return false;
+
+    std::shared_ptr< CTriggerHandler > handler = DAllTriggerHandlers[index];
+
+    for (int i = 0; i < 3; i++)
+        writer.WriteString(i < handler->DAIDifficultyScripts.size() ? handler->DAIDifficultyScripts[i] : std::string());
+    writer.WriteString(handler->DEventScript);
+    writer.WriteInt(handler->DDefinitions.size());
+    for (auto &definition : handler->DDefinitions){
+        writer.WriteInt(to_underlying(definition.DType));
+        writer.WriteInt(definition.DTriggerablePlayers);
+        writer.WriteInt(definition.DRepeatable);
+        writer.WriteInt(definition.DParameters.size());
+        for (auto &parameter : definition.DParameters)
+            writer.WriteString(parameter);
+    }
+    return true;
+}
+
 /**
  * Duplicates a handler for a given map index
  *
@@ -618,6 +813,8 @@ void CTriggerHandler::ActivateTriggers (){
         DTimeTriggers[i]->DActive = true;
         DTimeTriggers[i]->SetTime(DTimeTriggers[i]->GetInitialTime());
     }
+    IndexTriggers();
+    ScheduleTimeTriggers();
 }
 
 #pragma endregion
\ No newline at end of file
@@ -123,6 +123,22 @@ void CViewportRenderer::PanWest(int pan){
     }
 }
 
+/**
+ * @brief Finds what is displayed at a position of the viewport
+ * Assets drawn by the last DrawViewport are tested first, then the terrain
+ * @param pos position in the viewport
+ * @return pixel type at the position
+ */
+CPixelType CViewportRenderer::PixelType(const CPixelPosition &pos) const{
+    CPixelPosition DetailedPos = DetailedPosition(pos);
+    CPixelType ReturnType(CTerrainMap::ETileType::None);
+    
+    if(DAssetRenderer->PixelType(DetailedPos.X(), DetailedPos.Y(), ReturnType)){
+        return ReturnType;
+    }
+    return DMapRenderer->PixelType(DetailedPos.X(), DetailedPos.Y());
+}
+
 /**
  * @brief Used in BattleModes Render() function
  * Checks that placement is within bounds of viewport
@@ -130,12 +146,11 @@ void CViewportRenderer::PanWest(int pan){
  * from AssetRender.cpp
  * 
  * @param surface pointer used in Draw functions
- * @param typesurface pointer used in Draw functions
  * @param selectionmarkerlist list of
  * @param selectrect the desired position to place an asset
  * @param curcapability the assets that can be created based on gold, wood, etc
  */
-void CViewportRenderer::DrawViewport(std::shared_ptr< CGraphicSurface > surface, std::shared_ptr< CGraphicSurface > typesurface, const std::list< std::weak_ptr< CPlayerAsset > > &selectionmarkerlist, const SRectangle &selectrect, EAssetCapabilityType curcapability){
+void CViewportRenderer::DrawViewport(std::shared_ptr< CGraphicSurface > surface, const std::list< std::weak_ptr< CPlayerAsset > > &selectionmarkerlist, const SRectangle &selectrect, EAssetCapabilityType curcapability){
     
     SRectangle TempRectangle;
     EAssetType PlaceType = EAssetType::None;
@@ -173,9 +188,9 @@ void CViewportRenderer::DrawViewport(std::shared_ptr< CGraphicSurface > surface,
                                                         break;                                                
         default:                                        break;
     }
-    DMapRenderer->DrawMap(surface, typesurface, TempRectangle);
+    DMapRenderer->DrawMap(surface, TempRectangle);
     DAssetRenderer->DrawSelections(surface, TempRectangle, selectionmarkerlist, selectrect, EAssetType::None != PlaceType);
-    DAssetRenderer->DrawAssets(surface, typesurface, TempRectangle);
+    DAssetRenderer->DrawAssets(surface, TempRectangle);
     DAssetRenderer->DrawOverlays(surface, TempRectangle);
     
     if(selectionmarkerlist.size()){
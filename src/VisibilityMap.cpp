@@ -53,6 +53,12 @@ CVisibilityMap::CVisibilityMap(int width, int height, int maxvisibility){
             Cell = ETileVisibility::None;   
         }
     }
+    DLastMap = DMap;
+    DChangedFlags.resize(DMap.size());
+    for(int Index = 0; Index < DMap.size(); Index++){
+        DChangedFlags[Index].assign(DMap[Index].size(), false);
+    }
+    DAllTilesChanged = true;
     DTotalMapTiles = width * height;
     DUnseenTiles = DTotalMapTiles; 
 }
@@ -69,6 +75,12 @@ CVisibilityMap::CVisibilityMap(int width, int height, int maxvisibility){
 CVisibilityMap::CVisibilityMap(const CVisibilityMap &map){
     DMaxVisibility = map.DMaxVisibility;
     DMap = map.DMap;
+    DLastMap = map.DMap;
+    DChangedFlags.resize(DMap.size());
+    for(int Index = 0; Index < DMap.size(); Index++){
+        DChangedFlags[Index].assign(DMap[Index].size(), false);
+    }
+    DAllTilesChanged = true;
     DTotalMapTiles = map.DTotalMapTiles;
     DUnseenTiles = map.DUnseenTiles;
 }
@@ -99,6 +111,13 @@ CVisibilityMap &CVisibilityMap::operator=(const CVisibilityMap &map){
     if(this != &map){
         DMaxVisibility = map.DMaxVisibility;
         DMap = map.DMap;   
+        DLastMap = map.DMap;
+        DChangedFlags.resize(DMap.size());
+        for(int Index = 0; Index < DMap.size(); Index++){
+            DChangedFlags[Index].assign(DMap[Index].size(), false);
+        }
+        DChangedTiles.clear();
+        DAllTilesChanged = true;
         DTotalMapTiles = map.DTotalMapTiles;
         DUnseenTiles = map.DUnseenTiles;
     }
@@ -238,6 +257,51 @@ void CVisibilityMap::Update(const std::list< std::weak_ptr< CPlayerAsset > > &as
             }
         }
     }
+    // Record the tiles whose visibility differs from the last update. Nothing
+    // is recorded until the whole map change has been taken, so maps whose
+    // fog is never drawn (AI players) skip this, the last map is resynced
+    // when the tiles are taken
+    if(DAllTilesChanged){
+        return;
+    }
+    for(int Y = 0; Y < DMap.size(); Y++){
+        for(int X = 0; X < DMap[Y].size(); X++){
+            if(DMap[Y][X] != DLastMap[Y][X]){
+                DLastMap[Y][X] = DMap[Y][X];
+                if(!DChangedFlags[Y][X]){
+                    DChangedFlags[Y][X] = true;
+                    DChangedTiles.push_back(CTilePosition(X - DMaxVisibility, Y - DMaxVisibility));
+                }
+            }
+        }
+    }
+}
+
+/**
+* Hands the tiles whose visibility changed since the last call to the
+* caller (the fog renderer), so it only has to update those tiles. The
+* positions may lie in the border outside of the map.
+*
+* @param[out] tiles Positions of the changed tiles
+*
+* @return true if the whole map changed and tiles should be ignored
+*
+*/
+
+bool CVisibilityMap::TakeChangedTiles(std::vector< CTilePosition > &tiles){
+    bool AllChanged = DAllTilesChanged;
     
+    tiles.clear();
+    if(AllChanged){
+        DLastMap = DMap;
+    }
+    else{
+        tiles.swap(DChangedTiles);
+        for(auto &Tile : tiles){
+            DChangedFlags[Tile.Y() + DMaxVisibility][Tile.X() + DMaxVisibility] = false;
+        }
+    }
+    DAllTilesChanged = false;
+    return AllChanged;
 }
 
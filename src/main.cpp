@@ -29,14 +29,18 @@
  *
 */
 #include "ApplicationData.h"
+#include "GraphicFactory.h"
 #include "Debug.h"
+#include <cstring>
 
 #ifndef DEBUG_LEVEL
 #define DEBUG_LEVEL DEBUG_HIGH
 #endif
 
 /**
- * Main function where execution of the game will begin
+ * Main function where execution of the game will begin. The software
+ * renderer is selected with --software-renderer, which is removed from the
+ * arguments before they are passed on to GTK.
  *
  * @param[in] argc Integer containing the number of command line arguments, indexed from 0
  * @param[in] argv Character pointer containing the command line arguments, indexed by argc
@@ -46,9 +50,19 @@
 int main(int argc, char *argv[]){
     std::shared_ptr< CApplicationData > AppInstance;
     int ReturnValue;    
+    int ArgumentCount = 1;
     
     OpenDebug("Debug.out", DEBUG_LEVEL);
     
+    for(int Index = 1; Index < argc; Index++){
+        if(!strcmp(argv[Index], "--software-renderer")){
+            CGraphicFactory::Backend(CGraphicFactory::EBackend::Software);
+            continue;
+        }
+        argv[ArgumentCount++] = argv[Index];
+    }
+    argc = ArgumentCount;
+    
     AppInstance = CApplicationData::Instance("edu.ucdavis.cs.ecs160.game");
     
     ReturnValue = AppInstance->Run(argc, argv);